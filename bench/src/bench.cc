@@ -0,0 +1,261 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file bench/src/bench.cc
+/// @author Issam SAID
+/// @brief Implement the helpers shared by the urb_tree benchmarks.
+///
+#include <unistd.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <cmath>
+#include <cstdio>
+#include <chrono>
+#include <algorithm>
+#include "bench.h"
+
+namespace urb_bench {
+
+    const char *dist_name(dist_t dist) {
+        switch (dist) {
+            case SEQUENTIAL:  return "sequential";
+            case RANDOM:      return "random";
+            case ZIPFIAN:     return "zipfian";
+            case ADVERSARIAL: return "adversarial";
+        }
+        return "unknown";
+    }
+
+    static int perf_open(uint64_t config) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.type           = PERF_TYPE_HARDWARE;
+        attr.size           = sizeof(attr);
+        attr.config         = config;
+        attr.disabled       = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        return (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+
+    counters_t::counters_t() 
+        : cache_fd_(perf_open(PERF_COUNT_HW_CACHE_MISSES)),
+          branch_fd_(perf_open(PERF_COUNT_HW_BRANCH_MISSES)) {}
+
+    counters_t::~counters_t() {
+        if (cache_fd_  >= 0) close(cache_fd_);
+        if (branch_fd_ >= 0) close(branch_fd_);
+    }
+
+    void counters_t::start() {
+        int fds[2] = { cache_fd_, branch_fd_ };
+        for (int i = 0; i < 2; ++i) {
+            if (fds[i] < 0) continue;
+            ioctl(fds[i], PERF_EVENT_IOC_RESET,  0);
+            ioctl(fds[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    static long long perf_read(int fd) {
+        long long value;
+        if (fd < 0) return -1;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd, &value, sizeof(value)) != sizeof(value)) return -1;
+        return value;
+    }
+
+    void counters_t::stop(long long *cache_misses, long long *branch_misses) {
+        *cache_misses  = perf_read(cache_fd_);
+        *branch_misses = perf_read(branch_fd_);
+    }
+
+    double context_t::now() {
+        return std::chrono::duration<double>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    long context_t::rss_peak_kb() {
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss;
+    }
+
+    long context_t::rss_current_kb() {
+        long pages = 0, resident = 0;
+        FILE *f = fopen("/proc/self/statm", "r");
+        if (f == NULL) return -1;
+        if (fscanf(f, "%ld %ld", &pages, &resident) != 2) resident = -1;
+        fclose(f);
+        return resident < 0 ? -1 : resident * (sysconf(_SC_PAGESIZE) / 1024);
+    }
+
+    result_t &context_t::record(const result_t &r) {
+        results_.push_back(r);
+        fprintf(stderr, "... %-14s %-12s %-10s %-11s n=%-10zu %8.1f ns/op\n",
+                r.bench.c_str(), r.impl.c_str(), r.op.c_str(), 
+                r.dist.c_str(), r.n, 
+                r.ops ? 1e9*r.seconds/r.ops : 0.0);
+        return results_.back();
+    }
+
+    std::vector<entry_t> &registry() {
+        static std::vector<entry_t> benches;
+        return benches;
+    }
+
+    int register_bench(const char *name, bench_fn fn) {
+        entry_t e = { name, fn };
+        registry().push_back(e);
+        return (int)registry().size();
+    }
+
+    int compare_long(void *a, void *b) {
+        long x = *(long*)a, y = *(long*)b;
+        return (x > y) - (x < y);
+    }
+
+    ///
+    /// @brief The scrambled Zipfian generator of Gray et al. (also used by
+    ///        YCSB), ranks are spread over the key space with a hash.
+    ///
+    class zipf_t {
+    public:
+        zipf_t(size_t n, double theta, uint64_t seed) 
+            : n_(n), theta_(theta), rng_(seed) {
+            double zeta2 = 0;
+            zetan_ = 0;
+            for (size_t i = 1; i <= n; ++i) {
+                zetan_ += 1.0/std::pow((double)i, theta);
+                if (i == 2) zeta2 = zetan_;
+            }
+            if (n < 2) zeta2 = zetan_;
+            alpha_ = 1.0/(1.0-theta);
+            eta_   = (1.0-std::pow(2.0/n, 1.0-theta))/(1.0-zeta2/zetan_);
+        }
+        size_t next() {
+            double u  = rng_.uniform();
+            double uz = u*zetan_;
+            size_t rank;
+            if (uz < 1.0) rank = 0;
+            else if (uz < 1.0+std::pow(0.5, theta_)) rank = 1;
+            else rank = (size_t)(n_*std::pow(eta_*u-eta_+1.0, alpha_));
+            if (rank >= n_) rank = n_-1;
+            return scramble(rank);
+        }
+    private:
+        size_t scramble(size_t rank) const {
+            uint64_t h = 14695981039346656037ULL;
+            for (int i = 0; i < 8; ++i) {
+                h ^= (rank >> (8*i)) & 0xff;
+                h *= 1099511628211ULL;
+            }
+            return (size_t)(h % n_);
+        }
+        size_t n_;
+        double theta_, zetan_, alpha_, eta_;
+        rng_t  rng_;
+    };
+
+    static void shuffle(std::vector<long> &v, rng_t &rng) {
+        for (size_t i = v.size(); i > 1; --i) 
+            std::swap(v[i-1], v[rng.next() % i]);
+    }
+
+    std::vector<long> key_order(dist_t dist, size_t n, const config_t &cfg) {
+        std::vector<long> keys;
+        rng_t rng(cfg.seed);
+        keys.reserve(n);
+        switch (dist) {
+        case SEQUENTIAL:
+            for (size_t i = 0; i < n; ++i) keys.push_back(key_of(i));
+            break;
+        case RANDOM:
+            for (size_t i = 0; i < n; ++i) keys.push_back(key_of(i));
+            shuffle(keys, rng);
+            break;
+        case ZIPFIAN: {
+            /// Keys in order of first appearance in a Zipfian stream, the 
+            /// keys never drawn follow in a random order.
+            std::vector<char> seen(n, 0);
+            std::vector<long> rest;
+            zipf_t zipf(n, cfg.zipf_theta, cfg.seed);
+            for (size_t i = 0; i < n; ++i) {
+                size_t k = zipf.next();
+                if (!seen[k]) { seen[k] = 1; keys.push_back(key_of(k)); }
+            }
+            for (size_t i = 0; i < n; ++i) 
+                if (!seen[i]) rest.push_back(key_of(i));
+            shuffle(rest, rng);
+            keys.insert(keys.end(), rest.begin(), rest.end());
+            break;
+        }
+        case ADVERSARIAL:
+            /// A zig-zag converging to the median: every insertion lands at
+            /// the deepest point of the tree and triggers a fix up.
+            for (size_t lo = 0, hi = n; lo < hi; ) {
+                keys.push_back(key_of(lo++));
+                if (lo < hi) keys.push_back(key_of(--hi));
+            }
+            break;
+        }
+        return keys;
+    }
+
+    std::vector<long> access_stream(dist_t dist, size_t n, size_t count,
+                                    const config_t &cfg) {
+        std::vector<long> keys;
+        rng_t rng(cfg.seed ^ 0x5bd1e995ULL);
+        keys.reserve(count);
+        switch (dist) {
+        case SEQUENTIAL:
+            for (size_t i = 0; i < count; ++i) keys.push_back(key_of(i % n));
+            break;
+        case RANDOM:
+            for (size_t i = 0; i < count; ++i) 
+                keys.push_back(key_of(rng.next() % n));
+            break;
+        case ZIPFIAN: {
+            zipf_t zipf(n, cfg.zipf_theta, cfg.seed ^ 0x5bd1e995ULL);
+            for (size_t i = 0; i < count; ++i) 
+                keys.push_back(key_of(zipf.next()));
+            break;
+        }
+        case ADVERSARIAL:
+            /// Alternate between the two extremes of the key space: the
+            /// deepest paths of the tree with no reuse between two steps.
+            for (size_t i = 0; i < count; ++i) 
+                keys.push_back(key_of((i & 1) ? n-1-(i/2)%n : (i/2)%n));
+            break;
+        }
+        return keys;
+    }
+
+}  // namespace urb_bench
@@ -0,0 +1,202 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file bench/src/bench.h
+/// @author Issam SAID
+/// @brief Common helpers used by the urb_tree benchmarks.
+/// 
+/// @details Each benchmark is a function registered with URB_BENCH, it 
+/// receives a context holding the configuration (sizes, key distributions,
+/// seed) and records its measurements through context_t::measure. The 
+/// results are gathered and written as a JSON document by main.cc.
+///
+#ifndef __URB_TREE_BENCH_H_
+#define __URB_TREE_BENCH_H_
+
+#include <stdint.h>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace urb_bench {
+
+    ///
+    /// @brief The key distributions used to generate the workloads.
+    ///
+    enum dist_t { SEQUENTIAL, RANDOM, ZIPFIAN, ADVERSARIAL };
+
+    const char *dist_name(dist_t dist);
+
+    ///
+    /// @brief The benchmarks configuration (set from the command line).
+    ///
+    struct config_t {
+        std::vector<size_t> sizes;
+        std::vector<dist_t> dists;
+        std::string filter;
+        uint64_t seed;
+        double   zipf_theta;
+        int      threads;
+    };
+
+    ///
+    /// @brief One measurement, serialized as a JSON object.
+    ///
+    struct result_t {
+        std::string bench;
+        std::string impl;
+        std::string op;
+        std::string dist;
+        size_t n;
+        size_t ops;
+        double seconds;
+        long long cache_misses;   // -1 if the counter is not available.
+        long long branch_misses;  // -1 if the counter is not available.
+        long rss_peak_kb;
+        std::vector<std::pair<std::string, double> > metrics;
+    };
+
+    ///
+    /// @brief Hardware counters read with perf_event_open when permitted.
+    ///
+    class counters_t {
+    public:
+        counters_t();
+        ~counters_t();
+        void start();
+        void stop(long long *cache_misses, long long *branch_misses);
+    private:
+        int cache_fd_;
+        int branch_fd_;
+    };
+
+    ///
+    /// @brief The context given to each benchmark.
+    ///
+    class context_t {
+    public:
+        explicit context_t(const config_t &cfg) : cfg(cfg) {}
+
+        const config_t &cfg;
+
+        ///
+        /// @brief Run f once, time it and record ops operations.
+        ///
+        template<class F>
+        result_t &measure(const std::string &bench, const std::string &impl,
+                          const std::string &op, dist_t dist, 
+                          size_t n, size_t ops, F f) {
+            result_t r;
+            r.bench = bench; r.impl = impl; r.op = op; 
+            r.dist  = dist_name(dist);
+            r.n     = n; r.ops = ops;
+            double t0 = now();
+            counters_.start();
+            f();
+            counters_.stop(&r.cache_misses, &r.branch_misses);
+            r.seconds     = now() - t0;
+            r.rss_peak_kb = rss_peak_kb();
+            return record(r);
+        }
+
+        ///
+        /// @brief Store a result and log a one line summary on stderr.
+        ///
+        result_t &record(const result_t &r);
+
+        const std::vector<result_t> &results() const { return results_; }
+
+        static double now();
+        static long   rss_peak_kb();
+        static long   rss_current_kb();
+    private:
+        counters_t counters_;
+        std::vector<result_t> results_;
+    };
+
+    typedef void (*bench_fn)(context_t &ctx);
+
+    struct entry_t { const char *name; bench_fn fn; };
+
+    std::vector<entry_t> &registry();
+
+    int register_bench(const char *name, bench_fn fn);
+
+    ///
+    /// @brief The keys used by the workloads are the even numbers 2*i for
+    ///        i in [0, n), odd numbers can then be used to miss.
+    ///
+    inline long key_of(size_t i) { return 2*(long)i; }
+
+    ///
+    /// @brief A permutation of the n keys, following the distribution, used
+    ///        to insert or remove keys.
+    ///
+    std::vector<long> key_order(dist_t dist, size_t n, const config_t &cfg);
+
+    ///
+    /// @brief A stream of count accesses to the n keys following the 
+    ///        distribution, used to look up keys.
+    ///
+    std::vector<long> access_stream(dist_t dist, size_t n, size_t count,
+                                    const config_t &cfg);
+
+    ///
+    /// @brief The urb_tree comparator for pointers to long integers.
+    ///
+    int compare_long(void *a, void *b);
+
+    ///
+    /// @brief A small deterministic generator (splitmix64).
+    ///
+    struct rng_t {
+        uint64_t s;
+        explicit rng_t(uint64_t seed) : s(seed) {}
+        uint64_t next() {
+            uint64_t z = (s += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            return z ^ (z >> 31);
+        }
+        double uniform() { return (next() >> 11) * (1.0/9007199254740992.0); }
+    };
+
+}  // namespace urb_bench
+
+///
+/// @def URB_BENCH
+/// @brief Define and register a benchmark function.
+///
+#define URB_BENCH(name)                                                      \
+    static void name(urb_bench::context_t &ctx);                             \
+    static int name##_registered __attribute__((unused)) =                   \
+        urb_bench::register_bench(#name, name);                              \
+    static void name(urb_bench::context_t &ctx)
+
+#endif  // __URB_TREE_BENCH_H_
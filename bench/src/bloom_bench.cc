@@ -0,0 +1,102 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file bench/src/bloom_bench.cc
+/// @author Issam SAID
+/// @brief Benchmark the Bloom filters on lookups that mostly miss.
+/// @details Four lookups out of five are for keys that are not in the tree.
+/// The lookups are measured with urb_tree_find and through a plain and a 
+/// counting filter sized for a 1% false positive rate, the comparator 
+/// calls per lookup are counted in an extra untimed pass.
+///
+#include <urb_tree/urb_tree.h>
+#include "bench.h"
+
+using namespace urb_bench;
+
+namespace {
+
+    size_t calls = 0;
+
+    int count_long(void *a, void *b) { calls++; return compare_long(a, b); }
+
+    uint64_t hash_long(void *a) { return (uint64_t)*(long*)a; }
+
+}  // namespace
+
+URB_BENCH(bloom) {
+    for (size_t s = 0; s < ctx.cfg.sizes.size(); ++s) {
+        size_t n = ctx.cfg.sizes[s], i;
+        std::vector<long> keys = key_order(RANDOM, n, ctx.cfg);
+        std::vector<long> probe(n);
+        rng_t  rng(ctx.cfg.seed);
+        for (i = 0; i < n; ++i) {
+            probe[i] = keys[rng.next() % n];
+            /// The key_of(rank) are even, the odd keys miss.
+            if (rng.next() % 5) probe[i] |= 1;
+        }
+        for (int counting = -1; counting < 2; ++counting) {
+            std::string impl = counting < 0 ? "urb_tree" : 
+                               counting ? "bloom_counting" : "bloom";
+            urb_t *urb = &urb_sentinel;
+            urb_bloom_t bloom;
+            size_t found = 0;
+            if (counting >= 0) 
+                urb_bloom_init(&bloom, n, 0.01, hash_long, counting);
+            for (i = 0; i < n; ++i) {
+                urb_t *x = urb_tree_create(&keys[i], NULL);
+                if (counting < 0) urb_tree_put(&urb, x, compare_long);
+                else urb_bloom_put(&bloom, &urb, x, compare_long);
+            }
+            result_t &r = ctx.measure("bloom", impl, "find_miss80", RANDOM, 
+                                      n, n, [&]() {
+                for (i = 0; i < n; ++i) 
+                    found += (counting < 0 ? 
+                              urb_tree_find(&urb, &probe[i], compare_long) :
+                              urb_bloom_find(&bloom, &urb, &probe[i], 
+                                             compare_long)) != &urb_sentinel;
+            });
+            calls = 0;
+            for (i = 0; i < n; ++i) {
+                if (counting < 0) urb_tree_find(&urb, &probe[i], count_long);
+                else urb_bloom_find(&bloom, &urb, &probe[i], count_long);
+            }
+            r.metrics.push_back(std::make_pair("compares_per_op", 
+                                               (double)calls/n));
+            if (counting >= 0) {
+                urb_bloom_stats_t st;
+                urb_bloom_stats(&bloom, &st);
+                r.metrics.push_back(std::make_pair("fp_rate", st.fp_rate));
+                r.metrics.push_back(std::make_pair("bits_per_key", 
+                                                   st.bits_per_key));
+                urb_bloom_delete(&bloom);
+            }
+            urb_tree_delete(&urb, NULL, NULL);
+        }
+    }
+}
@@ -0,0 +1,110 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file bench/src/btree_bench.cc
+/// @author Issam SAID
+/// @brief Benchmark the B+tree engine against the Red-Black trees.
+/// @details Both engines are filled, queried, scanned and emptied with the
+/// same integer keys, the speedup of the B+tree over the Red-Black tree is
+/// attached to each B+tree measurement.
+///
+#include <urb_tree/urb_tree.h>
+#include "bench.h"
+
+using namespace urb_bench;
+
+URB_BENCH(btree) {
+    for (size_t s = 0; s < ctx.cfg.sizes.size(); ++s) {
+        for (size_t d = 0; d < ctx.cfg.dists.size(); ++d) {
+            size_t n    = ctx.cfg.sizes[s];
+            dist_t dist = ctx.cfg.dists[d];
+            std::vector<long> keys   = key_order(dist, n, ctx.cfg);
+            std::vector<long> stream = access_stream(dist, n, n, ctx.cfg);
+            urb_t *urb = &urb_sentinel;
+            urb_btree_t *btree = urb_btree_create();
+            size_t found[2] = {0, 0};
+            double t[4];
+
+            t[0] = ctx.measure("btree", "urb_tree", "put", dist, n, n, [&]() {
+                for (size_t i = 0; i < n; ++i) {
+                    void *k = (void*)&keys[i];
+                    urb_tree_put(&urb, urb_tree_create(k, k), compare_long);
+                }
+            }).seconds;
+            t[1] = ctx.measure("btree", "urb_tree", "find", dist, n, n, [&]() {
+                for (size_t i = 0; i < n; ++i) 
+                    found[0] += urb_tree_find(&urb, &stream[i], compare_long) 
+                                != &urb_sentinel;
+            }).seconds;
+            t[2] = ctx.measure("btree", "urb_tree", "iterate", dist, n, n, 
+                               [&]() {
+                urb_t *i = urb_tree_min(&urb);
+                while (i != NULL && i != &urb_sentinel) {
+                    found[0] += i->key != NULL;
+                    i = urb_tree_succ(i);
+                }
+            }).seconds;
+            t[3] = ctx.measure("btree", "urb_tree", "pop", dist, n, n, [&]() {
+                for (size_t i = 0; i < n; ++i) 
+                    free(urb_tree_pop(&urb, &keys[i], compare_long));
+            }).seconds;
+
+            result_t &put = ctx.measure("btree", "urb_btree", "put", dist, 
+                                        n, n, [&]() {
+                for (size_t i = 0; i < n; ++i) 
+                    urb_btree_put(btree, keys[i], &keys[i]);
+            });
+            put.metrics.push_back(std::make_pair("speedup", t[0]/put.seconds));
+            put.metrics.push_back(std::make_pair("height", 
+                                                 (double)btree->height));
+            result_t &find = ctx.measure("btree", "urb_btree", "find", dist, 
+                                         n, n, [&]() {
+                for (size_t i = 0; i < n; ++i) 
+                    found[1] += urb_btree_find(btree, stream[i]).leaf != NULL;
+            });
+            find.metrics.push_back(std::make_pair("speedup", 
+                                                  t[1]/find.seconds));
+            result_t &it = ctx.measure("btree", "urb_btree", "iterate", dist,
+                                       n, n, [&]() {
+                urb_bpos_t p;
+                for (p = urb_btree_min(btree); p.leaf; p = urb_btree_succ(p))
+                    found[1] += urb_btree_value(p) != NULL;
+            });
+            it.metrics.push_back(std::make_pair("speedup", t[2]/it.seconds));
+            result_t &pop = ctx.measure("btree", "urb_btree", "pop", dist, 
+                                        n, n, [&]() {
+                for (size_t i = 0; i < n; ++i) 
+                    urb_btree_pop(btree, keys[i], NULL);
+            });
+            pop.metrics.push_back(std::make_pair("speedup", t[3]/pop.seconds));
+            if (found[0] != 2*n || found[1] != 2*n) 
+                fprintf(stderr, "... [btree] unexpected number of hits.\n");
+            urb_btree_delete(btree, NULL);
+        }
+    }
+}
@@ -0,0 +1,124 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file bench/src/checkpoint_bench.cc
+/// @author Issam SAID
+/// @brief Benchmark the delta checkpoints: full against incremental writes.
+/// @details n keys are put in a tree and a base checkpoint is written. 
+/// Then, for DELTAS rounds, 1% of the keys are updated (half new values, 
+/// a quarter removed and put back) and either a full base or a delta is 
+/// written; the records written per round are reported. Recovery is timed 
+/// from the base and the whole chain of deltas, and from a chain merged 
+/// every 2 deltas.
+///
+#include <string>
+#include <unistd.h>
+#include <urb_tree/urb_tree.h>
+#include "bench.h"
+
+using namespace urb_bench;
+
+namespace {
+
+    const size_t DELTAS = 8;
+
+    std::string temporary() {
+        char path[] = "/tmp/urb_checkpoint_bench_XXXXXX";
+        int fd = mkstemp(path);
+        close(fd);
+        return path;
+    }
+
+}  // namespace
+
+URB_BENCH(checkpoint) {
+    /// 0 never merges the deltas, base writes a full checkpoint each round.
+    const char  *impls[]  = { "base", "delta", "delta_merge_2" };
+    const size_t merges[] = { 0, 0, 2 };
+    for (size_t s = 0; s < ctx.cfg.sizes.size(); ++s) {
+        size_t n = ctx.cfg.sizes[s], i, d, m = n/100 ? n/100 : 1;
+        std::vector<long> keys = key_order(RANDOM, n, ctx.cfg);
+        std::vector<long> values(n, 0);
+        for (size_t f = 0; f < sizeof(impls)/sizeof(impls[0]); ++f) {
+            urb_t *urb = &urb_sentinel;
+            urb_checkpoint_t cp;
+            std::vector<std::string> files;
+            size_t written = 0;
+            rng_t rng(ctx.cfg.seed);
+            urb_checkpoint_init(&cp, &urb, sizeof(long), sizeof(long), 
+                                merges[f], compare_long);
+            for (i = 0; i < n; ++i) 
+                urb_checkpoint_put(&cp, urb_tree_create(&keys[i], 
+                                                        &values[i]));
+            files.push_back(temporary());
+            ctx.measure("checkpoint", impls[f], "base", RANDOM, n, n, [&]() {
+                urb_checkpoint_base(&cp, files.back().c_str());
+            });
+            for (d = 0; d < DELTAS; ++d) {
+                for (i = 0; i < m; ++i) {
+                    size_t k = rng.next() % n;
+                    if (i % 4 == 3) {
+                        urb_tree_release(urb_checkpoint_pop(&cp, &keys[k]));
+                        urb_checkpoint_put(&cp, urb_tree_create(&keys[k], 
+                                                                &values[k]));
+                    } else {
+                        values[k] += 1;
+                        urb_checkpoint_touch(&cp, urb_tree_find(&urb, &keys[k],
+                                                                compare_long));
+                    }
+                }
+                files.push_back(temporary());
+                files.push_back(files.back() + ".merge");
+                std::string path = files[files.size() - 2];
+                ctx.measure("checkpoint", impls[f], "write", RANDOM, n, m, 
+                            [&]() {
+                    if (f == 0) urb_checkpoint_base(&cp, path.c_str());
+                    else        urb_checkpoint_delta(&cp, path.c_str());
+                }).metrics.push_back(std::make_pair("records", 
+                                                    (double)cp.written));
+                written += cp.written;
+            }
+            result_t &r = 
+                ctx.measure("checkpoint", impls[f], "recover", RANDOM, n, n, 
+                            [&]() {
+                urb_t *copy = &urb_sentinel;
+                urb_checkpoint_recover(&copy, (const char **)cp.chain, 
+                                       cp.length, compare_long);
+                if (urb_tree_size(&copy) != n)
+                    fprintf(stderr, "... [checkpoint] lost keys.\n");
+                urb_tree_delete(&copy, free, NULL);
+            });
+            r.metrics.push_back(std::make_pair("files", (double)cp.length));
+            r.metrics.push_back(std::make_pair("records_written", 
+                                               (double)written));
+            urb_checkpoint_delete(&cp);
+            urb_tree_delete(&urb, NULL, NULL);
+            for (i = 0; i < files.size(); ++i) remove(files[i].c_str());
+        }
+    }
+}
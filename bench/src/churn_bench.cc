@@ -0,0 +1,120 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file bench/src/churn_bench.cc
+/// @author Issam SAID
+/// @brief Benchmark the node caches on a queue-like put/pop churn.
+/// @details A tree of QUEUE_DEPTH keys per thread is shared by the threads 
+/// and protected by a mutex (the trees share the sentinel, so they can not
+/// be updated concurrently). Each thread runs n rounds of popping its 
+/// smallest key and inserting a new largest key, the nodes are allocated 
+/// and given back outside of the critical section: either freed (so that 
+/// urb_tree_create goes to malloc) or released to the node caches. This is
+/// run with 1 thread and with --threads threads.
+///
+#include <mutex>
+#include <thread>
+#include <urb_tree/urb_tree.h>
+#include "bench.h"
+
+using namespace urb_bench;
+
+namespace {
+
+    const size_t QUEUE_DEPTH = 1024;
+
+    struct queue_t {
+        urb_t *urb;
+        std::mutex lock;
+        std::vector<long> keys;
+        size_t threads;
+    };
+
+    ///
+    /// @brief The keys of the thread t are keys[i*threads + t].
+    ///
+    void run_churn(queue_t *q, size_t t, size_t n, bool release) {
+        urb_t *node;
+        size_t i;
+        for (i = 0; i < n; ++i) {
+            node = urb_tree_create(&q->keys[(QUEUE_DEPTH+i)*q->threads+t], 
+                                   NULL);
+            q->lock.lock();
+            urb_tree_put(&q->urb, node, compare_long);
+            node = urb_tree_pop(&q->urb, &q->keys[i*q->threads+t], 
+                                compare_long);
+            q->lock.unlock();
+            if (release) urb_tree_release(node);
+            else free(node);
+        }
+        if (release) urb_tree_cache_flush();
+    }
+
+}  // namespace
+
+URB_BENCH(churn) {
+    int counts[2] = {1, ctx.cfg.threads};
+    for (size_t s = 0; s < ctx.cfg.sizes.size(); ++s) {
+        for (int c = 0; c < (counts[1] > 1 ? 2 : 1); ++c) {
+            size_t n  = ctx.cfg.sizes[s];
+            int    nt = counts[c];
+            std::string suffix = "_t" + std::to_string(nt);
+            double t  = 0;
+            for (int release = 0; release < 2; ++release) {
+                /// Start from empty caches so that both runs malloc the 
+                /// initial trees.
+                urb_tree_cache_trim();
+                queue_t q;
+                q.urb     = &urb_sentinel;
+                q.threads = nt;
+                q.keys.resize((QUEUE_DEPTH+n)*nt);
+                for (size_t i = 0; i < q.keys.size(); ++i) 
+                    q.keys[i] = key_of(i);
+                for (size_t i = 0; i < QUEUE_DEPTH*nt; ++i) 
+                    urb_tree_put(&q.urb, urb_tree_create(&q.keys[i], NULL), 
+                                 compare_long);
+                result_t &r = ctx.measure("churn", 
+                                          release ? "cache" : "malloc", 
+                                          "pop_put" + suffix, SEQUENTIAL, 
+                                          n, n*nt, [&]() {
+                    std::vector<std::thread> threads;
+                    for (int k = 0; k < nt; ++k) 
+                        threads.push_back(std::thread(run_churn, &q, k, n, 
+                                                      release != 0));
+                    for (int k = 0; k < nt; ++k) threads[k].join();
+                });
+                urb_tree_delete(&q.urb, NULL, NULL);
+                if (release) 
+                    r.metrics.push_back(std::make_pair("speedup", 
+                                                       t/r.seconds));
+                t = r.seconds;
+            }
+        }
+    }
+    urb_tree_cache_trim();
+}
@@ -0,0 +1,105 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file bench/src/combine_bench.cc
+/// @author Issam SAID
+/// @brief Benchmark the flat combining front end against a mutex.
+/// @details n random keys are put in a shared tree by 1 to 64 threads 
+/// (each thread puts the keys i = t mod threads), then popped the same 
+/// way. The updates are serialized either with a mutex around each 
+/// urb_tree_put/urb_tree_pop or with a combiner, whose batches are applied
+/// as published or sorted by key. The average number of requests per 
+/// combining pass is reported.
+///
+#include <mutex>
+#include <thread>
+#include <urb_tree/urb_tree.h>
+#include "bench.h"
+
+using namespace urb_bench;
+
+URB_BENCH(combine) {
+    const int counts[] = { 1, 2, 4, 8, 16, 32, 64 };
+    const char *impls[] = { "mutex", "combine", "combine_sorted" };
+    for (size_t s = 0; s < ctx.cfg.sizes.size(); ++s) {
+        size_t n = ctx.cfg.sizes[s];
+        std::vector<long> keys = key_order(RANDOM, n, ctx.cfg);
+        for (size_t c = 0; c < sizeof(counts)/sizeof(counts[0]); ++c) {
+            int nt = counts[c];
+            std::string suffix = "_t" + std::to_string(nt);
+            for (int m = 0; m < 3; ++m) {
+                urb_t *urb = &urb_sentinel;
+                std::mutex lock;
+                urb_combine_t combine;
+                urb_combine_init(&combine, &urb, nt, m == 2, compare_long);
+                auto put = [&](int t) {
+                    for (size_t i = t; i < n; i += nt) {
+                        urb_t *x = urb_tree_create(&keys[i], NULL);
+                        if (m) {
+                            urb_combine_put(&combine, t, x);
+                        } else {
+                            std::lock_guard<std::mutex> guard(lock);
+                            urb_tree_put(&urb, x, compare_long);
+                        }
+                    }
+                };
+                auto pop = [&](int t) {
+                    for (size_t i = t; i < n; i += nt) {
+                        urb_t *x;
+                        if (m) {
+                            x = urb_combine_pop(&combine, t, &keys[i]);
+                        } else {
+                            std::lock_guard<std::mutex> guard(lock);
+                            x = urb_tree_pop(&urb, &keys[i], compare_long);
+                        }
+                        urb_tree_release(x);
+                    }
+                };
+                for (int p = 0; p < 2; ++p) {
+                    result_t &r = ctx.measure("combine", impls[m], 
+                                              (p ? "pop" : "put") + suffix, 
+                                              RANDOM, n, n, [&]() {
+                        std::vector<std::thread> threads;
+                        for (int t = 0; t < nt; ++t) 
+                            threads.push_back(p ? std::thread(pop, t) : 
+                                                  std::thread(put, t));
+                        for (int t = 0; t < nt; ++t) threads[t].join();
+                    });
+                    if (m) {
+                        r.metrics.push_back(std::make_pair("batch", 
+                            (double)combine.requests / combine.passes));
+                        combine.requests = combine.passes = 0;
+                    }
+                }
+                if (urb != &urb_sentinel) 
+                    fprintf(stderr, "... [combine] the tree is not empty.\n");
+                urb_combine_delete(&combine);
+            }
+        }
+    }
+}
@@ -0,0 +1,90 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file bench/src/compact_bench.cc
+/// @author Issam SAID
+/// @brief Benchmark the scans and the lookups before and after compaction.
+/// @details The tree is built from random keys and churned (half of the 
+/// keys are popped and put back with new nodes) so its nodes are scattered
+/// in the heap. The in-order scan and the random lookups are then measured
+/// on the churned tree and after a compaction into each layout, together 
+/// with the time spent in the compaction itself.
+///
+#include <urb_tree/urb_tree.h>
+#include "bench.h"
+
+using namespace urb_bench;
+
+URB_BENCH(compact) {
+    const urb_layout_t layouts[] = { 
+        URB_LAYOUT_INORDER, URB_LAYOUT_BFS, URB_LAYOUT_VEB 
+    };
+    const char *names[] = { "inorder", "bfs", "veb" };
+    for (size_t s = 0; s < ctx.cfg.sizes.size(); ++s) {
+        size_t n = ctx.cfg.sizes[s], i;
+        std::vector<long> keys = key_order(RANDOM, n, ctx.cfg);
+        std::vector<long> probe = key_order(RANDOM, n, ctx.cfg);
+        std::vector<urb_t*> churn;
+        urb_t *urb = &urb_sentinel;
+        rng_t  rng(ctx.cfg.seed);
+        for (i = 0; i < n; ++i) 
+            urb_tree_put(&urb, urb_tree_create(&keys[i], NULL), compare_long);
+        /// Interleave the allocations of the churned nodes with garbage.
+        for (i = 0; i < n; ++i) {
+            if (rng.next() % 2) continue;
+            urb_tree_release(urb_tree_pop(&urb, &keys[i], compare_long));
+            churn.push_back(urb_tree_create(NULL, NULL));
+        }
+        for (i = 0; i < n; ++i) 
+            if (urb_tree_find(&urb, &keys[i], compare_long) == &urb_sentinel)
+                urb_tree_put(&urb, urb_tree_create(&keys[i], NULL), 
+                             compare_long);
+        for (i = 0; i < churn.size(); ++i) urb_tree_release(churn[i]);
+        for (size_t l = 0; l <= sizeof(layouts)/sizeof(layouts[0]); ++l) {
+            std::string impl = l == 0 ? "scattered" : names[l-1];
+            size_t sum = 0, found = 0;
+            if (l > 0) 
+                ctx.measure("compact", impl, "compact", RANDOM, n, n, [&]() {
+                    urb_tree_compact(&urb, layouts[l-1]);
+                });
+            ctx.measure("compact", impl, "scan", RANDOM, n, n, [&]() {
+                for (urb_t *x = urb_tree_min(&urb); 
+                     x != NULL && x != &urb_sentinel; x = urb_tree_succ(x)) 
+                    sum += *(long*)x->key != 0;
+            });
+            ctx.measure("compact", impl, "find", RANDOM, n, n, [&]() {
+                for (i = 0; i < n; ++i) 
+                    found += urb_tree_find(&urb, &probe[i], compare_long) 
+                             != &urb_sentinel;
+            });
+            if (found != n || sum + 1 < n) 
+                fprintf(stderr, "... [compact] unexpected number of hits.\n");
+        }
+        urb_tree_delete(&urb, NULL, NULL);
+    }
+}
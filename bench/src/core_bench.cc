@@ -0,0 +1,157 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file bench/src/core_bench.cc
+/// @author Issam SAID
+/// @brief Benchmark the urb_tree core routines against std::map.
+/// 
+/// @details For each size and distribution the tree is filled with 
+/// urb_tree_put, queried with urb_tree_find, scanned with urb_tree_succ, 
+/// emptied with urb_tree_pop, refilled and emptied with urb_tree_erase_node
+/// and finally refilled and dropped with urb_tree_delete. The same sequence
+/// is run on a std::map<long, long>.
+///
+#include <map>
+#include <urb_tree/urb_tree.h>
+#include "bench.h"
+
+using namespace urb_bench;
+
+namespace {
+
+    ///
+    /// @brief Attach the structural counters (when urb_tree is built with
+    ///        them) collected since the last call to a measurement.
+    ///
+    void attach_stats(result_t &r) {
+        urb_stats_t s;
+        if (!urb_tree_stats_enabled() || r.ops == 0) return;
+        urb_tree_stats(&s);
+        urb_tree_stats_reset();
+        double ops = (double)r.ops;
+        r.metrics.push_back(std::make_pair("compares_per_op", 
+            (s.find_compares+s.put_compares+s.pop_compares)/ops));
+        r.metrics.push_back(std::make_pair("depth_per_op", 
+            (s.find_depth+s.put_depth+s.pop_depth)/ops));
+        r.metrics.push_back(std::make_pair("max_depth", (double)s.max_depth));
+        r.metrics.push_back(std::make_pair("rotations_per_op", 
+            (s.left_rotations+s.right_rotations)/ops));
+        r.metrics.push_back(std::make_pair("recolors_per_op", 
+            (s.put_recolors+s.pop_recolors)/ops));
+    }
+
+    urb_t *fill(const std::vector<long> &keys) {
+        urb_t *urb = &urb_sentinel;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            void *k = (void*)&keys[i];
+            urb_tree_put(&urb, urb_tree_create(k, k), compare_long);
+        }
+        return urb;
+    }
+
+}  // namespace
+
+URB_BENCH(core) {
+    for (size_t s = 0; s < ctx.cfg.sizes.size(); ++s) {
+        for (size_t d = 0; d < ctx.cfg.dists.size(); ++d) {
+            size_t n    = ctx.cfg.sizes[s];
+            dist_t dist = ctx.cfg.dists[d];
+            std::vector<long> keys   = key_order(dist, n, ctx.cfg);
+            std::vector<long> stream = access_stream(dist, n, n, ctx.cfg);
+            urb_t *urb = &urb_sentinel;
+            size_t found = 0;
+
+            urb_tree_stats_reset();
+            attach_stats(ctx.measure("core", "urb_tree", "put", dist, 
+                                     n, n, [&]() {
+                for (size_t i = 0; i < n; ++i) {
+                    void *k = (void*)&keys[i];
+                    urb_tree_put(&urb, urb_tree_create(k, k), compare_long);
+                }
+            }));
+            urb_tree_stats_reset();
+            attach_stats(ctx.measure("core", "urb_tree", "find", dist, 
+                                     n, n, [&]() {
+                for (size_t i = 0; i < n; ++i) 
+                    found += urb_tree_find(&urb, &stream[i], compare_long) 
+                             != &urb_sentinel;
+            }));
+            ctx.measure("core", "urb_tree", "iterate", dist, n, n, [&]() {
+                urb_t *i = urb_tree_min(&urb);
+                while (i != NULL && i != &urb_sentinel) {
+                    found += i->key != NULL;
+                    i = urb_tree_succ(i);
+                }
+            });
+            urb_tree_stats_reset();
+            attach_stats(ctx.measure("core", "urb_tree", "pop", dist, 
+                                     n, n, [&]() {
+                for (size_t i = 0; i < n; ++i) 
+                    free(urb_tree_pop(&urb, &keys[i], compare_long));
+            }));
+            std::vector<urb_t*> nodes(n);
+            for (size_t i = 0; i < n; ++i) {
+                nodes[i] = urb_tree_create(&keys[i], &keys[i]);
+                urb_tree_put(&urb, nodes[i], compare_long);
+            }
+            ctx.measure("core", "urb_tree", "erase_node", dist, n, n, [&]() {
+                for (size_t i = 0; i < n; ++i) 
+                    free(urb_tree_erase_node(&urb, nodes[i]));
+            });
+            urb = fill(keys);
+            ctx.measure("core", "urb_tree", "delete", dist, n, n, [&]() {
+                urb_tree_delete(&urb, NULL, NULL);
+            });
+
+            std::map<long, long> *map = new std::map<long, long>();
+            ctx.measure("core", "std::map", "put", dist, n, n, [&]() {
+                for (size_t i = 0; i < n; ++i) 
+                    map->insert(std::make_pair(keys[i], keys[i]));
+            });
+            ctx.measure("core", "std::map", "find", dist, n, n, [&]() {
+                for (size_t i = 0; i < n; ++i) 
+                    found += map->find(stream[i]) != map->end();
+            });
+            ctx.measure("core", "std::map", "iterate", dist, n, n, [&]() {
+                std::map<long, long>::const_iterator it;
+                for (it = map->begin(); it != map->end(); ++it)
+                    found += it->second >= 0;
+            });
+            ctx.measure("core", "std::map", "pop", dist, n, n, [&]() {
+                for (size_t i = 0; i < n; ++i) map->erase(keys[i]);
+            });
+            for (size_t i = 0; i < n; ++i) 
+                map->insert(std::make_pair(keys[i], keys[i]));
+            ctx.measure("core", "std::map", "delete", dist, n, n, [&]() {
+                delete map;
+            });
+            if (found != 4*n) 
+                fprintf(stderr, "... [core] unexpected number of hits.\n");
+        }
+    }
+}
@@ -0,0 +1,99 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file bench/src/cursor_bench.cc
+/// @author Issam SAID
+/// @brief Benchmark the cursors (finger search) on localized traces.
+/// @details A trace is a random walk over the ranks of the keys, each step
+/// is drawn uniformly in [-d, d]. The trace is looked up with urb_tree_find
+/// (from the root) and with urb_cursor_seek (from the previous key), the 
+/// comparator calls per lookup are counted in an extra untimed pass.
+///
+#include <urb_tree/urb_tree.h>
+#include "bench.h"
+
+using namespace urb_bench;
+
+namespace {
+
+    size_t calls = 0;
+
+    int count_long(void *a, void *b) { calls++; return compare_long(a, b); }
+
+}  // namespace
+
+URB_BENCH(cursor) {
+    const long spans[] = { 1, 16, 256, 4096 };
+    for (size_t s = 0; s < ctx.cfg.sizes.size(); ++s) {
+        size_t n = ctx.cfg.sizes[s], i;
+        std::vector<long> keys = key_order(RANDOM, n, ctx.cfg);
+        std::vector<long> trace(n);
+        urb_t *urb = &urb_sentinel;
+        rng_t  rng(ctx.cfg.seed);
+        for (i = 0; i < n; ++i) 
+            urb_tree_put(&urb, urb_tree_create(&keys[i], NULL), compare_long);
+        for (size_t d = 0; d < sizeof(spans)/sizeof(spans[0]); ++d) {
+            std::string op = "find_d" + std::to_string(spans[d]);
+            long rank = (long)(n/2);
+            size_t found[2] = {0, 0};
+            urb_cursor_t cursor;
+            for (i = 0; i < n; ++i) {
+                rank += (long)(rng.next() % (2*spans[d]+1)) - spans[d];
+                if (rank < 0) rank = -rank;
+                if (rank >= (long)n) rank = 2*((long)n-1) - rank;
+                trace[i] = key_of(rank);
+            }
+            double t = ctx.measure("cursor", "urb_tree", op, RANDOM, n, n, 
+                                   [&]() {
+                for (i = 0; i < n; ++i) 
+                    found[0] += urb_tree_find(&urb, &trace[i], compare_long) 
+                                != &urb_sentinel;
+            }).seconds;
+            urb_cursor_init(&cursor, &urb, compare_long);
+            result_t &r = ctx.measure("cursor", "urb_cursor", op, RANDOM, 
+                                      n, n, [&]() {
+                for (i = 0; i < n; ++i) 
+                    found[1] += urb_cursor_seek(&cursor, &trace[i]) 
+                                != &urb_sentinel;
+            });
+            r.metrics.push_back(std::make_pair("speedup", t/r.seconds));
+            calls = 0;
+            for (i = 0; i < n; ++i) urb_tree_find(&urb, &trace[i], count_long);
+            r.metrics.push_back(std::make_pair("compares_per_op_find", 
+                                               (double)calls/n));
+            calls = 0;
+            urb_cursor_init(&cursor, &urb, count_long);
+            for (i = 0; i < n; ++i) urb_cursor_seek(&cursor, &trace[i]);
+            r.metrics.push_back(std::make_pair("compares_per_op", 
+                                               (double)calls/n));
+            if (found[0] != n || found[1] != n) 
+                fprintf(stderr, "... [cursor] unexpected number of hits.\n");
+        }
+        urb_tree_delete(&urb, NULL, NULL);
+    }
+}
@@ -0,0 +1,85 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file bench/src/destroy_bench.cc
+/// @author Issam SAID
+/// @brief Benchmark the time a tree destruction blocks the caller.
+/// @details The same tree is destroyed with urb_tree_delete, with 
+/// urb_tree_delete_async (only the detach is timed, the background thread
+/// is waited for after the measure) and by slices of 1024 nodes, where the
+/// longest slice is reported.
+///
+#include <chrono>
+#include <urb_tree/urb_tree.h>
+#include "bench.h"
+
+using namespace urb_bench;
+
+namespace {
+
+    void build(urb_t **urb, std::vector<long> &keys) {
+        *urb = &urb_sentinel;
+        for (size_t i = 0; i < keys.size(); ++i) 
+            urb_tree_put(urb, urb_tree_create(&keys[i], NULL), compare_long);
+    }
+
+}  // namespace
+
+URB_BENCH(destroy) {
+    for (size_t s = 0; s < ctx.cfg.sizes.size(); ++s) {
+        size_t n = ctx.cfg.sizes[s];
+        std::vector<long> keys = key_order(RANDOM, n, ctx.cfg);
+        urb_t *urb;
+        build(&urb, keys);
+        ctx.measure("destroy", "urb_tree", "delete", RANDOM, n, n, [&]() {
+            urb_tree_delete(&urb, NULL, NULL);
+        });
+        build(&urb, keys);
+        ctx.measure("destroy", "urb_tree", "delete_async", RANDOM, n, n, 
+                    [&]() {
+            urb_tree_delete_async(&urb, NULL, NULL);
+        });
+        urb_tree_delete_wait();
+        build(&urb, keys);
+        urb_destroy_t destroy;
+        double longest = 0;
+        result_t &r = ctx.measure("destroy", "urb_tree", "step_1024", RANDOM,
+                                  n, n, [&]() {
+            bool done = false;
+            urb_tree_detach(&destroy, &urb, NULL, NULL);
+            while (!done) {
+                auto t0 = std::chrono::steady_clock::now();
+                done = urb_destroy_step(&destroy, 1024);
+                std::chrono::duration<double> t = 
+                    std::chrono::steady_clock::now() - t0;
+                if (t.count() > longest) longest = t.count();
+            }
+        });
+        r.metrics.push_back(std::make_pair("longest_step_us", 1e6*longest));
+    }
+}
@@ -0,0 +1,73 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file bench/src/find_batch_bench.cc
+/// @author Issam SAID
+/// @brief Benchmark urb_tree_find_batch against a loop of urb_tree_find.
+///
+#include <urb_tree/urb_tree.h>
+#include "bench.h"
+
+using namespace urb_bench;
+
+URB_BENCH(find_batch) {
+    for (size_t s = 0; s < ctx.cfg.sizes.size(); ++s) {
+        for (size_t d = 0; d < ctx.cfg.dists.size(); ++d) {
+            size_t n    = ctx.cfg.sizes[s];
+            dist_t dist = ctx.cfg.dists[d];
+            std::vector<long> keys   = key_order(RANDOM, n, ctx.cfg);
+            std::vector<long> stream = access_stream(dist, n, n, ctx.cfg);
+            std::vector<void*>  ptrs(n);
+            std::vector<urb_t*> results(n);
+            urb_t *urb = &urb_sentinel;
+            size_t single = 0, batch = 0;
+            for (size_t i = 0; i < n; ++i) {
+                void *k = (void*)&keys[i];
+                urb_tree_put(&urb, urb_tree_create(k, k), compare_long);
+                ptrs[i] = (void*)&stream[i];
+            }
+            double t1 = ctx.measure("find_batch", "urb_tree", "find", dist, 
+                                    n, n, [&]() {
+                for (size_t i = 0; i < n; ++i) 
+                    single += urb_tree_find(&urb, ptrs[i], compare_long) 
+                              != &urb_sentinel;
+            }).seconds;
+            result_t &r = ctx.measure("find_batch", "urb_tree", "find_batch",
+                                      dist, n, n, [&]() {
+                urb_tree_find_batch(&urb, &ptrs[0], n, &results[0], 
+                                    compare_long);
+                for (size_t i = 0; i < n; ++i) 
+                    batch += results[i] != &urb_sentinel;
+            });
+            r.metrics.push_back(std::make_pair("speedup", t1/r.seconds));
+            if (single != n || batch != n) 
+                fprintf(stderr, "... [find_batch] unexpected misses.\n");
+            urb_tree_delete(&urb, NULL, NULL);
+        }
+    }
+}
@@ -0,0 +1,107 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file bench/src/frozen_bench.cc
+/// @author Issam SAID
+/// @brief Benchmark the frozen Eytzinger layout against the live tree.
+///
+#include <stdint.h>
+#include <urb_tree/urb_tree.h>
+#include "bench.h"
+
+using namespace urb_bench;
+
+URB_BENCH(frozen) {
+    for (size_t s = 0; s < ctx.cfg.sizes.size(); ++s) {
+        for (size_t d = 0; d < ctx.cfg.dists.size(); ++d) {
+            size_t n    = ctx.cfg.sizes[s];
+            dist_t dist = ctx.cfg.dists[d];
+            std::vector<long> keys   = key_order(RANDOM, n, ctx.cfg);
+            std::vector<long> stream = access_stream(dist, n, n, ctx.cfg);
+            std::vector<size_t> results(n);
+            urb_t *urb = &urb_sentinel, *it;
+            urb_frozen_t *f;
+            size_t hits[4] = {0, 0, 0, 0}, i, j;
+            long sum[2] = {0, 0};
+            for (i = 0; i < n; ++i) {
+                void *k = (void*)&keys[i];
+                urb_tree_put(&urb, urb_tree_create(k, k), compare_long);
+            }
+            result_t &r = ctx.measure("frozen", "urb_frozen", "freeze", dist,
+                                      n, n, [&]() {
+                f = urb_tree_freeze(&urb, sizeof(long), 0);
+            });
+            r.metrics.push_back(std::make_pair("bytes", 
+                                   (double)((f->n+1)*(sizeof(long)+
+                                                      sizeof(void*)))));
+            double t = ctx.measure("frozen", "urb_tree", "find", dist, 
+                                   n, n, [&]() {
+                for (i = 0; i < n; ++i) 
+                    hits[0] += urb_tree_find(&urb, &stream[i], compare_long)
+                               != &urb_sentinel;
+            }).seconds;
+            result_t &g = ctx.measure("frozen", "urb_frozen", "find", dist, 
+                                      n, n, [&]() {
+                for (i = 0; i < n; ++i) 
+                    hits[1] += urb_frozen_find(f, &stream[i], compare_long)
+                               != 0;
+            });
+            g.metrics.push_back(std::make_pair("speedup", t/g.seconds));
+            result_t &k = ctx.measure("frozen", "urb_frozen", "find_int64", 
+                                      dist, n, n, [&]() {
+                for (i = 0; i < n; ++i) 
+                    hits[2] += urb_frozen_find_int64(f, stream[i]) != 0;
+            });
+            k.metrics.push_back(std::make_pair("speedup", t/k.seconds));
+            result_t &b = ctx.measure("frozen", "urb_frozen", 
+                                      "find_int64_batch", dist, n, n, [&]() {
+                urb_frozen_find_int64_batch(f, (int64_t*)&stream[0], n, 
+                                            &results[0]);
+                for (i = 0; i < n; ++i) hits[3] += results[i] != 0;
+            });
+            b.metrics.push_back(std::make_pair("speedup", t/b.seconds));
+            /// Full in-order scan.
+            t = ctx.measure("frozen", "urb_tree", "scan", dist, n, n, [&]() {
+                for (it = urb_tree_min(&urb); 
+                     it != NULL && it != &urb_sentinel; it = urb_tree_succ(it))
+                    sum[0] += *(long*)it->key;
+            }).seconds;
+            result_t &c = ctx.measure("frozen", "urb_frozen", "scan", dist, 
+                                      n, n, [&]() {
+                for (j = urb_frozen_min(f); j; j = urb_frozen_succ(f, j))
+                    sum[1] += *(long*)urb_frozen_key(f, j);
+            });
+            c.metrics.push_back(std::make_pair("speedup", t/c.seconds));
+            if (hits[0] != n || hits[1] != n || hits[2] != n || 
+                hits[3] != n || sum[0] != sum[1]) 
+                fprintf(stderr, "... [frozen] unexpected results.\n");
+            urb_frozen_delete(f);
+            urb_tree_delete(&urb, NULL, NULL);
+        }
+    }
+}
@@ -0,0 +1,91 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file bench/src/hash_bench.cc
+/// @author Issam SAID
+/// @brief Benchmark the hybrid hash index on point lookups and scans mixes.
+/// @details Each operation is either a point lookup of a present key or, 
+/// with a given ratio, an ordered scan of 64 keys starting at a present 
+/// key. The mix is run on a plain tree (urb_tree_find) and on a hybrid 
+/// index (urb_hash_find), the scans walk the tree with urb_tree_succ in 
+/// both cases.
+///
+#include <urb_tree/urb_tree.h>
+#include "bench.h"
+
+using namespace urb_bench;
+
+namespace {
+
+    uint64_t hash_long(void *a) { return (uint64_t)*(long*)a; }
+
+}  // namespace
+
+URB_BENCH(hash) {
+    const unsigned scans[] = { 0, 1, 10, 50 };
+    for (size_t s = 0; s < ctx.cfg.sizes.size(); ++s) {
+        size_t n = ctx.cfg.sizes[s], i;
+        std::vector<long> keys = key_order(RANDOM, n, ctx.cfg);
+        std::vector<long> probe(n);
+        urb_t *urb = &urb_sentinel;
+        urb_hash_t hash;
+        rng_t rng(ctx.cfg.seed);
+        urb_hash_init(&hash, n, hash_long);
+        for (i = 0; i < n; ++i) {
+            urb_tree_put(&urb, urb_tree_create(&keys[i], NULL), compare_long);
+            urb_hash_put(&hash, urb_tree_create(&keys[i], NULL), 
+                         compare_long);
+            probe[i] = keys[rng.next() % n];
+        }
+        for (size_t m = 0; m < sizeof(scans)/sizeof(scans[0]); ++m) {
+            std::string op = "scan" + std::to_string(scans[m]) + "pct";
+            size_t sum[2] = {0, 0};
+            for (int hybrid = 0; hybrid < 2; ++hybrid) {
+                ctx.measure("hash", hybrid ? "urb_hash" : "urb_tree", op, 
+                            RANDOM, n, n, [&]() {
+                    for (i = 0; i < n; ++i) {
+                        urb_t *x = hybrid ? 
+                            urb_hash_find(&hash, &probe[i], compare_long) :
+                            urb_tree_find(&urb, &probe[i], compare_long);
+                        if (i % 100 < scans[m]) {
+                            for (int k = 0; k < 64 && x != NULL && 
+                                 x != &urb_sentinel; ++k, x = urb_tree_succ(x))
+                                sum[hybrid]++;
+                        } else {
+                            sum[hybrid] += x != &urb_sentinel;
+                        }
+                    }
+                });
+            }
+            if (sum[0] != sum[1]) 
+                fprintf(stderr, "... [hash] unexpected number of hits.\n");
+        }
+        urb_hash_delete(&hash, NULL, NULL);
+        urb_tree_delete(&urb, NULL, NULL);
+    }
+}
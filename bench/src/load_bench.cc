@@ -0,0 +1,90 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file bench/src/load_bench.cc
+/// @author Issam SAID
+/// @brief Benchmark the bulk loading of unsorted records from a file.
+/// @details The records (a long key and a long value) are written in 
+/// random order to a temporary file. The file is then loaded by reading 
+/// all the records and putting them one by one with urb_tree_put, and with 
+/// urb_tree_load given an eighth of the input as memory for the runs. The 
+/// times of the phases of the loader are reported as extra metrics.
+///
+#include <urb_tree/urb_tree.h>
+#include "bench.h"
+
+using namespace urb_bench;
+
+namespace {
+
+    typedef struct { long key; long value; } record_t;
+
+}  // namespace
+
+URB_BENCH(load) {
+    for (size_t s = 0; s < ctx.cfg.sizes.size(); ++s) {
+        size_t n = ctx.cfg.sizes[s], i;
+        std::vector<long> keys = key_order(RANDOM, n, ctx.cfg);
+        std::vector<record_t> records(n);
+        FILE *f = tmpfile();
+        if (f == NULL) return;
+        for (i = 0; i < n; ++i) {
+            record_t r = { keys[i], (long)i };
+            fwrite(&r, sizeof(r), 1, f);
+        }
+        urb_t *urb = &urb_sentinel;
+        rewind(f);
+        ctx.measure("load", "urb_tree_put", "load", RANDOM, n, n, [&]() {
+            size_t m = fread(records.data(), sizeof(record_t), n, f);
+            for (i = 0; i < m; ++i) 
+                urb_tree_put(&urb, urb_tree_create(&records[i], NULL), 
+                             compare_long);
+        });
+        urb_tree_delete(&urb, NULL, NULL);
+        rewind(f);
+        urb_load_t load;
+        urb_load_config_t config = { sizeof(record_t), 
+                                     n*sizeof(record_t)/8 + 1, 
+                                     ctx.cfg.threads, NULL, compare_long };
+        result_t &r = ctx.measure("load", "urb_tree_load", "load", RANDOM, 
+                                  n, n, [&]() {
+            urb_tree_load(&urb, f, &config, &load);
+        });
+        r.metrics.push_back(std::make_pair("runs", (double)load.runs));
+        r.metrics.push_back(std::make_pair("read_s",  load.read));
+        r.metrics.push_back(std::make_pair("sort_s",  load.sort));
+        r.metrics.push_back(std::make_pair("spill_s", load.spill));
+        r.metrics.push_back(std::make_pair("merge_s", load.merge));
+        r.metrics.push_back(std::make_pair("build_s", load.build));
+        if (load.n != n) 
+            fprintf(stderr, "... [load] unexpected number of records.\n");
+        urb_tree_delete(&urb, NULL, NULL);
+        free(load.records);
+        fclose(f);
+    }
+}
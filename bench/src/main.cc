@@ -0,0 +1,180 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file bench/src/main.cc
+/// @author Issam SAID
+/// @brief Main method for benchmarking the urb_tree manipulation routines.
+/// 
+/// @details The benchmarks are run for every size and key distribution 
+/// given on the command line and the results are written as JSON in order 
+/// to be tracked over time:
+///
+///     urb_tree_bench [--sizes=1000,1000000] [--dists=random,zipfian]
+///                    [--filter=core] [--seed=42] [--theta=0.99]
+///                    [--threads=8] [--out=results.json] [--list]
+///
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <cstdio>
+#include <string>
+#include <sstream>
+#include "bench.h"
+
+using namespace urb_bench;
+
+static void usage(const char *prog) {
+    fprintf(stderr, 
+            "usage: %s [--sizes=N,...] [--dists=sequential,random,zipfian,"
+            "adversarial]\n"
+            "       [--filter=SUBSTRING] [--seed=S] [--theta=T] [--threads=N]"
+            " [--out=FILE] [--list]\n", prog);
+}
+
+static bool parse_dist(const std::string &s, dist_t *dist) {
+    dist_t all[] = { SEQUENTIAL, RANDOM, ZIPFIAN, ADVERSARIAL };
+    for (int i = 0; i < 4; ++i) {
+        if (s == dist_name(all[i])) { *dist = all[i]; return true; }
+    }
+    return false;
+}
+
+static void json_string(FILE *f, const std::string &s) {
+    fputc('"', f);
+    for (size_t i = 0; i < s.size(); ++i) {
+        if (s[i] == '"' || s[i] == '\\') fputc('\\', f);
+        fputc(s[i], f);
+    }
+    fputc('"', f);
+}
+
+static void json_counter(FILE *f, const char *name, long long value) {
+    if (value < 0) fprintf(f, ", \"%s\": null", name);
+    else           fprintf(f, ", \"%s\": %lld", name, value);
+}
+
+static void write_json(FILE *f, const config_t &cfg, 
+                       const std::vector<result_t> &results) {
+    fprintf(f, "{\n  \"suite\": \"urb_tree_bench\",\n  \"config\": {");
+    fprintf(f, "\"seed\": %llu, \"zipf_theta\": %g, \"threads\": %d, "
+               "\"sizes\": [", (unsigned long long)cfg.seed, cfg.zipf_theta,
+               cfg.threads);
+    for (size_t i = 0; i < cfg.sizes.size(); ++i) 
+        fprintf(f, "%s%zu", i ? ", " : "", cfg.sizes[i]);
+    fprintf(f, "]},\n  \"results\": [");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const result_t &r = results[i];
+        double ns = r.ops ? 1e9*r.seconds/r.ops : 0.0;
+        fprintf(f, "%s\n    {\"bench\": ", i ? "," : "");
+        json_string(f, r.bench);
+        fprintf(f, ", \"impl\": ");  json_string(f, r.impl);
+        fprintf(f, ", \"op\": ");    json_string(f, r.op);
+        fprintf(f, ", \"dist\": ");  json_string(f, r.dist);
+        fprintf(f, ", \"n\": %zu, \"ops\": %zu, \"seconds\": %.9f, "
+                   "\"ns_per_op\": %.3f, \"ops_per_sec\": %.1f", 
+                r.n, r.ops, r.seconds, ns, 
+                r.seconds > 0 ? r.ops/r.seconds : 0.0);
+        json_counter(f, "cache_misses",  r.cache_misses);
+        json_counter(f, "branch_misses", r.branch_misses);
+        fprintf(f, ", \"rss_peak_kb\": %ld", r.rss_peak_kb);
+        for (size_t j = 0; j < r.metrics.size(); ++j) {
+            fprintf(f, ", ");
+            json_string(f, r.metrics[j].first);
+            fprintf(f, ": %.6g", r.metrics[j].second);
+        }
+        fprintf(f, "}");
+    }
+    fprintf(f, "\n  ]\n}\n");
+}
+
+int main(int argc, char **argv) {
+    config_t cfg;
+    std::string out;
+    bool list = false;
+    cfg.seed       = 42;
+    cfg.zipf_theta = 0.99;
+    cfg.threads    = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    for (int i = 1; i < argc; ++i) {
+        std::string arg(argv[i]), item;
+        std::string val = arg.find('=') == std::string::npos ? 
+                          "" : arg.substr(arg.find('=')+1);
+        std::stringstream ss(val);
+        if (arg.compare(0, 8, "--sizes=") == 0) {
+            while (std::getline(ss, item, ',')) 
+                cfg.sizes.push_back(strtoull(item.c_str(), NULL, 10));
+        } else if (arg.compare(0, 8, "--dists=") == 0) {
+            dist_t dist;
+            while (std::getline(ss, item, ',')) {
+                if (!parse_dist(item, &dist)) { usage(argv[0]); return 1; }
+                cfg.dists.push_back(dist);
+            }
+        } else if (arg.compare(0, 9, "--filter=") == 0) {
+            cfg.filter = val;
+        } else if (arg.compare(0, 7, "--seed=") == 0) {
+            cfg.seed = strtoull(val.c_str(), NULL, 10);
+        } else if (arg.compare(0, 8, "--theta=") == 0) {
+            cfg.zipf_theta = atof(val.c_str());
+        } else if (arg.compare(0, 10, "--threads=") == 0) {
+            cfg.threads = atoi(val.c_str());
+        } else if (arg.compare(0, 6, "--out=") == 0) {
+            out = val;
+        } else if (arg == "--list") {
+            list = true;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (cfg.sizes.empty()) {
+        size_t sizes[] = { 1000, 10000, 100000, 1000000 };
+        cfg.sizes.assign(sizes, sizes+4);
+    }
+    if (cfg.dists.empty()) {
+        dist_t dists[] = { SEQUENTIAL, RANDOM, ZIPFIAN, ADVERSARIAL };
+        cfg.dists.assign(dists, dists+4);
+    }
+    if (cfg.threads < 1) cfg.threads = 1;
+
+    context_t ctx(cfg);
+    for (size_t i = 0; i < registry().size(); ++i) {
+        const entry_t &e = registry()[i];
+        if (list) { printf("%s\n", e.name); continue; }
+        if (!cfg.filter.empty() && 
+            std::string(e.name).find(cfg.filter) == std::string::npos) 
+            continue;
+        fprintf(stderr, "... Running %s.\n", e.name);
+        e.fn(ctx);
+    }
+    if (list) return 0;
+
+    FILE *f = out.empty() ? stdout : fopen(out.c_str(), "w");
+    if (f == NULL) { perror(out.c_str()); return 1; }
+    write_json(f, cfg, ctx.results());
+    if (f != stdout) fclose(f);
+    return 0;
+}
@@ -0,0 +1,114 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file bench/src/pool_bench.cc
+/// @author Issam SAID
+/// @brief Benchmark the index-based node pools against urb_tree.
+/// @details The same random keys are put in a pool and in a Red-Black tree
+/// (whose keys are stored in an array), then looked up in random order. 
+/// The memory per key is the node plus, for urb_tree, the key it points to.
+/// A last lookup pass is run on a pool whose nodes take 10 times the last 
+/// level cache, whatever the configured sizes. The pool implementation is 
+/// named urb_pool_split when built with the hot/cold split.
+///
+#include <unistd.h>
+#include <urb_tree/urb_tree.h>
+#include "bench.h"
+
+using namespace urb_bench;
+
+namespace {
+
+#ifdef __URB_TREE_POOL_SPLIT
+    const char  *pool_impl = "urb_pool_split";
+    const size_t pool_node = sizeof(urb_pnode_t) + sizeof(urb_pcold_t);
+#else
+    const char  *pool_impl = "urb_pool";
+    const size_t pool_node = sizeof(urb_pnode_t);
+#endif
+
+    size_t llc_size() {
+        long llc = sysconf(_SC_LEVEL3_CACHE_SIZE);
+        return llc > 0 ? (size_t)llc : (size_t)32 << 20;
+    }
+
+}  // namespace
+
+URB_BENCH(pool) {
+    for (size_t s = 0; s < ctx.cfg.sizes.size(); ++s) {
+        size_t n = ctx.cfg.sizes[s], i, found[2] = {0, 0};
+        std::vector<long> keys = key_order(RANDOM, n, ctx.cfg);
+        std::vector<long> probe = key_order(RANDOM, n, ctx.cfg);
+        urb_t *urb = &urb_sentinel;
+        urb_pool_t pool;
+        urb_pool_init(&pool, 0);
+        ctx.measure("pool", "urb_tree", "put", RANDOM, n, n, [&]() {
+            for (i = 0; i < n; ++i) 
+                urb_tree_put(&urb, urb_tree_create(&keys[i], NULL), 
+                             compare_long);
+        });
+        ctx.measure("pool", pool_impl, "put", RANDOM, n, n, [&]() {
+            for (i = 0; i < n; ++i) urb_pool_put(&pool, keys[i], i);
+        });
+        result_t &r = ctx.measure("pool", "urb_tree", "find", RANDOM, n, n, 
+                                  [&]() {
+            for (i = 0; i < n; ++i) 
+                found[0] += urb_tree_find(&urb, &probe[i], compare_long) 
+                            != &urb_sentinel;
+        });
+        r.metrics.push_back(std::make_pair("bytes_per_node", 
+                                           (double)(sizeof(urb_t) + 
+                                                    sizeof(long))));
+        result_t &p = ctx.measure("pool", pool_impl, "find", RANDOM, n, n, 
+                                  [&]() {
+            for (i = 0; i < n; ++i) 
+                found[1] += urb_pool_find(&pool, probe[i]) != 0;
+        });
+        p.metrics.push_back(std::make_pair("bytes_per_node", 
+                                           (double)pool_node));
+        p.metrics.push_back(std::make_pair("bytes_per_node_allocated", 
+                                           (double)pool.capacity*
+                                           pool_node/n));
+        if (found[0] != n || found[1] != n) 
+            fprintf(stderr, "... [pool] unexpected number of hits.\n");
+        urb_pool_delete(&pool);
+        urb_tree_delete(&urb, NULL, NULL);
+    }
+    /// The working set of 10 times the last level cache.
+    size_t n = 10*llc_size()/pool_node, i, found = 0;
+    std::vector<long> keys = key_order(RANDOM, n, ctx.cfg);
+    urb_pool_t pool;
+    urb_pool_init(&pool, (uint32_t)n);
+    for (i = 0; i < n; ++i) urb_pool_put(&pool, keys[i], i);
+    keys = key_order(RANDOM, n, ctx.cfg);
+    ctx.measure("pool", pool_impl, "find_10x_llc", RANDOM, n, n, [&]() {
+        for (i = 0; i < n; ++i) found += urb_pool_find(&pool, keys[i]) != 0;
+    });
+    if (found != n) fprintf(stderr, "... [pool] unexpected number of hits.\n");
+    urb_pool_delete(&pool);
+}
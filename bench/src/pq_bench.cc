@@ -0,0 +1,132 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file bench/src/pq_bench.cc
+/// @author Issam SAID
+/// @brief Benchmark the priority queue mode against a binary heap.
+/// @details An event scheduler holds n events, each tick takes the earliest
+/// one and schedules a new event at a random delay after it. The ticks are
+/// run with urb_tree_min followed by urb_tree_pop (the plain tree), with 
+/// urb_tree_pop_min (the priority queue mode) and with a std::priority_queue.
+/// The queues are then drained (without scheduling), which isolates the 
+/// removal of the earliest event. The event times are unique: the time is 
+/// in the high bits and the event number in the low bits.
+///
+#include <queue>
+#include <functional>
+#include <urb_tree/urb_tree.h>
+#include "bench.h"
+
+using namespace urb_bench;
+
+namespace {
+
+    const int EVENT_BITS = 27;
+
+    ///
+    /// @brief The time of the event i, scheduled after the event at now.
+    ///
+    inline long schedule(long now, size_t i, const std::vector<long> &delay) {
+        return (((now >> EVENT_BITS) + delay[i]) << EVENT_BITS) | (long)i;
+    }
+
+}  // namespace
+
+URB_BENCH(pq) {
+    for (size_t s = 0; s < ctx.cfg.sizes.size(); ++s) {
+        size_t n = ctx.cfg.sizes[s], i;
+        rng_t  rng(ctx.cfg.seed);
+        std::vector<long> delay(2*n), events(2*n);
+        long check[3] = {0, 0, 0};
+        double t;
+        for (i = 0; i < 2*n; ++i) delay[i] = 1 + rng.next() % n;
+        for (i = 0; i < n; ++i) events[i] = schedule(0, i, delay);
+
+        urb_t *urb = &urb_sentinel, *e;
+        for (i = 0; i < n; ++i) 
+            urb_tree_put(&urb, urb_tree_create(&events[i], NULL), 
+                         compare_long);
+        t = ctx.measure("pq", "urb_tree", "tick", RANDOM, n, n, [&]() {
+            for (i = n; i < 2*n; ++i) {
+                e = urb_tree_pop(&urb, urb_tree_min(&urb)->key, compare_long);
+                events[i] = schedule(*(long*)e->key, i, delay);
+                check[0] += *(long*)e->key >> EVENT_BITS;
+                urb_tree_release(e);
+                urb_tree_put(&urb, urb_tree_create(&events[i], NULL), 
+                             compare_long);
+            }
+        }).seconds;
+        double d = ctx.measure("pq", "urb_tree", "drain", RANDOM, n, n, [&]() {
+            for (i = 0; i < n; ++i) 
+                urb_tree_release(urb_tree_pop(&urb, urb_tree_min(&urb)->key, 
+                                              compare_long));
+        }).seconds;
+
+        urb_pq_t pq;
+        urb_pq_init(&pq);
+        for (i = 0; i < n; ++i) 
+            urb_pq_put(&pq, urb_tree_create(&events[i], NULL), compare_long);
+        result_t &r = ctx.measure("pq", "urb_pq", "tick", RANDOM, n, n, 
+                                  [&]() {
+            for (i = n; i < 2*n; ++i) {
+                e = urb_tree_pop_min(&pq);
+                events[i] = schedule(*(long*)e->key, i, delay);
+                check[1] += *(long*)e->key >> EVENT_BITS;
+                urb_tree_release(e);
+                urb_pq_put(&pq, urb_tree_create(&events[i], NULL), 
+                           compare_long);
+            }
+        });
+        r.metrics.push_back(std::make_pair("speedup", t/r.seconds));
+        result_t &rd = ctx.measure("pq", "urb_pq", "drain", RANDOM, n, n, 
+                                   [&]() {
+            for (i = 0; i < n; ++i) urb_tree_release(urb_tree_pop_min(&pq));
+        });
+        rd.metrics.push_back(std::make_pair("speedup", d/rd.seconds));
+
+        std::priority_queue<long, std::vector<long>, std::greater<long> > h;
+        for (i = 0; i < n; ++i) h.push(schedule(0, i, delay));
+        result_t &b = ctx.measure("pq", "std::priority_queue", "tick", 
+                                  RANDOM, n, n, [&]() {
+            for (i = n; i < 2*n; ++i) {
+                long now = h.top();
+                h.pop();
+                check[2] += now >> EVENT_BITS;
+                h.push(schedule(now, i, delay));
+            }
+        });
+        b.metrics.push_back(std::make_pair("speedup", t/b.seconds));
+        result_t &bd = ctx.measure("pq", "std::priority_queue", "drain", 
+                                   RANDOM, n, n, [&]() {
+            for (i = 0; i < n; ++i) h.pop();
+        });
+        bd.metrics.push_back(std::make_pair("speedup", d/bd.seconds));
+        if (check[0] != check[1] || check[0] != check[2]) 
+            fprintf(stderr, "... [pq] the schedules differ.\n");
+    }
+}
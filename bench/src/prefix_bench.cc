@@ -0,0 +1,143 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file bench/src/prefix_bench.cc
+/// @author Issam SAID
+/// @brief Benchmark the key prefixes on string keys.
+/// @details Three key sets are used: random words, UUIDs (hexadecimal 
+/// strings) and URLs, which share a long common prefix so that all the 
+/// prefixes tie (the worst case). The same tree, filled with 
+/// urb_tree_put_prefixed, is queried with urb_tree_find (strcmp at each 
+/// level) and with urb_tree_find_prefixed. The comparator calls per lookup
+/// are counted in an extra untimed pass. The prefixes are only used when 
+/// the library is configured with -Durb_tree_prefix=ON.
+///
+#include <string.h>
+#include <string>
+#include <urb_tree/urb_tree.h>
+#include "bench.h"
+
+using namespace urb_bench;
+
+namespace {
+
+    size_t calls = 0;
+
+    int compare_string(void *a, void *b) { 
+        return strcmp((char*)a, (char*)b); 
+    }
+
+    int count_string(void *a, void *b) { 
+        calls++; 
+        return strcmp((char*)a, (char*)b); 
+    }
+
+    std::vector<std::string> make_keys(const std::string &set, size_t n, 
+                                       rng_t &rng) {
+        static const char hex[] = "0123456789abcdef";
+        std::vector<std::string> keys;
+        std::string k;
+        while (keys.size() < n) {
+            size_t i = keys.size();
+            k.clear();
+            if (set == "words") {
+                size_t len = 5 + rng.next() % 16;
+                for (size_t j = 0; j < len; ++j) k += 'a' + rng.next() % 26;
+                k += std::to_string(i);
+            } else if (set == "uuids") {
+                for (size_t j = 0; j < 32; ++j) k += hex[rng.next() % 16];
+            } else {
+                k  = "https://www.example.com/catalog/";
+                k += std::to_string(rng.next() % 1000) + "/item/";
+                k += std::to_string(i);
+            }
+            keys.push_back(k);
+        }
+        return keys;
+    }
+
+}  // namespace
+
+URB_BENCH(prefix) {
+    const char *sets[] = { "words", "uuids", "urls" };
+    for (size_t s = 0; s < ctx.cfg.sizes.size(); ++s) {
+        for (size_t d = 0; d < 3; ++d) {
+            size_t n = ctx.cfg.sizes[s];
+            rng_t  rng(ctx.cfg.seed);
+            std::vector<std::string> keys = make_keys(sets[d], n, rng);
+            std::vector<long> stream = access_stream(RANDOM, n, n, ctx.cfg);
+            std::vector<void*> lookups(n);
+            urb_t *urb = &urb_sentinel;
+            size_t found[2] = {0, 0}, i;
+            std::string suffix = std::string("_") + sets[d];
+            for (i = 0; i < n; ++i) {
+                void *k = (void*)keys[i].c_str();
+                /// Duplicates (unlikely for words and uuids) are skipped.
+                if (urb_tree_find(&urb, k, compare_string) != &urb_sentinel) 
+                    continue;
+                urb_tree_put_prefixed(&urb, urb_tree_create(k, k), 
+                                      urb_tree_prefix_string, compare_string);
+            }
+            for (i = 0; i < n; ++i) 
+                lookups[i] = (void*)keys[stream[i]/2].c_str();
+            double t = ctx.measure("prefix", "urb_tree", "find" + suffix, 
+                                   RANDOM, n, n, [&]() {
+                for (i = 0; i < n; ++i) 
+                    found[0] += urb_tree_find(&urb, lookups[i], 
+                                              compare_string) != &urb_sentinel;
+            }).seconds;
+            result_t &r = ctx.measure("prefix", "urb_tree_prefixed", 
+                                      "find" + suffix, RANDOM, n, n, [&]() {
+                for (i = 0; i < n; ++i) 
+                    found[1] += urb_tree_find_prefixed(&urb, lookups[i], 
+                                    urb_tree_prefix_string, compare_string)
+                                != &urb_sentinel;
+            });
+            r.metrics.push_back(std::make_pair("speedup", t/r.seconds));
+            calls = 0;
+            for (i = 0; i < n; ++i) 
+                urb_tree_find(&urb, lookups[i], count_string);
+            r.metrics.push_back(std::make_pair("compares_per_op_plain", 
+                                               (double)calls/n));
+            calls = 0;
+            for (i = 0; i < n; ++i) 
+                urb_tree_find_prefixed(&urb, lookups[i], 
+                                       urb_tree_prefix_string, count_string);
+            r.metrics.push_back(std::make_pair("compares_per_op", 
+                                               (double)calls/n));
+#ifdef __URB_TREE_PREFIX
+            r.metrics.push_back(std::make_pair("prefix_enabled", 1.));
+#else
+            r.metrics.push_back(std::make_pair("prefix_enabled", 0.));
+#endif
+            if (found[0] != n || found[1] != n) 
+                fprintf(stderr, "... [prefix] unexpected number of hits.\n");
+            urb_tree_delete(&urb, NULL, NULL);
+        }
+    }
+}
@@ -0,0 +1,110 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file bench/src/relaxed_bench.cc
+/// @author Issam SAID
+/// @brief Benchmark the relaxed balancing on write bursts.
+/// @details A burst puts n keys in an empty tree, either with urb_tree_put
+/// or in a relaxed session with a budget of 0, 1 or 2 fix-up steps per 
+/// insertion, then the tree is probed with random lookups before the 
+/// remaining violations are fixed (urb_tree_rebalance) and after. The 
+/// height at the end of the burst and the number of fix-up steps are 
+/// reported. The budgets 0 and 1 are only run on random keys, they fall 
+/// behind with sorted keys and the burst then builds a list.
+///
+#include <urb_tree/urb_tree.h>
+#include "bench.h"
+
+using namespace urb_bench;
+
+namespace {
+
+    size_t height(urb_t *n) {
+        if (n == &urb_sentinel) return 0;
+        return 1 + std::max(height(n->left), height(n->right));
+    }
+
+}  // namespace
+
+URB_BENCH(relaxed) {
+    const dist_t dists[] = { SEQUENTIAL, RANDOM };
+    const char *impls[] = { "urb_tree", "relaxed_b0", "relaxed_b1", 
+                            "relaxed_b2" };
+    for (size_t s = 0; s < ctx.cfg.sizes.size(); ++s) {
+        size_t n = ctx.cfg.sizes[s], i;
+        std::vector<long> probe(n);
+        rng_t rng(ctx.cfg.seed);
+        for (i = 0; i < n; ++i) probe[i] = key_of(rng.next() % n);
+        for (size_t o = 0; o < sizeof(dists)/sizeof(dists[0]); ++o) {
+            std::vector<long> keys = key_order(dists[o], n, ctx.cfg);
+            for (int m = 0; m < 4; ++m) {
+                if (m && m < 3 && dists[o] == SEQUENTIAL) continue;
+                urb_t *urb = &urb_sentinel;
+                urb_relaxed_t relaxed;
+                size_t hits = 0;
+                urb_relaxed_begin(&relaxed, &urb, m ? m - 1 : 0);
+                result_t &burst = 
+                    ctx.measure("relaxed", impls[m], "burst", dists[o], n, n,
+                                [&]() {
+                    for (i = 0; i < n; ++i) {
+                        urb_t *x = urb_tree_create(&keys[i], NULL);
+                        if (m) urb_relaxed_put(&relaxed, x, compare_long);
+                        else   urb_tree_put(&urb, x, compare_long);
+                    }
+                });
+                burst.metrics.push_back(
+                    std::make_pair("height", (double)height(urb)));
+                burst.metrics.push_back(
+                    std::make_pair("steps", (double)relaxed.steps));
+                ctx.measure("relaxed", impls[m], "find_burst", dists[o], n, n,
+                            [&]() {
+                    for (i = 0; i < n; ++i) 
+                        hits += urb_tree_find(&urb, &probe[i], compare_long) 
+                                != &urb_sentinel;
+                });
+                size_t steps = relaxed.steps;
+                ctx.measure("relaxed", impls[m], "rebalance", dists[o], n, n,
+                            [&]() { urb_tree_rebalance(&relaxed); })
+                    .metrics.push_back(
+                        std::make_pair("steps", 
+                                       (double)(relaxed.steps - steps)));
+                ctx.measure("relaxed", impls[m], "find", dists[o], n, n, 
+                            [&]() {
+                    for (i = 0; i < n; ++i) 
+                        hits += urb_tree_find(&urb, &probe[i], compare_long) 
+                                != &urb_sentinel;
+                });
+                if (hits != 2*n) 
+                    fprintf(stderr, 
+                            "... [relaxed] unexpected number of hits.\n");
+                urb_relaxed_end(&relaxed);
+                urb_tree_delete(&urb, NULL, NULL);
+            }
+        }
+    }
+}
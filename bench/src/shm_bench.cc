@@ -0,0 +1,95 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file bench/src/shm_bench.cc
+/// @author Issam SAID
+/// @brief Benchmark the shared trees: attaching against building a copy.
+/// @details n random keys are put in a shared tree (a POSIX shared memory
+/// object). The startup of a worker that needs the tree is then timed 
+/// three ways: building its own Red-Black tree, loading a saved pool and 
+/// attaching the shared tree; the startup results are for one worker 
+/// (ops = 1). Random lookups are timed through the shared lock and on a 
+/// private pool.
+///
+#include <string>
+#include <unistd.h>
+#include <urb_tree/urb_tree.h>
+#include "bench.h"
+
+using namespace urb_bench;
+
+URB_BENCH(shm) {
+    std::string name = "/urb_shm_bench_" + std::to_string(getpid());
+    char path[] = "/tmp/urb_shm_bench_XXXXXX";
+    int fd = mkstemp(path);
+    close(fd);
+    for (size_t s = 0; s < ctx.cfg.sizes.size(); ++s) {
+        size_t n = ctx.cfg.sizes[s], i, found[2] = {0, 0};
+        std::vector<long> keys = key_order(RANDOM, n, ctx.cfg);
+        std::vector<long> probe = key_order(RANDOM, n, ctx.cfg);
+        urb_t *urb = &urb_sentinel;
+        urb_pool_t pool;
+        urb_shm_t shm, worker;
+        urb_shm_create(&shm, name.c_str(), (uint32_t)n, 0);
+        urb_pool_init(&pool, (uint32_t)n);
+        for (i = 0; i < n; ++i) {
+            urb_shm_put(&shm, keys[i], i, NULL);
+            urb_pool_put(&pool, keys[i], i);
+        }
+        urb_pool_save(&pool, path);
+        urb_pool_delete(&pool);
+        ctx.measure("shm", "urb_tree", "startup", RANDOM, n, 1, [&]() {
+            for (i = 0; i < n; ++i) 
+                urb_tree_put(&urb, urb_tree_create(&keys[i], NULL), 
+                             compare_long);
+        });
+        ctx.measure("shm", "urb_pool_load", "startup", RANDOM, n, 1, [&]() {
+            urb_pool_load(&pool, path);
+        });
+        ctx.measure("shm", "urb_shm", "startup", RANDOM, n, 1, [&]() {
+            urb_shm_attach(&worker, name.c_str());
+        }).metrics.push_back(std::make_pair("segment_bytes", 
+                                            (double)worker.length));
+        ctx.measure("shm", "urb_pool", "find", RANDOM, n, n, [&]() {
+            for (i = 0; i < n; ++i) 
+                found[0] += urb_pool_find(&pool, probe[i]) != 0;
+        });
+        ctx.measure("shm", "urb_shm", "find", RANDOM, n, n, [&]() {
+            for (i = 0; i < n; ++i) 
+                found[1] += urb_shm_find(&worker, probe[i], NULL, NULL);
+        });
+        if (found[0] != n || found[1] != n) 
+            fprintf(stderr, "... [shm] unexpected number of hits.\n");
+        urb_shm_detach(&worker);
+        urb_shm_detach(&shm);
+        urb_shm_unlink(name.c_str());
+        urb_pool_delete(&pool);
+        urb_tree_delete(&urb, NULL, NULL);
+    }
+    unlink(path);
+}
@@ -0,0 +1,125 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file bench/src/vlog_bench.cc
+/// @author Issam SAID
+/// @brief Benchmark the value logs: resident memory against read latency.
+/// @details n keys with values of VALUE_SIZE bytes are put in a tree, 
+/// either with the values on the heap (the node points to a copy) or in a 
+/// value log whose residency budget is a fraction of the log. Random reads
+/// (a lookup then a pass over the value) are timed and the current RSS is
+/// reported after the reads. Half of the keys are then popped and the log
+/// is compacted.
+///
+#include <cstring>
+#include <unistd.h>
+#include <urb_tree/urb_tree.h>
+#include "bench.h"
+
+using namespace urb_bench;
+
+namespace {
+
+    const size_t VALUE_SIZE = 512;
+
+    size_t sum(const unsigned char *v, size_t length) {
+        size_t s = 0;
+        for (size_t i = 0; i < length; i += 64) s += v[i];
+        return s;
+    }
+
+}  // namespace
+
+URB_BENCH(vlog) {
+    /// The budgets as fractions of the log, 0 for the heap values.
+    const size_t fractions[] = { 0, 64, 8, 1 };
+    const char  *impls[]     = { "heap", "vlog_1_64", "vlog_1_8", "vlog_1" };
+    std::vector<unsigned char> value(VALUE_SIZE, 7);
+    for (size_t s = 0; s < ctx.cfg.sizes.size(); ++s) {
+        size_t n = ctx.cfg.sizes[s], i;
+        std::vector<long> keys = key_order(RANDOM, n, ctx.cfg);
+        std::vector<long> probe(n);
+        rng_t rng(ctx.cfg.seed);
+        for (i = 0; i < n; ++i) probe[i] = key_of(rng.next() % n);
+        for (size_t f = 0; f < sizeof(fractions)/sizeof(fractions[0]); ++f) {
+            char path[] = "/tmp/urb_vlog_bench_XXXXXX";
+            int fd = mkstemp(path);
+            close(fd);
+            urb_t *urb = &urb_sentinel;
+            urb_vlog_t vlog;
+            size_t bytes = n*VALUE_SIZE, total = 0;
+            long rss = context_t::rss_current_kb();
+            if (fractions[f]) 
+                urb_vlog_open(&vlog, path, 2*bytes + (1UL << 20), 
+                              bytes / fractions[f]);
+            ctx.measure("vlog", impls[f], "put", RANDOM, n, n, [&]() {
+                for (i = 0; i < n; ++i) {
+                    if (fractions[f]) {
+                        urb_vlog_put(&vlog, &urb, &keys[i], value.data(), 
+                                     VALUE_SIZE, compare_long);
+                    } else {
+                        void *v = malloc(VALUE_SIZE);
+                        memcpy(v, value.data(), VALUE_SIZE);
+                        urb_tree_put(&urb, urb_tree_create(&keys[i], v), 
+                                     compare_long);
+                    }
+                }
+            });
+            result_t &r = 
+                ctx.measure("vlog", impls[f], "read", RANDOM, n, n, [&]() {
+                for (i = 0; i < n; ++i) {
+                    urb_t *x = urb_tree_find(&urb, &probe[i], compare_long);
+                    size_t length = VALUE_SIZE;
+                    const unsigned char *v = fractions[f] ? 
+                        (const unsigned char *)urb_vlog_value(&vlog, x, 
+                                                              &length) :
+                        (const unsigned char *)x->value;
+                    total += sum(v, length);
+                }
+            });
+            r.metrics.push_back(std::make_pair("rss_delta_kb", 
+                (double)(context_t::rss_current_kb() - rss)));
+            if (total != n*7*(VALUE_SIZE/64))
+                fprintf(stderr, "... [vlog] unexpected values.\n");
+            if (fractions[f]) {
+                ctx.measure("vlog", impls[f], "pop_half_compact", RANDOM, 
+                            n, n/2, [&]() {
+                    for (i = 0; i < n; i += 2) 
+                        urb_tree_release(urb_vlog_pop(&vlog, &urb, &keys[i],
+                                                      compare_long));
+                    urb_vlog_compact(&vlog, &urb);
+                });
+                urb_tree_delete(&urb, NULL, NULL);
+                urb_vlog_close(&vlog);
+            } else {
+                urb_tree_delete(&urb, NULL, free);
+            }
+            unlink(path);
+        }
+    }
+}
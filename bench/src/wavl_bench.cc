@@ -0,0 +1,115 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file bench/src/wavl_bench.cc
+/// @author Issam SAID
+/// @brief Benchmark the WAVL balancing against the Red-Black one.
+/// @details The same keys are put (sequential and random orders) in a 
+/// Red-Black tree and in a WAVL tree, then both are probed with random 
+/// lookups. The average depth of the nodes and the height of the trees are
+/// reported along with the latencies, before and after a churn that pops 
+/// and puts back half of the keys (the WAVL tree is then no longer an AVL 
+/// tree).
+///
+#include <urb_tree/urb_tree.h>
+#include "bench.h"
+
+using namespace urb_bench;
+
+namespace {
+
+    void depth(urb_t *n, size_t d, size_t *sum, size_t *height) {
+        if (n == &urb_sentinel) return;
+        *sum   += d;
+        *height = std::max(*height, d);
+        depth(n->left,  d + 1, sum, height);
+        depth(n->right, d + 1, sum, height);
+    }
+
+    void shape(result_t &r, urb_t *urb, size_t n) {
+        size_t sum = 0, height = 0;
+        depth(urb, 1, &sum, &height);
+        r.metrics.push_back(std::make_pair("avg_depth", (double)sum / n));
+        r.metrics.push_back(std::make_pair("height", (double)height));
+    }
+
+}  // namespace
+
+URB_BENCH(wavl) {
+    const dist_t dists[] = { SEQUENTIAL, RANDOM };
+    for (size_t s = 0; s < ctx.cfg.sizes.size(); ++s) {
+        size_t n = ctx.cfg.sizes[s], i;
+        std::vector<long> probe(n);
+        rng_t rng(ctx.cfg.seed);
+        for (i = 0; i < n; ++i) probe[i] = key_of(rng.next() % n);
+        for (size_t o = 0; o < sizeof(dists)/sizeof(dists[0]); ++o) {
+            std::vector<long> keys = key_order(dists[o], n, ctx.cfg);
+            for (int wavl = 0; wavl < 2; ++wavl) {
+                const char *impl = wavl ? "urb_wavl" : "urb_tree";
+                urb_t *urb = &urb_sentinel;
+                size_t hits = 0;
+                result_t &put = 
+                    ctx.measure("wavl", impl, "put", dists[o], n, n, [&]() {
+                    for (i = 0; i < n; ++i) {
+                        urb_t *x = urb_tree_create(&keys[i], NULL);
+                        if (wavl) urb_wavl_put(&urb, x, compare_long);
+                        else      urb_tree_put(&urb, x, compare_long);
+                    }
+                });
+                shape(put, urb, n);
+                ctx.measure("wavl", impl, "find", dists[o], n, n, [&]() {
+                    for (i = 0; i < n; ++i) 
+                        hits += urb_tree_find(&urb, &probe[i], compare_long) 
+                                != &urb_sentinel;
+                });
+                /// Pop and put back every other key.
+                result_t &churn = 
+                    ctx.measure("wavl", impl, "churn", dists[o], n, n, [&]() {
+                    for (i = 0; i < n; i += 2) {
+                        urb_t *x = wavl ? 
+                            urb_wavl_pop(&urb, &keys[i], compare_long) :
+                            urb_tree_pop(&urb, &keys[i], compare_long);
+                        x->color = red;
+                        if (wavl) urb_wavl_put(&urb, x, compare_long);
+                        else      urb_tree_put(&urb, x, compare_long);
+                    }
+                });
+                shape(churn, urb, n);
+                ctx.measure("wavl", impl, "find_churned", dists[o], n, n, 
+                            [&]() {
+                    for (i = 0; i < n; ++i) 
+                        hits += urb_tree_find(&urb, &probe[i], compare_long) 
+                                != &urb_sentinel;
+                });
+                if (hits != 2*n) 
+                    fprintf(stderr, "... [wavl] unexpected number of hits.\n");
+                urb_tree_delete(&urb, NULL, NULL);
+            }
+        }
+    }
+}
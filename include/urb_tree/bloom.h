@@ -0,0 +1,140 @@
+#ifndef __URB_TREE_BLOOM_H_
+#define __URB_TREE_BLOOM_H_
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file urb_tree/bloom.h
+/// @author Issam SAID
+/// @brief The definition of the Bloom filters in front of Red-Black trees.
+/// @details A Bloom filter answers "the key is not in the tree" without any
+/// descent nor comparator call, and "the key may be in the tree" otherwise.
+/// The filter is keyed by a user hash of the keys, and the k probes of a key 
+/// are derived from its hash by double hashing. The filter is sized for a 
+/// capacity and a target false positive rate.
+///
+/// The removals are handled in one of two ways: 
+///   - a counting filter keeps an 8-bit counter per slot, a pop decrements
+///     the counters of the key (a saturated counter is never decremented),
+///   - a plain filter keeps one bit per slot and counts the pops, the 
+///     filter is rebuilt from the tree when the popped keys reach a 
+///     quarter of the keys (URB_BLOOM_REBUILD).
+///
+/// A tree with a filter must be updated with urb_bloom_put and 
+/// urb_bloom_pop, it can be read with all the other routines.
+///
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <urb_tree/guard.h>
+#include <urb_tree/types.h>
+
+CPPGUARD_BEGIN();
+
+///
+/// @def URB_BLOOM_REBUILD
+/// @brief The ratio of popped keys that triggers the rebuild of a plain 
+///        filter.
+///
+#define URB_BLOOM_REBUILD 4
+
+///
+/// @brief The counters of a filter.
+///
+typedef struct {
+    unsigned long long queries;          ///< lookups through the filter.
+    unsigned long long negatives;        ///< lookups answered by the filter.
+    unsigned long long false_positives;  ///< lookups missed in the tree.
+    unsigned long long rebuilds;         ///< rebuilds of the filter.
+    double fp_rate;                      ///< measured false positive rate.
+    size_t memory;                       ///< bytes used by the filter.
+    double bits_per_key;                 ///< memory bits per key.
+} urb_bloom_stats_t;
+
+///
+/// @brief A Bloom filter, counting or plain.
+///
+typedef struct {
+    uint64_t  *bits;            ///< the bits of a plain filter.
+    uint8_t   *counters;        ///< the counters of a counting filter.
+    size_t     m;               ///< the number of slots (a power of 2).
+    unsigned   k;               ///< the number of probes per key.
+    size_t     n;               ///< the number of keys.
+    size_t     pops;            ///< the keys popped since the last rebuild.
+    uint64_t (*hash_key)(void*);
+    urb_bloom_stats_t stats;
+} urb_bloom_t;
+
+///
+/// @brief Initialize an empty filter for capacity keys at a given 
+///        false positive rate.
+///
+int urb_bloom_init(urb_bloom_t *bloom, size_t capacity, double fp_rate, 
+                   uint64_t (*hash_key)(void*), bool counting);
+
+///
+/// @brief Release the memory of a filter.
+///
+void urb_bloom_delete(urb_bloom_t *bloom);
+
+///
+/// @brief Insert a key/value pair into the tree and its key into the filter.
+///
+int urb_bloom_put(urb_bloom_t *bloom, urb_t **urb, urb_t *n, 
+                  int (*compare_key)(void*, void*));
+
+///
+/// @brief Find a key/value pair, the tree is only searched if the filter 
+///        may contain the key.
+///
+urb_t *urb_bloom_find(urb_bloom_t *bloom, urb_t **urb, void *key, 
+                      int (*compare_key)(void*, void*));
+
+///
+/// @brief Remove a key/value pair from the tree and the filter.
+///
+urb_t *urb_bloom_pop(urb_bloom_t *bloom, urb_t **urb, void *key, 
+                     int (*compare_key)(void*, void*));
+
+///
+/// @brief Return false if the key is not in the filter.
+///
+bool urb_bloom_contains(urb_bloom_t *bloom, void *key);
+
+///
+/// @brief Rebuild the filter from the keys of a tree.
+///
+int urb_bloom_rebuild(urb_bloom_t *bloom, urb_t **urb);
+
+///
+/// @brief Get the counters of a filter.
+///
+void urb_bloom_stats(urb_bloom_t *bloom, urb_bloom_stats_t *stats);
+
+CPPGUARD_END();
+
+#endif // __URB_TREE_BLOOM_H_
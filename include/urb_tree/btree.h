@@ -0,0 +1,160 @@
+#ifndef __URB_TREE_BTREE_H_
+#define __URB_TREE_BTREE_H_
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file urb_tree/btree.h
+/// @author Issam SAID
+/// @brief The definition of the cache-line B+tree engine for integer keys.
+/// @details The B+tree is an alternative engine to the Red-Black trees for 
+/// large indexes on 64-bit signed integer keys. Each node stores up to 
+/// URB_BTREE_ORDER sorted keys in a few 64-byte aligned cache lines, and the
+/// position of a key inside a node is computed with SIMD compares (AVX2 
+/// when the CPU supports it) instead of a comparator call per level. The 
+/// values are stored in the leaves, which are linked in both directions 
+/// so that the keys can be scanned in order.
+///
+/// The routines follow the semantics of the Red-Black tree ones: inserting
+/// an existing key is an error, find/min/max/succ/prev return a position 
+/// (a leaf and an index) that is invalid (NULL leaf) when there is no such 
+/// key, and pop removes the key and hands the value back to the caller.
+///
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <urb_tree/guard.h>
+
+CPPGUARD_BEGIN();
+
+///
+/// @def URB_BTREE_ORDER
+/// @brief The maximum number of keys per node (two cache lines of keys).
+///
+#define URB_BTREE_ORDER 16
+
+///
+/// @brief A B+tree node, inner nodes use child and leaves use value.
+///
+typedef struct urb_bnode {
+    int64_t keys[URB_BTREE_ORDER];                  ///< padded with INT64_MAX.
+    union {
+        struct urb_bnode *child[URB_BTREE_ORDER+1]; ///< count+1 children.
+        void             *value[URB_BTREE_ORDER];   ///< count values.
+    };
+    struct urb_bnode *next;                         ///< next leaf.
+    struct urb_bnode *prev;                         ///< previous leaf.
+    int count;                                      ///< number of keys.
+    int leaf;                                       ///< 1 for the leaves.
+} urb_bnode_t;
+
+///
+/// @brief The B+tree.
+///
+typedef struct {
+    urb_bnode_t *root;                              ///< never NULL.
+    size_t n;                                       ///< number of keys.
+    size_t height;                                  ///< 1 for a single leaf.
+} urb_btree_t;
+
+///
+/// @brief A position in a B+tree, invalid when leaf is NULL.
+///
+typedef struct {
+    urb_bnode_t *leaf;
+    int index;
+} urb_bpos_t;
+
+///
+/// @brief Create an empty B+tree.
+///
+urb_btree_t *urb_btree_create(void);
+
+///
+/// @brief Delete a B+tree, release_value (if not NULL) is called on values.
+///
+void urb_btree_delete(urb_btree_t *btree, void (*release_value)(void*));
+
+///
+/// @brief Insert a key/value pair into the B+tree.
+///
+int urb_btree_put(urb_btree_t *btree, int64_t key, void *value);
+
+///
+/// @brief Find a key in the B+tree.
+///
+urb_bpos_t urb_btree_find(urb_btree_t *btree, int64_t key);
+
+///
+/// @brief Remove a key from the B+tree, its value is stored in value (if 
+///        not NULL), return false if the key is not found.
+///
+bool urb_btree_pop(urb_btree_t *btree, int64_t key, void **value);
+
+///
+/// @brief Return the position of the smallest key.
+///
+urb_bpos_t urb_btree_min(urb_btree_t *btree);
+
+///
+/// @brief Return the position of the largest key.
+///
+urb_bpos_t urb_btree_max(urb_btree_t *btree);
+
+///
+/// @brief Return the position following a given one.
+///
+urb_bpos_t urb_btree_succ(urb_bpos_t pos);
+
+///
+/// @brief Return the position preceding a given one.
+///
+urb_bpos_t urb_btree_prev(urb_bpos_t pos);
+
+///
+/// @brief Return the key at a valid position.
+///
+int64_t urb_btree_key(urb_bpos_t pos);
+
+///
+/// @brief Return the value at a valid position.
+///
+void *urb_btree_value(urb_bpos_t pos);
+
+///
+/// @brief Return the number of keys of a B+tree.
+///
+size_t urb_btree_size(urb_btree_t *btree);
+
+///
+/// @brief Check the order, the fill and the depth of the leaves.
+///
+bool urb_btree_check(urb_btree_t *btree);
+
+CPPGUARD_END();
+
+#endif // __URB_TREE_BTREE_H_
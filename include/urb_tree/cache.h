@@ -0,0 +1,111 @@
+#ifndef __URB_TREE_CACHE_H_
+#define __URB_TREE_CACHE_H_
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file urb_tree/cache.h
+/// @author Issam SAID
+/// @brief The definition of the node caches of Red-Black trees.
+/// @details The nodes given back with urb_tree_release (and the nodes 
+/// released by urb_tree_delete) are kept in a free list owned by the 
+/// calling thread and reused by urb_tree_create, without any lock. A 
+/// thread cache holds at most URB_TREE_CACHE_SIZE nodes: beyond that a 
+/// batch of URB_TREE_CACHE_BATCH nodes is moved to a global pool, and an 
+/// empty thread cache takes a batch back from the pool before falling back
+/// to malloc. The pool holds at most URB_TREE_POOL_SIZE nodes, the extra
+/// nodes are freed. The cache of a thread is moved to the pool when the 
+/// thread exits.
+///
+/// A node popped with urb_tree_pop can either be released or freed, both 
+/// are valid since the cached nodes are allocated with malloc.
+///
+#include <stdio.h>
+#include <urb_tree/guard.h>
+#include <urb_tree/types.h>
+
+CPPGUARD_BEGIN();
+
+///
+/// @def URB_TREE_CACHE_SIZE
+/// @brief The maximum number of nodes cached by a thread.
+///
+#define URB_TREE_CACHE_SIZE  256
+
+///
+/// @def URB_TREE_CACHE_BATCH
+/// @brief The number of nodes moved at once between a thread and the pool.
+///
+#define URB_TREE_CACHE_BATCH 128
+
+///
+/// @def URB_TREE_POOL_SIZE
+/// @brief The maximum number of nodes kept in the global pool.
+///
+#define URB_TREE_POOL_SIZE   (1 << 16)
+
+///
+/// @brief The node cache counters of the calling thread.
+///
+typedef struct {
+    unsigned long long hits;      ///< nodes created from the cache.
+    unsigned long long misses;    ///< nodes created with malloc.
+    unsigned long long releases;  ///< nodes given back to the cache.
+    unsigned long long spills;    ///< batches moved to the pool.
+    unsigned long long refills;   ///< batches taken from the pool.
+    size_t local;                 ///< nodes in the thread cache.
+    size_t global;                ///< nodes in the global pool.
+} urb_cache_stats_t;
+
+///
+/// @brief Take a node from the caches, or allocate it if they are empty.
+///
+urb_t *urb_tree_cache_get(void);
+
+///
+/// @brief Give a node, which is no longer in a tree, back to the caches.
+///
+void urb_tree_release(urb_t *n);
+
+///
+/// @brief Move the cache of the calling thread to the global pool.
+///
+void urb_tree_cache_flush(void);
+
+///
+/// @brief Free the nodes of the global pool and of the calling thread.
+///
+void urb_tree_cache_trim(void);
+
+///
+/// @brief Read the node cache counters of the calling thread.
+///
+void urb_tree_cache_stats(urb_cache_stats_t *stats);
+
+CPPGUARD_END();
+
+#endif // __URB_TREE_CACHE_H_
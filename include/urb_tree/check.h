@@ -42,6 +42,9 @@
 ///   4. Every path from a given node to any of its descendant 
 ///      leaves contains the same number of black nodes.
 ///
+/// The WAVL trees (see wavl.h) have their own checker.
+///
+#include <stdbool.h>
 #include <urb_tree/guard.h>
 #include <urb_tree/types.h>
 
@@ -77,6 +80,13 @@ void urb_tree_check_invariant_3(urb_t **urb);
 ///
 void urb_tree_check_invariant_4(urb_t **urb);
 
+///
+/// @brief Check whether a WAVL tree satisfies its rank rules (every rank 
+///        difference is 1 or 2 and every leaf has rank 0), and whether the
+///        parent links are consistent.
+///
+bool urb_wavl_check(urb_t **urb);
+
 CPPGUARD_END();
 
 #endif // __URB_TREE_CHECK_H_
@@ -0,0 +1,141 @@
+#ifndef __URB_TREE_CHECKPOINT_H_
+#define __URB_TREE_CHECKPOINT_H_
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+///
+/// @file urb_tree/checkpoint.h
+/// @author Issam SAID
+/// @brief The definition of the incremental (delta) checkpoints of 
+///        Red-Black trees.
+/// @details A checkpointed tree is saved once in full (a base file) then 
+/// in deltas: a delta holds only the records (key_size bytes of the key 
+/// then value_size bytes of the value) put or updated since the previous 
+/// checkpoint, and the keys removed since then (tombstones). 
+///
+/// The changed nodes are flagged URB_NODE_DIRTY and their ancestors 
+/// URB_NODE_DIRTY_BELOW. The rotations (fixin.c) and the removals keep the
+/// second flag on the ancestors of every dirty node, so a delta only 
+/// descends into the subtrees holding dirty nodes: its cost follows the 
+/// changes, not the size of the tree. The records of a file are sorted by
+/// key.
+///
+/// A tree is recovered from its base file and the chain of its deltas, 
+/// applied in order (the tombstones of a delta before its records). To 
+/// bound the recovery, when the chain holds more than max_deltas deltas 
+/// they are merged into the last one, a key appears at most once in the 
+/// merged delta and the merged files are removed.
+///
+/// A file is written to path.tmp then renamed, so a chain never holds a 
+/// partial file. The marks and the tombstones are dropped once the file 
+/// is in place: after a failed write (URB_IO_ERROR) the next delta still
+/// holds all the changes.
+///
+/// The tree must only be updated with the routines below (or the values 
+/// changed in place then marked with urb_checkpoint_touch).
+///
+#include <stdio.h>
+#include <urb_tree/guard.h>
+#include <urb_tree/types.h>
+
+CPPGUARD_BEGIN();
+
+///
+/// @brief The dirty tracking and the chain of files of a tree.
+///
+typedef struct {
+    urb_t        **urb;
+    size_t         key_size;    ///< the bytes written per key.
+    size_t         value_size;  ///< the bytes written per value.
+    int          (*compare_key)(void*, void*);
+    unsigned char *tombstones;  ///< the keys removed since the checkpoint.
+    size_t         removed;     ///< the number of tombstones.
+    size_t         capacity;    ///< the capacity of tombstones (keys).
+    size_t         max_deltas;  ///< merge the deltas beyond, 0 to never.
+    char         **chain;       ///< the base file then the delta files.
+    size_t         length;      ///< the number of files in the chain.
+    size_t         deltas;      ///< the number of delta files in the chain.
+    size_t         written;     ///< the records written by the last file.
+} urb_checkpoint_t;
+
+///
+/// @brief Start tracking the changes of a tree, the records are made of 
+///        key_size and value_size bytes.
+///
+int urb_checkpoint_init(urb_checkpoint_t *checkpoint, urb_t **urb,
+                        size_t key_size, size_t value_size, 
+                        size_t max_deltas, int (*compare_key)(void*, void*));
+
+///
+/// @brief Stop tracking a tree (the files are left as is).
+///
+int urb_checkpoint_delete(urb_checkpoint_t *checkpoint);
+
+///
+/// @brief Insert a node and mark it dirty.
+///
+int urb_checkpoint_put(urb_checkpoint_t *checkpoint, urb_t *n);
+
+///
+/// @brief Remove a key/value pair and record its tombstone.
+///
+urb_t *urb_checkpoint_pop(urb_checkpoint_t *checkpoint, void *key);
+
+///
+/// @brief Mark a node dirty after changing its value in place.
+///
+void urb_checkpoint_touch(urb_checkpoint_t *checkpoint, urb_t *n);
+
+///
+/// @brief Write the whole tree to a base file, which starts a new chain.
+///
+int urb_checkpoint_base(urb_checkpoint_t *checkpoint, const char *path);
+
+///
+/// @brief Write the changes since the last checkpoint to a delta file.
+///
+int urb_checkpoint_delta(urb_checkpoint_t *checkpoint, const char *path);
+
+///
+/// @brief Merge a chain of files into one file: a base file if the chain 
+///        starts with one, a delta file otherwise.
+///
+int urb_checkpoint_merge(const char **paths, size_t n, const char *output,
+                         int (*compare_key)(void*, void*));
+
+///
+/// @brief Rebuild a tree from a base file and its deltas. Each record is 
+///        allocated in one block, the key first then the value, so the 
+///        tree is deleted with urb_tree_delete(urb, free, NULL).
+///
+int urb_checkpoint_recover(urb_t **urb, const char **paths, size_t n,
+                           int (*compare_key)(void*, void*));
+
+CPPGUARD_END();
+
+#endif // __URB_TREE_CHECKPOINT_H_
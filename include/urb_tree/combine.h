@@ -0,0 +1,130 @@
+#ifndef __URB_TREE_COMBINE_H_
+#define __URB_TREE_COMBINE_H_
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+///
+/// @file urb_tree/combine.h
+/// @author Issam SAID
+/// @brief The definition of the flat combining front end of Red-Black 
+///        trees.
+/// @details A combiner serializes the updates of a tree shared by several
+/// threads. Instead of taking a lock around each update, a thread 
+/// publishes its request (put, pop or upsert) in its own slot (one cache 
+/// line per thread) and waits. The thread that holds the combiner lock 
+/// collects all the published requests, applies them to the tree in one 
+/// pass, sorted by key when asked to (the descents of neighbor keys share
+/// the top of the tree in cache), and posts the results back in the 
+/// slots. The lock and the tree stay in the cache of the combiner, the 
+/// other threads only write their slot and spin on it.
+///
+/// Each thread uses a distinct slot id, lower than the number of slots 
+/// given to urb_combine_init. The tree must not be updated by other means 
+/// while the combiner is in use, and since the trees share the sentinel 
+/// only one tree can be updated at a time.
+///
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <urb_tree/guard.h>
+#include <urb_tree/types.h>
+
+CPPGUARD_BEGIN();
+
+///
+/// @brief The requests of a combiner.
+///
+typedef enum {
+    URB_COMBINE_NONE,
+    URB_COMBINE_PUT,
+    URB_COMBINE_POP,
+    URB_COMBINE_UPSERT,
+} urb_combine_op_t;
+
+///
+/// @brief The slot of a thread, which holds its request then its result.
+///
+typedef struct {
+    int      pending;       ///< set by the thread, cleared by the combiner.
+    int      op;            ///< the urb_combine_op_t of the request.
+    int      ret;           ///< the returned status (put).
+    void    *key;
+    void    *value;
+    urb_t   *node;          ///< the node to put or the returned node.
+} __attribute__((aligned(64))) urb_combine_slot_t;
+
+///
+/// @brief A combiner.
+///
+typedef struct {
+    urb_t              **urb;
+    int                (*compare_key)(void*, void*);
+    urb_combine_slot_t  *slots;
+    size_t               n;         ///< the number of slots.
+    bool                 sorted;    ///< apply the batches in keys order.
+    urb_combine_slot_t **batch;     ///< the requests of the current pass.
+    pthread_mutex_t      lock;      ///< held by the combiner.
+    size_t               passes;    ///< the passes run so far.
+    size_t               requests;  ///< the requests applied so far.
+} urb_combine_t;
+
+///
+/// @brief Initialize a combiner of a tree with n slots.
+///
+int urb_combine_init(urb_combine_t *combine, urb_t **urb, size_t n, 
+                     bool sorted, int (*compare_key)(void*, void*));
+
+///
+/// @brief Delete a combiner (the tree is left as is).
+///
+int urb_combine_delete(urb_combine_t *combine);
+
+///
+/// @brief Insert a node from the slot id (the key must not exist), 
+///        return URB_INVALID_VALUE if id is not a slot.
+///
+int urb_combine_put(urb_combine_t *combine, size_t id, urb_t *n);
+
+///
+/// @brief Remove a key/value pair from the slot id, the node is returned 
+///        (the sentinel if the key is not found or id is not a slot).
+///
+urb_t *urb_combine_pop(urb_combine_t *combine, size_t id, void *key);
+
+///
+/// @brief Set the value of a key from the slot id, a node is created if 
+///        the key is missing. The previous value is not released. Return
+///        the node, or the sentinel if id is not a slot.
+///
+urb_t *urb_combine_upsert(urb_combine_t *combine, size_t id, 
+                          void *key, void *value);
+
+CPPGUARD_END();
+
+#endif // __URB_TREE_COMBINE_H_
@@ -0,0 +1,137 @@
+#ifndef __URB_TREE_COMPACT_H_
+#define __URB_TREE_COMPACT_H_
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file urb_tree/compact.h
+/// @author Issam SAID
+/// @brief The definition of the compaction (defragmentation) of Red-Black 
+///        trees.
+/// @details The compaction moves the nodes of a tree into one contiguous 
+/// block of memory (a slab) following a layout: the in-order layout makes 
+/// the scans with urb_tree_succ sequential, the BFS and van Emde Boas 
+/// layouts pack the top of the tree (respectively each subtree of half 
+/// height) in a few cache lines for the lookups. A node is moved by 
+/// copying it into the slab and by fixing the links of its parent and of 
+/// its children, so the tree is valid after each move: the compaction can
+/// run in bounded slices (urb_compact_step), the tree can be read between 
+/// two slices but not updated.
+///
+/// The node pointers held before a compaction are no longer valid after 
+/// it. A node of a slab is flagged (URB_NODE_SLAB) and must be given back 
+/// with urb_tree_release (or urb_tree_delete) instead of free; the slab is
+/// freed with its last node.
+///
+#include <stdio.h>
+#include <stdbool.h>
+#include <urb_tree/guard.h>
+#include <urb_tree/types.h>
+
+CPPGUARD_BEGIN();
+
+///
+/// @brief The layouts of the compacted nodes.
+///
+typedef enum {
+    URB_LAYOUT_INORDER,     ///< the keys order, for scans.
+    URB_LAYOUT_BFS,         ///< level by level, for lookups.
+    URB_LAYOUT_VEB,         ///< van Emde Boas, for lookups.
+} urb_layout_t;
+
+///
+/// @brief A pending subtree of the van Emde Boas collection (or of the 
+///        measure of the height).
+///
+typedef struct {
+    urb_t   *node;
+    unsigned kind;          ///< the height, a layout or the layouts below.
+    size_t   d;             ///< the levels below node (its depth for the 
+                            ///< height).
+    size_t   h;             ///< the height of the layouts.
+} urb_compact_frame_t;
+
+///
+/// @brief The state of an incremental compaction.
+///
+typedef struct {
+    urb_t      **urb;
+    urb_layout_t layout;
+    unsigned     phase;     ///< start, height (vEB), collect, then move.
+    urb_t      **order;     ///< the nodes in the layout order.
+    size_t       capacity;  ///< the allocated slots of order.
+    size_t       n;         ///< the number of nodes, once collected.
+    size_t       collected; ///< the nodes already put in order.
+    size_t       scanned;   ///< the nodes whose children are collected (BFS).
+    size_t       moved;     ///< the nodes already moved.
+    urb_t       *next;      ///< the next node to collect (in-order).
+    urb_compact_frame_t *stack; ///< the pending subtrees (vEB).
+    size_t       depth;     ///< the frames in the stack.
+    size_t       frames;    ///< the allocated frames.
+    size_t       height;    ///< the height of the tree (vEB).
+    urb_t       *slab;      ///< the destination nodes.
+    unsigned     id;        ///< the number of the slab.
+} urb_compact_t;
+
+///
+/// @brief Move all the nodes of a tree into a slab following a layout.
+///
+int urb_tree_compact(urb_t **urb, urb_layout_t layout);
+
+///
+/// @brief Start an incremental compaction of a tree, in O(1): the nodes 
+///        are counted and collected by the slices.
+///
+int urb_compact_begin(urb_compact_t *compact, urb_t **urb, 
+                      urb_layout_t layout);
+
+///
+/// @brief Run at most budget units of work (a node or a subtree visited, 
+///        or a node moved), return true when the compaction is over.
+///
+bool urb_compact_step(urb_compact_t *compact, size_t budget);
+
+///
+/// @brief Stop an incremental compaction, the nodes already moved stay in 
+///        the slab.
+///
+void urb_compact_abort(urb_compact_t *compact);
+
+///
+/// @brief Allocate n contiguous nodes in a new slab, each node is given 
+///        back with urb_tree_release.
+///
+urb_t *urb_tree_slab_alloc(size_t n);
+
+///
+/// @brief Free a node of a slab (or the node itself if it is not in a slab).
+///
+void urb_tree_node_free(urb_t *n);
+
+CPPGUARD_END();
+
+#endif // __URB_TREE_COMPACT_H_
@@ -41,6 +41,8 @@
 ///   4. Every path from a given node to any of its descendant 
 ///      leaves contains the same number of black nodes.
 ///
+#include <stdio.h>
+#include <stdint.h>
 #include <urb_tree/guard.h>
 #include <urb_tree/types.h>
 
@@ -62,16 +64,71 @@ int urb_tree_delete(urb_t **urb,
 ///
 urb_t *urb_tree_find(urb_t **urb, void *key, int (*compare_key)(void*, void*));
 
+///
+/// @def URB_TREE_BATCH_WIDTH
+/// @brief The number of descents interleaved by urb_tree_find_batch.
+///
+#define URB_TREE_BATCH_WIDTH 16
+
+///
+/// @brief Find n keys at once, results[i] is set to the node of keys[i] 
+///        (or to the sentinel). Up to URB_TREE_BATCH_WIDTH descents are run
+///        in lockstep and the next node of each one is prefetched, so that
+///        the cache misses of independent lookups overlap.
+///
+void urb_tree_find_batch(urb_t **urb, void **keys, size_t n, urb_t **results,
+                         int (*compare_key)(void*, void*));
+
 ///
 /// @brief Insert a key/value pair into the tree.
 ///
 int urb_tree_put(urb_t **urb, urb_t *n, int (*compare_key)(void*, void*));
 
 ///
-/// @brief Remove a key/value pair from the tree.
+/// @brief Remove a key/value pair from the tree, the returned node is the 
+///        one that held the key.
 ///
 urb_t *urb_tree_pop(urb_t **urb, void *key, int (*compare_key)(void*, void*));
 
+///
+/// @brief Remove a given node from the tree without any comparator call.
+///        The node is unlinked as is (its successor is moved in its place,
+///        no key/value pair is swapped) so the other nodes stay valid.
+///
+urb_t *urb_tree_erase_node(urb_t **urb, urb_t *n);
+
+///
+/// @brief Insert a key/value pair into the tree and store the prefix of 
+///        the key, normalize_key must preserve the order of the keys 
+///        (a < b implies normalize_key(a) <= normalize_key(b)).
+///
+int urb_tree_put_prefixed(urb_t **urb, urb_t *n, 
+                          uint64_t (*normalize_key)(void*),
+                          int (*compare_key)(void*, void*));
+
+///
+/// @brief Find a key/value pair from a tree filled with urb_tree_put_prefixed,
+///        the prefixes are compared first and compare_key is only called 
+///        when they are equal.
+///
+urb_t *urb_tree_find_prefixed(urb_t **urb, void *key,
+                              uint64_t (*normalize_key)(void*),
+                              int (*compare_key)(void*, void*));
+
+///
+/// @brief Remove a key/value pair from a tree filled with 
+///        urb_tree_put_prefixed.
+///
+urb_t *urb_tree_pop_prefixed(urb_t **urb, void *key,
+                             uint64_t (*normalize_key)(void*),
+                             int (*compare_key)(void*, void*));
+
+///
+/// @brief The prefix of a NUL-terminated string key: its first 8 bytes in 
+///        big-endian order, which preserves the order of strcmp.
+///
+uint64_t urb_tree_prefix_string(void *key);
+
 CPPGUARD_END();
 
 #endif // __URB_TREE_CORE_H_
@@ -0,0 +1,89 @@
+#ifndef __URB_TREE_CURSOR_H_
+#define __URB_TREE_CURSOR_H_
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file urb_tree/cursor.h
+/// @author Issam SAID
+/// @brief The definition of the cursors (finger search) of Red-Black trees.
+/// @details A cursor remembers the last node it was moved to. A seek starts
+/// from that node instead of the root: it climbs the parent links until 
+/// the key falls between the node and its next ancestor on the side of the
+/// key, then it descends. A key at rank distance d of the cursor is found 
+/// after visiting O(log d) nodes, unless the cursor and the key are on 
+/// both sides of a high ancestor (the root in the worst case).
+///
+/// A cursor stays valid across updates of its tree as long as the node it
+/// holds is not removed (see urb_tree_erase_node).
+///
+#include <urb_tree/guard.h>
+#include <urb_tree/types.h>
+
+CPPGUARD_BEGIN();
+
+///
+/// @brief The cursor, node is NULL until the first seek.
+///
+typedef struct {
+    urb_t **urb;
+    urb_t  *node;
+    int   (*compare_key)(void*, void*);
+} urb_cursor_t;
+
+///
+/// @brief Initialize a cursor over a tree.
+///
+void urb_cursor_init(urb_cursor_t *cursor, urb_t **urb, 
+                     int (*compare_key)(void*, void*));
+
+///
+/// @brief Find a key from the position of the cursor, the cursor moves to 
+///        the node of the key or, if it is not found, to the last node
+///        visited (a neighbour of the key). Return the node or the sentinel.
+///
+urb_t *urb_cursor_seek(urb_cursor_t *cursor, void *key);
+
+///
+/// @brief Return the node of the cursor (NULL before the first seek).
+///
+urb_t *urb_cursor_node(urb_cursor_t *cursor);
+
+///
+/// @brief Move the cursor to the next node, return it or NULL at the end.
+///
+urb_t *urb_cursor_next(urb_cursor_t *cursor);
+
+///
+/// @brief Move the cursor to the previous node, return it or NULL at the 
+///        beginning.
+///
+urb_t *urb_cursor_prev(urb_cursor_t *cursor);
+
+CPPGUARD_END();
+
+#endif // __URB_TREE_CURSOR_H_
@@ -0,0 +1,88 @@
+#ifndef __URB_TREE_DESTROY_H_
+#define __URB_TREE_DESTROY_H_
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file urb_tree/destroy.h
+/// @author Issam SAID
+/// @brief The definition of the deferred destruction of Red-Black trees.
+/// @details A tree is first detached: its root is moved into a destroy 
+/// state and the tree is left empty, in O(1). The detached nodes are then 
+/// released either by slices of at most N nodes (urb_destroy_step), to be 
+/// called from an event loop, or by a background thread 
+/// (urb_tree_delete_async). In both cases the nodes are torn down the same
+/// way as urb_tree_delete: the release callbacks are called once for each 
+/// key and value, then the node is given back with urb_tree_release.
+///
+/// The release callbacks of an asynchronous destruction run on the 
+/// background thread, they must not use the state of the calling thread.
+///
+#include <stdio.h>
+#include <stdbool.h>
+#include <urb_tree/guard.h>
+#include <urb_tree/types.h>
+
+CPPGUARD_BEGIN();
+
+///
+/// @brief The state of a detached tree.
+///
+typedef struct {
+    urb_t *node;                        ///< the next node to visit.
+    void (*release_key)(void*);
+    void (*release_value)(void*);
+} urb_destroy_t;
+
+///
+/// @brief Detach all the nodes of a tree, the tree is left empty.
+///
+void urb_tree_detach(urb_destroy_t *destroy, urb_t **urb, 
+                     void (*release_key)(void*), 
+                     void (*release_value)(void*));
+
+///
+/// @brief Release at most budget nodes of a detached tree, return true 
+///        when all the nodes are released.
+///
+bool urb_destroy_step(urb_destroy_t *destroy, size_t budget);
+
+///
+/// @brief Detach a tree and release its nodes on a background thread.
+///
+int urb_tree_delete_async(urb_t **urb, 
+                          void (*release_key)(void*), 
+                          void (*release_value)(void*));
+
+///
+/// @brief Wait for the asynchronous destructions in progress.
+///
+void urb_tree_delete_wait(void);
+
+CPPGUARD_END();
+
+#endif // __URB_TREE_DESTROY_H_
@@ -44,6 +44,7 @@ CPPGUARD_BEGIN();
 #define URB_INVALID_NODE    -2
 #define URB_INVALID_VALUE   -3
 #define URB_DUPLICATE_KEY   -4
+#define URB_IO_ERROR        -5
 
 #define URB_EXIT(error_code, fmt,...)                                     \
 {                                                                         \
@@ -58,6 +59,7 @@ CPPGUARD_BEGIN();
      (error_code == URB_INVALID_NODE)    ? "URB_INVALID_NODE"     : \
      (error_code == URB_INVALID_VALUE)   ? "URB_INVALID_VALUE"    : \
      (error_code == URB_DUPLICATE_KEY)   ? "URB_DUPLICATE_KEY"    : \
+     (error_code == URB_IO_ERROR)        ? "URB_IO_ERROR"         : \
     "URB_TREE_UNKNOWN")
 
 CPPGUARD_END();
@@ -56,6 +56,15 @@ int urb_tree_fix_put(urb_t **urb, urb_t *n);
 ///
 int urb_tree_fix_pop(urb_t **urb, urb_t *n);
 
+///
+/// @brief Do one fix-up step for a red node n with a red parent, in a tree
+///        that may hold several such violations (see relaxed.h): the 
+///        topmost violation above n is fixed as in urb_tree_fix_put. 
+///        Return the node that may now be in violation (a recolored 
+///        grandparent), NULL otherwise; n itself may still be in violation.
+///
+urb_t *urb_tree_fix_red(urb_t **urb, urb_t *n);
+
 CPPGUARD_END();
 
 #endif // __URB_TREE_FIXIN_H_
@@ -37,5 +37,6 @@
 #define URB_OUT_OF_MEMORY  -2
 #define URB_DUPLICATE_KEY  -3
 #define URB_NODE_NOT_FOUND -4
+#define URB_IO_ERROR       -5
 
 #endif // _URB_TREE_FLAGS_H_
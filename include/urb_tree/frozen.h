@@ -0,0 +1,143 @@
+#ifndef __URB_TREE_FROZEN_H_
+#define __URB_TREE_FROZEN_H_
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file urb_tree/frozen.h
+/// @author Issam SAID
+/// @brief The definition of the read-only (frozen) form of Red-Black trees.
+/// @details A frozen tree stores the keys and the values of a tree in two 
+/// contiguous arrays following the Eytzinger (BFS) order: the children of 
+/// the slot i are the slots 2i and 2i+1, and the slot 0 is unused. There 
+/// is no color nor parent link and a descent is a branchless sequence of
+/// i = 2i + (key[i] < key). Slots are designated by their index, 0 meaning
+/// not found (or the end of a scan).
+///
+/// When the key size is not 0 the keys (and the values) are copied into 
+/// the arrays and the frozen tree can be saved to a file then mapped back 
+/// with mmap. When the key size is 0 the arrays hold the key (and value) 
+/// pointers of the original tree, which must outlive the frozen tree.
+///
+#include <stdio.h>
+#include <stdint.h>
+#include <urb_tree/guard.h>
+#include <urb_tree/types.h>
+
+CPPGUARD_BEGIN();
+
+///
+/// @brief The frozen tree.
+///
+typedef struct {
+    size_t n;                ///< number of keys.
+    size_t key_size;         ///< bytes per key, 0 to store the pointers.
+    size_t value_size;       ///< bytes per value, 0 to store the pointers.
+    unsigned char *keys;     ///< the (n+1) keys in the Eytzinger order.
+    unsigned char *values;   ///< the (n+1) values in the Eytzinger order.
+    void  *map;              ///< the file mapping (NULL if in memory).
+    size_t map_size;         ///< the size of the file mapping.
+} urb_frozen_t;
+
+///
+/// @brief Copy a tree into a frozen tree, key_size (value_size) bytes are
+///        copied from each key (value) or the pointers are kept if 0.
+///
+urb_frozen_t *urb_tree_freeze(urb_t **urb, size_t key_size, size_t value_size);
+
+///
+/// @brief Release a frozen tree (or unmap it if it was loaded).
+///
+void urb_frozen_delete(urb_frozen_t *frozen);
+
+///
+/// @brief Return the key stored in a slot.
+///
+void *urb_frozen_key(urb_frozen_t *frozen, size_t i);
+
+///
+/// @brief Return the value stored in a slot.
+///
+void *urb_frozen_value(urb_frozen_t *frozen, size_t i);
+
+///
+/// @brief Return the slot of the key or 0, same result as urb_tree_find.
+///
+size_t urb_frozen_find(urb_frozen_t *frozen, void *key, 
+                       int (*compare_key)(void*, void*));
+
+///
+/// @brief Return the slot of the smallest key not less than key or 0.
+///
+size_t urb_frozen_lower_bound(urb_frozen_t *frozen, void *key,
+                              int (*compare_key)(void*, void*));
+
+///
+/// @brief Return the slot of the smallest key or 0 if empty.
+///
+size_t urb_frozen_min(urb_frozen_t *frozen);
+
+///
+/// @brief Return the slot of the largest key or 0 if empty.
+///
+size_t urb_frozen_max(urb_frozen_t *frozen);
+
+///
+/// @brief Return the slot following i in the keys order or 0.
+///
+size_t urb_frozen_succ(urb_frozen_t *frozen, size_t i);
+
+///
+/// @brief Return the slot preceding i in the keys order or 0.
+///
+size_t urb_frozen_prev(urb_frozen_t *frozen, size_t i);
+
+///
+/// @brief The search kernel for 64-bit signed integer keys (key_size 8).
+///
+size_t urb_frozen_find_int64(urb_frozen_t *frozen, int64_t key);
+
+///
+/// @brief Find n integer keys at once, with AVX2 when the CPU supports it
+///        (four descents per vector) or interleaved scalar descents.
+///
+void urb_frozen_find_int64_batch(urb_frozen_t *frozen, const int64_t *keys,
+                                 size_t n, size_t *results);
+
+///
+/// @brief Save a frozen tree (copied keys only) to a file.
+///
+int urb_frozen_save(urb_frozen_t *frozen, const char *path);
+
+///
+/// @brief Map a saved frozen tree read-only, return NULL on failure.
+///
+urb_frozen_t *urb_frozen_load(const char *path);
+
+CPPGUARD_END();
+
+#endif // __URB_TREE_FROZEN_H_
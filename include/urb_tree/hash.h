@@ -0,0 +1,111 @@
+#ifndef __URB_TREE_HASH_H_
+#define __URB_TREE_HASH_H_
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file urb_tree/hash.h
+/// @author Issam SAID
+/// @brief The definition of the hybrid hash and Red-Black tree index.
+/// @details A hybrid index is a Red-Black tree along with an open 
+/// addressing hash table (linear probing) from the keys to the nodes of 
+/// the tree. The exact lookups, upserts and removals by key go through the
+/// table in O(1) and the tree is only used to keep the order: a removal 
+/// unlinks the node with urb_tree_erase_node, without any descent. The 
+/// ordered routines (urb_tree_min, urb_tree_succ, cursors, ...) are called
+/// on &hash->root.
+///
+/// The tree of a hybrid index must only be updated with the routines 
+/// below, and it must not be compacted (the table holds the nodes).
+///
+#include <stdio.h>
+#include <stdint.h>
+#include <urb_tree/guard.h>
+#include <urb_tree/types.h>
+
+CPPGUARD_BEGIN();
+
+///
+/// @brief A slot of the table, an empty slot has no node and a removed 
+///        slot has the sentinel as node.
+///
+typedef struct {
+    uint64_t hash;
+    urb_t   *node;
+} urb_hash_slot_t;
+
+///
+/// @brief The hybrid index.
+///
+typedef struct {
+    urb_t           *root;
+    urb_hash_slot_t *slots;
+    size_t           capacity;  ///< the number of slots (a power of 2).
+    size_t           n;         ///< the number of keys.
+    size_t           removed;   ///< the number of removed slots.
+    uint64_t       (*hash_key)(void*);
+} urb_hash_t;
+
+///
+/// @brief Initialize an empty hybrid index for capacity keys.
+///
+int urb_hash_init(urb_hash_t *hash, size_t capacity, 
+                  uint64_t (*hash_key)(void*));
+
+///
+/// @brief Delete the key/value pairs and the table of a hybrid index.
+///
+int urb_hash_delete(urb_hash_t *hash, 
+                    void (*release_key)(void*), void (*release_value)(void*));
+
+///
+/// @brief Insert a key/value pair into the hybrid index.
+///
+int urb_hash_put(urb_hash_t *hash, urb_t *n, int (*compare_key)(void*, void*));
+
+///
+/// @brief Set the value of a key, a node is created if the key is missing. 
+///        The previous value is not released.
+///
+urb_t *urb_hash_upsert(urb_hash_t *hash, void *key, void *value, 
+                       int (*compare_key)(void*, void*));
+
+///
+/// @brief Find a key/value pair from the table.
+///
+urb_t *urb_hash_find(urb_hash_t *hash, void *key, 
+                     int (*compare_key)(void*, void*));
+
+///
+/// @brief Remove a key/value pair from the hybrid index.
+///
+urb_t *urb_hash_pop(urb_hash_t *hash, void *key, 
+                    int (*compare_key)(void*, void*));
+
+CPPGUARD_END();
+
+#endif // __URB_TREE_HASH_H_
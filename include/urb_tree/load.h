@@ -0,0 +1,97 @@
+#ifndef __URB_TREE_LOAD_H_
+#define __URB_TREE_LOAD_H_
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file urb_tree/load.h
+/// @author Issam SAID
+/// @brief The definition of the bulk loading of Red-Black trees.
+/// @details urb_tree_build turns n sorted key/value pairs into a balanced
+/// Red-Black tree in O(n), without any comparator call nor rotation: the 
+/// nodes are allocated in one slab (see compact.h) and linked in order, 
+/// the middle pair of each range being the root of its subtree. Only the 
+/// nodes of the deepest (incomplete) level are red.
+///
+/// urb_tree_load builds a tree from a file of unsorted fixed-size records
+/// larger than the memory: 
+///   1. the records are read in runs that fill the configured memory, 
+///      the runs are sorted in parallel (one per thread) and spilled to 
+///      temporary files,
+///   2. the runs are merged (k-way, with a binary heap) into one block of 
+///      records, the duplicate records (compared equal) are dropped,
+///   3. the tree is built from the merged block with urb_tree_build.
+/// The key and the value of each node point to its record in the block, 
+/// which is owned by the caller (load->records), it is freed after the 
+/// tree is deleted.
+///
+#include <stdio.h>
+#include <urb_tree/guard.h>
+#include <urb_tree/types.h>
+
+CPPGUARD_BEGIN();
+
+///
+/// @brief The configuration of a loader.
+///
+typedef struct {
+    size_t      record_size;    ///< the bytes of a record.
+    size_t      memory;         ///< the bytes of the sorted runs.
+    int         threads;        ///< the number of runs sorted at once.
+    const char *tmpdir;         ///< the directory of the runs (NULL: /tmp).
+    int       (*compare_key)(void*, void*);   ///< compare two records.
+} urb_load_config_t;
+
+///
+/// @brief The result of a loader, the times are in seconds.
+///
+typedef struct {
+    void  *records;             ///< the merged records, owned by the caller.
+    size_t n;                   ///< the number of records in the tree.
+    size_t duplicates;          ///< the dropped duplicate records.
+    size_t runs;                ///< the number of spilled runs.
+    double read;                ///< reading the input.
+    double sort;                ///< sorting the runs.
+    double spill;               ///< writing the runs.
+    double merge;               ///< merging the runs.
+    double build;               ///< building the tree.
+} urb_load_t;
+
+///
+/// @brief Build a tree from n key/value pairs sorted by (unique) keys.
+///
+int urb_tree_build(urb_t **urb, void **keys, void **values, size_t n);
+
+///
+/// @brief Build a tree from a file of unsorted records.
+///
+int urb_tree_load(urb_t **urb, FILE *input, 
+                  const urb_load_config_t *config, urb_load_t *load);
+
+CPPGUARD_END();
+
+#endif // __URB_TREE_LOAD_H_
@@ -0,0 +1,196 @@
+#ifndef __URB_TREE_POOL_H_
+#define __URB_TREE_POOL_H_
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file urb_tree/pool.h
+/// @author Issam SAID
+/// @brief The definition of the index-based Red-Black trees (node pools).
+/// @details A pool is a Red-Black tree engine for 64-bit signed integer 
+/// keys whose nodes are stored in one array and linked by 32-bit indices 
+/// instead of pointers: a node takes 32 bytes (the key and the value 
+/// inline, three links and the color) 
+/// against 48 bytes for urb_t, plus the key it points to. The index 0 is 
+/// the sentinel of the pool, so each pool has its own sentinel.
+///
+/// Since the nodes hold no pointer, the array can be moved: it grows with
+/// realloc, a pool can be copied with memcpy and it is saved to a file 
+/// and loaded back as is. The values are 64-bit integers for the same 
+/// reason (an offset or an id rather than a pointer). A pool holds at most
+/// URB_POOL_INDEX nodes. 
+///
+/// When built with __URB_TREE_POOL_SPLIT (the urb_tree_pool_split option)
+/// the nodes are split in two parallel arrays: the hot nodes hold what the
+/// descents read (the key and the two children, 16 bytes, four nodes per 
+/// 64-byte aligned cache line) and the cold nodes hold the parent link, 
+/// the color and the value, which are only read when rebalancing or on a 
+/// hit. The nodes are then read with urb_pool_key and urb_pool_value.
+///
+/// The routines follow the semantics of the Red-Black tree ones: inserting
+/// an existing key is an error, find/min/max/succ/prev return the index of
+/// a node or 0, and pop removes the key and hands the value back.
+///
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <urb_tree/guard.h>
+
+CPPGUARD_BEGIN();
+
+///
+/// @def URB_POOL_INDEX
+/// @brief The bound of the 32-bit indices, the nodes of a pool (the 
+///        sentinel included).
+///
+#define URB_POOL_INDEX 0xffffffffU
+
+#ifdef __URB_TREE_POOL_SPLIT
+///
+/// @brief The hot part of a node of a pool.
+///
+typedef struct {
+    int64_t  key;
+    uint32_t left;
+    uint32_t right;
+} urb_pnode_t;
+
+///
+/// @brief The cold part of a node of a pool.
+///
+typedef struct {
+    uint64_t value;
+    uint32_t parent;
+    uint32_t red;               ///< 1 for the red nodes.
+} urb_pcold_t;
+#else
+///
+/// @brief A node of a pool.
+///
+typedef struct {
+    int64_t  key;
+    uint64_t value;
+    uint32_t left;
+    uint32_t right;
+    uint32_t parent;
+    uint32_t red;               ///< 1 for the red nodes.
+} urb_pnode_t;
+#endif
+
+///
+/// @brief A pool, the nodes [1, size) are either in the tree or in the free
+///        list (linked by left).
+///
+typedef struct {
+    urb_pnode_t *nodes;
+#ifdef __URB_TREE_POOL_SPLIT
+    urb_pcold_t *cold;
+#endif
+    uint32_t     capacity;      ///< the allocated nodes.
+    uint32_t     size;          ///< the nodes used once.
+    uint32_t     n;             ///< the number of keys.
+    uint32_t     root;
+    uint32_t     free;          ///< the first free node, 0 if none.
+} urb_pool_t;
+
+///
+/// @brief Initialize an empty pool for capacity keys.
+///
+int urb_pool_init(urb_pool_t *pool, uint32_t capacity);
+
+///
+/// @brief Release the nodes of a pool.
+///
+void urb_pool_delete(urb_pool_t *pool);
+
+///
+/// @brief Insert a key/value pair into the pool, return its index.
+///
+uint32_t urb_pool_put(urb_pool_t *pool, int64_t key, uint64_t value);
+
+///
+/// @brief Find a key in the pool, return 0 if not found.
+///
+uint32_t urb_pool_find(urb_pool_t *pool, int64_t key);
+
+///
+/// @brief Remove a key from the pool, its value is stored in value (if 
+///        not NULL), return false if the key is not found.
+///
+bool urb_pool_pop(urb_pool_t *pool, int64_t key, uint64_t *value);
+
+///
+/// @brief Return the index of the smallest key (0 if empty).
+///
+uint32_t urb_pool_min(urb_pool_t *pool);
+
+///
+/// @brief Return the index of the largest key (0 if empty).
+///
+uint32_t urb_pool_max(urb_pool_t *pool);
+
+///
+/// @brief Return the index of the next key (0 if none).
+///
+uint32_t urb_pool_succ(urb_pool_t *pool, uint32_t i);
+
+///
+/// @brief Return the index of the previous key (0 if none).
+///
+uint32_t urb_pool_prev(urb_pool_t *pool, uint32_t i);
+
+///
+/// @brief Return the key of a node.
+///
+int64_t urb_pool_key(urb_pool_t *pool, uint32_t i);
+
+///
+/// @brief Return the value of a node.
+///
+uint64_t urb_pool_value(urb_pool_t *pool, uint32_t i);
+
+///
+/// @brief Save a pool to a file.
+///
+int urb_pool_save(urb_pool_t *pool, const char *path);
+
+///
+/// @brief Load a saved pool into an uninitialized one. The header and the 
+///        range of every link are checked, so the loaded nodes are never 
+///        read out of bounds; the shape of the tree is not (use 
+///        urb_pool_check on untrusted files).
+///
+int urb_pool_load(urb_pool_t *pool, const char *path);
+
+///
+/// @brief Check the order and the Red-Black invariants of a pool.
+///
+bool urb_pool_check(urb_pool_t *pool);
+
+CPPGUARD_END();
+
+#endif // __URB_TREE_POOL_H_
@@ -0,0 +1,102 @@
+#ifndef __URB_TREE_PQ_H_
+#define __URB_TREE_PQ_H_
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file urb_tree/pq.h
+/// @author Issam SAID
+/// @brief The definition of the priority queue mode of Red-Black trees.
+/// @details A priority queue is a Red-Black tree along with its leftmost 
+/// (min) and rightmost (max) nodes, which are kept up to date by the put 
+/// and pop routines below without extra comparator calls: a new node is 
+/// the new min if it is inserted as the left child of the min, and when 
+/// the min is removed the new min is its successor. The extreme nodes are
+/// then read in O(1) and urb_tree_pop_min (urb_tree_pop_max) unlinks the 
+/// min (max) node directly, without any descent. 
+///
+/// The tree of a priority queue must only be updated with these routines,
+/// it can be read with all the others (using &pq->root).
+///
+#include <urb_tree/guard.h>
+#include <urb_tree/types.h>
+
+CPPGUARD_BEGIN();
+
+///
+/// @brief The priority queue, min and max are NULL when it is empty.
+///
+typedef struct {
+    urb_t *root;
+    urb_t *min;
+    urb_t *max;
+} urb_pq_t;
+
+///
+/// @brief Initialize an empty priority queue.
+///
+void urb_pq_init(urb_pq_t *pq);
+
+///
+/// @brief Insert a key/value pair into the priority queue.
+///
+int urb_pq_put(urb_pq_t *pq, urb_t *n, int (*compare_key)(void*, void*));
+
+///
+/// @brief Remove a key/value pair from the priority queue.
+///
+urb_t *urb_pq_pop(urb_pq_t *pq, void *key, int (*compare_key)(void*, void*));
+
+///
+/// @brief Return the node with the smallest key (NULL if empty).
+///
+urb_t *urb_pq_min(urb_pq_t *pq);
+
+///
+/// @brief Return the node with the largest key (NULL if empty).
+///
+urb_t *urb_pq_max(urb_pq_t *pq);
+
+///
+/// @brief Remove the node with the smallest key (NULL if empty).
+///
+urb_t *urb_tree_pop_min(urb_pq_t *pq);
+
+///
+/// @brief Remove the node with the largest key (NULL if empty).
+///
+urb_t *urb_tree_pop_max(urb_pq_t *pq);
+
+///
+/// @brief Delete the tree of a priority queue.
+///
+int urb_pq_delete(urb_pq_t *pq, 
+                  void (*release_key)(void*), void (*release_value)(void*));
+
+CPPGUARD_END();
+
+#endif // __URB_TREE_PQ_H_
@@ -0,0 +1,96 @@
+#ifndef __URB_TREE_PROFILE_H_
+#define __URB_TREE_PROFILE_H_
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file urb_tree/profile.h
+/// @author Issam SAID
+/// @brief The definition of the routines that profile the shape and the 
+///        memory footprint of Red-Black trees.
+///
+#include <stdio.h>
+#include <stdbool.h>
+#include <urb_tree/guard.h>
+#include <urb_tree/types.h>
+
+CPPGUARD_BEGIN();
+
+///
+/// @def URB_PROFILE_DEPTHS
+/// @brief The number of depths in the histogram, a Red-Black tree is at 
+///        most 2*log2(n+1) deep.
+///
+#define URB_PROFILE_DEPTHS 128
+
+///
+/// @brief The shape and the memory footprint of a tree. The depths count 
+///        the nodes from the root (at depth 1), the depth of a node is the
+///        number of comparisons needed to find it.
+///
+typedef struct {
+    bool   sampled;         ///< true if the fields are estimates.
+    size_t nodes;           ///< number of nodes.
+    size_t red;             ///< number of red nodes.
+    size_t black;           ///< number of black nodes.
+    size_t height;          ///< depth of the deepest node (the max path).
+    size_t black_height;    ///< black nodes on any path from the root.
+    double avg_depth;       ///< average comparison path.
+    double red_ratio;       ///< red nodes over all the nodes.
+    size_t node_bytes;      ///< bytes used by the urb_t nodes.
+    size_t key_bytes;       ///< bytes used by the keys (if sizes given).
+    size_t value_bytes;     ///< bytes used by the values (if sizes given).
+    size_t depths[URB_PROFILE_DEPTHS];  ///< number of nodes at each depth.
+} urb_profile_t;
+
+///
+/// @brief Profile the whole tree in one (OpenMP parallel) pass, key_size 
+///        and value_size return the payload bytes of a node and can be NULL.
+///
+int urb_tree_profile(urb_t **urb, 
+                     size_t (*key_size)(void*), size_t (*value_size)(void*),
+                     urb_profile_t *profile);
+
+///
+/// @brief Estimate the profile from a number of random descents, the cost
+///        is O(samples*log(n)). The counts are unbiased estimates (Knuth's 
+///        estimator) while the height is the deepest sampled path.
+///
+int urb_tree_profile_sampled(urb_t **urb, size_t samples, unsigned int seed,
+                             size_t (*key_size)(void*), 
+                             size_t (*value_size)(void*),
+                             urb_profile_t *profile);
+
+///
+/// @brief Print a profile (the histogram is printed when verbose is true).
+///
+void urb_tree_profile_print(FILE *stream, urb_profile_t *profile, 
+                            bool verbose);
+
+CPPGUARD_END();
+
+#endif // __URB_TREE_PROFILE_H_
@@ -0,0 +1,115 @@
+#ifndef __URB_TREE_RELAXED_H_
+#define __URB_TREE_RELAXED_H_
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+///
+/// @file urb_tree/relaxed.h
+/// @author Issam SAID
+/// @brief The definition of the relaxed (deferred) balancing of Red-Black 
+///        trees.
+/// @details In a relaxed session the insertions only link a red node and 
+/// record it as a possible violation (a red node with a red parent), in 
+/// the style of chromatic trees. Linking a red node never changes the 
+/// number of black nodes on a path, so the only violations are red nodes
+/// with red parents, and they are fixed later, one step (a recoloring or 
+/// the rotations of urb_tree_fix_put) at a time: either a budget of steps
+/// after each insertion, or with urb_relaxed_step and urb_tree_rebalance.
+///
+/// The tree stays a binary search tree during a session, so it can be read
+/// with the usual routines (urb_tree_find, urb_tree_succ, cursors, ...), 
+/// but it must only be updated with the routines below until the end of 
+/// the session. A budget of 0 defers all the work to urb_tree_rebalance, 
+/// but the depth grows with the unbalanced insertions during the burst 
+/// (the descents get longer, and the tree is a list with sorted keys). A 
+/// budget of 1 step keeps up with random keys and a budget of 2 with 
+/// sorted keys, which need a recoloring and a rotation per insertion.
+///
+/// The removals are not deferred: a black node removed from a tree with 
+/// red violations can not be fixed locally, so urb_relaxed_pop rebalances
+/// the tree first when violations are pending, then removes the node as 
+/// urb_tree_pop does.
+///
+#include <stdio.h>
+#include <stdbool.h>
+#include <urb_tree/guard.h>
+#include <urb_tree/types.h>
+
+CPPGUARD_BEGIN();
+
+///
+/// @brief The state of a relaxed session.
+///
+typedef struct {
+    urb_t  **urb;
+    urb_t  **pending;   ///< the nodes that may be in violation.
+    size_t   n;         ///< the number of pending nodes.
+    size_t   capacity;  ///< the capacity of pending.
+    size_t   budget;    ///< the fix-up steps run after each insertion.
+    size_t   steps;     ///< the fix-up steps run so far.
+} urb_relaxed_t;
+
+///
+/// @brief Start a relaxed session on a tree with a budget of fix-up steps
+///        per insertion.
+///
+int urb_relaxed_begin(urb_relaxed_t *relaxed, urb_t **urb, size_t budget);
+
+///
+/// @brief Insert a node without rebalancing (the key must not exist), then
+///        run the budget of fix-up steps.
+///
+int urb_relaxed_put(urb_relaxed_t *relaxed, urb_t *n,
+                    int (*compare_key)(void*, void*));
+
+///
+/// @brief Remove a key/value pair, the tree is rebalanced first if some 
+///        violations are pending.
+///
+urb_t *urb_relaxed_pop(urb_relaxed_t *relaxed, void *key,
+                       int (*compare_key)(void*, void*));
+
+///
+/// @brief Run at most budget fix-up steps, return true when the tree is a 
+///        Red-Black tree again.
+///
+bool urb_relaxed_step(urb_relaxed_t *relaxed, size_t budget);
+
+///
+/// @brief Fix all the pending violations of a relaxed session.
+///
+int urb_tree_rebalance(urb_relaxed_t *relaxed);
+
+///
+/// @brief Rebalance the tree and end a relaxed session.
+///
+int urb_relaxed_end(urb_relaxed_t *relaxed);
+
+CPPGUARD_END();
+
+#endif // __URB_TREE_RELAXED_H_
@@ -0,0 +1,161 @@
+#ifndef __URB_TREE_SHM_H_
+#define __URB_TREE_SHM_H_
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+///
+/// @file urb_tree/shm.h
+/// @author Issam SAID
+/// @brief The definition of the shared trees (pools in shared memory).
+/// @details A shared tree is a pool (see pool.h) whose nodes live in a 
+/// segment mapped by several processes: a POSIX shared memory object or a
+/// file. The nodes of a pool are linked by indices and its sentinel is the
+/// node 0 of the array, so the tree holds no pointer and each process can 
+/// map the segment at any address: attaching maps the segment and reads 
+/// its header, in O(1) whatever the number of keys.
+///
+/// The segment holds a header (the root, the free list and the counters of
+/// the pool, and a process-shared read/write lock), the nodes of the pool
+/// and, when the tree is created with a value size, one fixed-size value 
+/// per node next to the 64-bit value of the pool. The capacity is fixed 
+/// when the segment is created, a put into a full tree fails.
+///
+/// The put/find/pop routines take the lock themselves and copy the values
+/// in and out of the segment. To iterate or to run several operations at 
+/// once, take the lock with urb_shm_lock, use the pool routines on 
+/// shm->pool and urb_shm_data, and release it with urb_shm_unlock. The 
+/// routines report errors instead of leaving the process (URB_EXIT), 
+/// since a process that dies with the lock held blocks all the others.
+///
+/// A name of the form "/name" (one leading slash and no other) is a POSIX
+/// shared memory object (shm_open), any other name is a file path.
+///
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <urb_tree/guard.h>
+#include <urb_tree/pool.h>
+
+CPPGUARD_BEGIN();
+
+///
+/// @brief The header of a segment, shared by the processes.
+///
+typedef struct {
+    char             magic[8];
+    pthread_rwlock_t lock;
+    uint64_t         length;      ///< the bytes of the segment.
+    uint64_t         value_size;  ///< the bytes of the fixed-size values.
+    uint32_t         capacity;    ///< the nodes of the pool (sentinel too).
+    uint32_t         size;
+    uint32_t         n;
+    uint32_t         root;
+    uint32_t         free;
+} urb_shm_header_t;
+
+///
+/// @brief A shared tree, as seen by one process.
+///
+typedef struct {
+    int               fd;
+    urb_shm_header_t *header;     ///< the start of the mapping.
+    size_t            length;     ///< the bytes of the mapping.
+    unsigned char    *data;       ///< the fixed-size values, or NULL.
+    size_t            value_size;
+    urb_pool_t        pool;       ///< a view of the pool in the segment.
+    bool              write;      ///< the lock is held for writing.
+} urb_shm_t;
+
+///
+/// @brief Create a shared tree of capacity keys with values of value_size
+///        bytes (0 for none), and attach it. Creating over an existing 
+///        segment fails (URB_IO_ERROR): truncating it would crash the 
+///        processes attached to it. Unlink it first, the attached 
+///        processes then keep the old segment.
+///
+int urb_shm_create(urb_shm_t *shm, const char *name, 
+                   uint32_t capacity, size_t value_size);
+
+///
+/// @brief Attach a shared tree created by another process.
+///
+int urb_shm_attach(urb_shm_t *shm, const char *name);
+
+///
+/// @brief Unmap a shared tree, the segment is left as is.
+///
+int urb_shm_detach(urb_shm_t *shm);
+
+///
+/// @brief Remove the segment of a shared tree, the processes attached to 
+///        it keep their mapping.
+///
+int urb_shm_unlink(const char *name);
+
+///
+/// @brief Take the lock of a shared tree, for reading or for writing, and
+///        load the pool view from the header.
+///
+void urb_shm_lock(urb_shm_t *shm, bool write);
+
+///
+/// @brief Store the pool view in the header (after a write) and release 
+///        the lock.
+///
+void urb_shm_unlock(urb_shm_t *shm);
+
+///
+/// @brief Return the fixed-size value of a node (NULL without values).
+///
+void *urb_shm_data(urb_shm_t *shm, uint32_t i);
+
+///
+/// @brief Insert a key with its value and a copy of its fixed-size value 
+///        (if data is not NULL), return URB_DUPLICATE_KEY if the key 
+///        exists or URB_OUT_OF_MEMORY if the tree is full.
+///
+int urb_shm_put(urb_shm_t *shm, int64_t key, uint64_t value, 
+                const void *data);
+
+///
+/// @brief Find a key, copy its value and its fixed-size value into value 
+///        and data (if not NULL), return false if the key is not found.
+///
+bool urb_shm_find(urb_shm_t *shm, int64_t key, uint64_t *value, 
+                  void *data);
+
+///
+/// @brief Remove a key, copy its values as urb_shm_find, return false if 
+///        the key is not found.
+///
+bool urb_shm_pop(urb_shm_t *shm, int64_t key, uint64_t *value, void *data);
+
+CPPGUARD_END();
+
+#endif // __URB_TREE_SHM_H_
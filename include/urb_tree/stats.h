@@ -0,0 +1,124 @@
+#ifndef __URB_TREE_STATS_H_
+#define __URB_TREE_STATS_H_
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file urb_tree/stats.h
+/// @author Issam SAID
+/// @brief The definition of the structural counters of Red-Black trees.
+/// @details The counters (comparator calls, rotations, recolorings and 
+/// descent depths) are only collected when urb_tree is built with the 
+/// urb_tree_stats option (which defines __URB_TREE_STATS), otherwise the 
+/// URB_STATS_* macros expand to nothing and the hot paths are untouched.
+/// Each thread increments its own block of counters, the blocks are summed
+/// by urb_tree_stats.
+///
+#include <stdbool.h>
+#include <urb_tree/guard.h>
+
+CPPGUARD_BEGIN();
+
+///
+/// @brief The structural counters of the urb_tree routines.
+///
+typedef struct {
+    unsigned long long finds;            ///< calls to urb_tree_find.
+    unsigned long long puts;             ///< calls to urb_tree_put.
+    unsigned long long pops;             ///< calls to urb_tree_pop.
+    unsigned long long find_compares;    ///< comparator calls in find.
+    unsigned long long put_compares;     ///< comparator calls in put.
+    unsigned long long pop_compares;     ///< comparator calls in pop.
+    unsigned long long find_depth;       ///< sum of the find descents depth.
+    unsigned long long put_depth;        ///< sum of the put descents depth.
+    unsigned long long pop_depth;        ///< sum of the pop descents depth.
+    unsigned long long max_depth;        ///< deepest descent.
+    unsigned long long left_rotations;   ///< left rotations done by 
+                                         ///< urb_tree_rotate (d = 0),
+                                         ///< or urb_wavl_rotate.
+    unsigned long long right_rotations;  ///< right rotations done by 
+                                         ///< urb_tree_rotate (d = 1),
+                                         ///< or urb_wavl_rotate.
+    unsigned long long put_recolors;     ///< color changes in fix_put.
+    unsigned long long pop_recolors;     ///< color changes in fix_pop.
+} urb_stats_t;
+
+///
+/// @brief Return true if urb_tree was built with the structural counters.
+///
+bool urb_tree_stats_enabled(void);
+
+///
+/// @brief Sum the counters of all the threads (including the exited ones).
+///        The sum is approximate if other threads are updating trees.
+///
+void urb_tree_stats(urb_stats_t *stats);
+
+///
+/// @brief Reset the counters of all the threads.
+///
+void urb_tree_stats_reset(void);
+
+#ifdef __URB_TREE_STATS
+
+///
+/// @brief The counters of the calling thread (NULL until first used).
+///
+extern __thread urb_stats_t *urb_stats_local;
+
+///
+/// @brief Allocate and register the counters of the calling thread.
+///
+urb_stats_t *urb_tree_stats_attach(void);
+
+#define URB_STATS_LOCAL() \
+    (urb_stats_local ? urb_stats_local : urb_tree_stats_attach())
+
+#define URB_STATS_ADD(field, count) (URB_STATS_LOCAL()->field += (count))
+
+#define URB_STATS_INC(field) URB_STATS_ADD(field, 1)
+
+#define URB_STATS_OP(op, compares, depth)                            \
+{                                                                    \
+    urb_stats_t *__s = URB_STATS_LOCAL();                            \
+    __s->op##s++;                                                    \
+    __s->op##_compares += (compares);                                \
+    __s->op##_depth    += (depth);                                   \
+    if ((depth) > __s->max_depth) __s->max_depth = (depth);          \
+}
+
+#else
+
+#define URB_STATS_ADD(field, count)
+#define URB_STATS_INC(field)
+#define URB_STATS_OP(op, compares, depth)
+
+#endif  // __URB_TREE_STATS
+
+CPPGUARD_END();
+
+#endif  // __URB_TREE_STATS_H_
@@ -41,6 +41,7 @@
 ///   4. Every path from a given node to any of its descendant 
 ///      leaves contains the same number of Black nodes.
 ///
+#include <stdint.h>
 #include <urb_tree/guard.h>
 
 CPPGUARD_BEGIN();
@@ -53,16 +54,52 @@ typedef enum {
     black,
 } color_t;
 
+///
+/// @def URB_NODE_SLAB
+/// @brief The node flag of the nodes stored in a slab (see compact.h), the
+///        slab number is stored above URB_NODE_SLAB_SHIFT.
+///
+#define URB_NODE_SLAB       0x1
+#define URB_NODE_SLAB_SHIFT 8
+
+///
+/// @def URB_NODE_DIRTY
+/// @brief The node flags of the dirty tracking (see checkpoint.h): the 
+///        record of the node changed since the last checkpoint, or some 
+///        node below it may have changed.
+///
+#define URB_NODE_DIRTY       0x2
+#define URB_NODE_DIRTY_BELOW 0x4
+#define URB_NODE_DIRTY_MASK  (URB_NODE_DIRTY | URB_NODE_DIRTY_BELOW)
+
 ///
 /// @brief The main structure that defines the Red-Black tree.
+/// @details The children are also reached by direction, child[0] is left 
+/// and child[1] is right, so that the descents and the rebalancing index
+/// the children by a comparison result instead of branching.
+/// The nodes of a WAVL tree (see wavl.h) store a rank instead of a color.
+/// With __URB_TREE_PREFIX the node also stores the order-preserving 8-byte 
+/// prefix of its key, set by urb_tree_put_prefixed.
 ///
 typedef struct __urb_t {
-    struct __urb_t *left;
-    struct __urb_t *right;
+    union {
+        struct {
+            struct __urb_t *left;
+            struct __urb_t *right;
+        };
+        struct __urb_t *child[2];
+    };
     struct __urb_t *parent;
-    color_t color;                               
+    union {
+        color_t color;                               
+        int32_t rank;                            ///< in a WAVL tree.
+    };
+    uint32_t flags;
     void *key;                                 
     void *value;                             
+#ifdef __URB_TREE_PREFIX
+    uint64_t prefix;
+#endif
 } urb_t;
 
 CPPGUARD_END();
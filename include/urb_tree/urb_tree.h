@@ -39,5 +39,24 @@
 #include <urb_tree/core.h>
 #include <urb_tree/util.h>
 #include <urb_tree/check.h>
+#include <urb_tree/stats.h>
+#include <urb_tree/profile.h>
+#include <urb_tree/frozen.h>
+#include <urb_tree/btree.h>
+#include <urb_tree/cache.h>
+#include <urb_tree/pq.h>
+#include <urb_tree/cursor.h>
+#include <urb_tree/compact.h>
+#include <urb_tree/destroy.h>
+#include <urb_tree/bloom.h>
+#include <urb_tree/hash.h>
+#include <urb_tree/load.h>
+#include <urb_tree/pool.h>
+#include <urb_tree/wavl.h>
+#include <urb_tree/relaxed.h>
+#include <urb_tree/combine.h>
+#include <urb_tree/vlog.h>
+#include <urb_tree/checkpoint.h>
+#include <urb_tree/shm.h>
 
 #endif // __URB_TREE_H_
\ No newline at end of file
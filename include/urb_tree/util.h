@@ -42,12 +42,25 @@
 ///      leaves contains the same number of black nodes.
 ///
 #include <stdio.h>
+#include <stdint.h>
 #include <stdbool.h>
 #include <urb_tree/guard.h>
 #include <urb_tree/types.h>
 
 CPPGUARD_BEGIN();
 
+///
+/// @brief Mix the bits of a 64-bit hash (the MurmurHash3 finalizer), so 
+///        the weak user hashes spread over the slots of the bloom filters 
+///        and of the hash indexes.
+///
+static inline uint64_t urb_tree_mix(uint64_t h) {
+    h ^= h >> 33; h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33; h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
 ///
 /// @brief Walk through the tree and manipulate each node.
 ///
@@ -0,0 +1,158 @@
+#ifndef __URB_TREE_VLOG_H_
+#define __URB_TREE_VLOG_H_
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+///
+/// @file urb_tree/vlog.h
+/// @author Issam SAID
+/// @brief The definition of the value logs (tiered values).
+/// @details A value log keeps the values of a tree in an append-only file
+/// mapped in memory, the keys and the nodes stay in memory. The value of 
+/// a node is then a handle (the offset and the length of the value in the
+/// log) instead of a pointer, and a read returns a pointer into the 
+/// mapping without any copy: a cold value is faulted in from the file.
+///
+/// The log is mapped once over a reserved range of addresses and the file
+/// grows inside it, so the pointers returned by urb_vlog_value stay valid 
+/// until the log is compacted or closed. The log is split in chunks of 
+/// URB_VLOG_CHUNK bytes and the chunks read or written are kept in a LRU 
+/// list: beyond the budget of resident bytes the least recently used 
+/// chunk is dropped from memory (madvise), it is read back from the file 
+/// on the next access. The chunks of the value being read or written are 
+/// kept, so a value larger than the budget leaves more chunks resident 
+/// (and counted) than the budget until the next access.
+///
+/// The popped values are left in the log as garbage, urb_vlog_compact 
+/// moves the live values to the front of the log and shrinks the file. A 
+/// value log is not a durable store: the file is truncated when opened.
+///
+#include <stdio.h>
+#include <stdint.h>
+#include <urb_tree/guard.h>
+#include <urb_tree/types.h>
+
+CPPGUARD_BEGIN();
+
+///
+/// @def URB_VLOG_CHUNK
+/// @brief The bytes of a chunk, the unit of the residency budget.
+///
+#define URB_VLOG_CHUNK (1UL << 16)
+
+///
+/// @def URB_VLOG_LENGTH_BITS
+/// @brief The bits of the length in a handle, the offset takes the others.
+///
+#define URB_VLOG_LENGTH_BITS 24
+
+///
+/// @brief Make a handle, and read the offset and the length of a handle.
+///
+#define URB_VLOG_HANDLE(offset, length) \
+    (((uint64_t)(offset) << URB_VLOG_LENGTH_BITS) | (uint64_t)(length))
+#define URB_VLOG_OFFSET(handle) ((uint64_t)(handle) >> URB_VLOG_LENGTH_BITS)
+#define URB_VLOG_LENGTH(handle) \
+    ((uint64_t)(handle) & ((1ULL << URB_VLOG_LENGTH_BITS) - 1))
+
+///
+/// @brief A chunk of the log in the LRU list.
+///
+typedef struct {
+    uint32_t prev;
+    uint32_t next;
+    uint32_t resident;
+} urb_vlog_chunk_t;
+
+///
+/// @brief A value log.
+///
+typedef struct {
+    int               fd;
+    uint8_t          *map;
+    size_t            reserve;   ///< the bytes of the mapping.
+    size_t            capacity;  ///< the bytes of the file.
+    size_t            size;      ///< the bytes appended.
+    size_t            garbage;   ///< the bytes of the popped values.
+    urb_vlog_chunk_t *chunks;
+    uint32_t          head;      ///< the most recently used chunk.
+    uint32_t          tail;      ///< the least recently used chunk.
+    size_t            resident;  ///< the resident chunks.
+    size_t            budget;    ///< the maximum resident chunks.
+    size_t            evictions; ///< the chunks dropped so far.
+} urb_vlog_t;
+
+///
+/// @brief Create a value log in a file (truncated), with reserve bytes of 
+///        addresses and budget resident bytes.
+///
+int urb_vlog_open(urb_vlog_t *vlog, const char *path, 
+                  size_t reserve, size_t budget);
+
+///
+/// @brief Unmap and close a value log, the file is left as is.
+///
+int urb_vlog_close(urb_vlog_t *vlog);
+
+///
+/// @brief Append a value to the log and return its handle.
+///
+uint64_t urb_vlog_append(urb_vlog_t *vlog, const void *data, size_t length);
+
+///
+/// @brief Return a pointer to the value of a handle in the mapping.
+///
+void *urb_vlog_read(urb_vlog_t *vlog, uint64_t handle);
+
+///
+/// @brief Append a value and insert the key with its handle into a tree.
+///
+int urb_vlog_put(urb_vlog_t *vlog, urb_t **urb, void *key, 
+                 const void *data, size_t length,
+                 int (*compare_key)(void*, void*));
+
+///
+/// @brief Return a pointer to the value of a node and store its length.
+///
+void *urb_vlog_value(urb_vlog_t *vlog, urb_t *n, size_t *length);
+
+///
+/// @brief Remove a key from a tree, its value becomes garbage in the log.
+///
+urb_t *urb_vlog_pop(urb_vlog_t *vlog, urb_t **urb, void *key,
+                    int (*compare_key)(void*, void*));
+
+///
+/// @brief Move the live values (the values of the tree) to the front of the
+///        log, update their handles and shrink the file.
+///
+int urb_vlog_compact(urb_vlog_t *vlog, urb_t **urb);
+
+CPPGUARD_END();
+
+#endif // __URB_TREE_VLOG_H_
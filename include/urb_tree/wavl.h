@@ -0,0 +1,77 @@
+#ifndef __URB_TREE_WAVL_H_
+#define __URB_TREE_WAVL_H_
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+///
+/// @file urb_tree/wavl.h
+/// @author Issam SAID
+/// @brief The definition of the WAVL (weak AVL) balancing routines.
+/// @details A WAVL tree is balanced with ranks instead of colors: the rank
+/// difference of a child is the rank of its parent minus its own rank, the
+/// sentinel has rank -1 and:
+///   1. The rank difference of every child is 1 or 2.
+///   2. Every leaf has rank 0 (its two missing children are 1-children).
+///
+/// Without deletions a WAVL tree is an AVL tree, with a height of at most
+/// 1.44 log n against 2 log n for a Red-Black tree, and it never gets 
+/// deeper than 2 log n. The insertions and deletions do at most two 
+/// rotations and O(1) amortized rank changes, but they are costlier than 
+/// the Red-Black ones, so a WAVL tree suits read-dominated workloads.
+///
+/// The balancing scheme is chosen per tree: a WAVL tree uses the urb_t 
+/// nodes (the rank replaces the color) and it is read with the usual 
+/// routines (urb_tree_find, urb_tree_min, urb_tree_succ, cursors, ...), 
+/// but it must only be updated with the routines below. A tree is checked
+/// with urb_wavl_check (see check.h).
+///
+#include <stdio.h>
+#include <urb_tree/guard.h>
+#include <urb_tree/types.h>
+
+CPPGUARD_BEGIN();
+
+///
+/// @brief Insert a node in a WAVL tree (the key must not exist).
+///
+int urb_wavl_put(urb_t **urb, urb_t *n, int (*compare_key)(void*, void*));
+
+///
+/// @brief Remove a key/value pair from a WAVL tree, the node is returned 
+///        (the sentinel if the key is not found).
+///
+urb_t *urb_wavl_pop(urb_t **urb, void *key, int (*compare_key)(void*, void*));
+
+///
+/// @brief Unlink a node of a WAVL tree, without any descent.
+///
+urb_t *urb_wavl_erase_node(urb_t **urb, urb_t *n);
+
+CPPGUARD_END();
+
+#endif // __URB_TREE_WAVL_H_
@@ -0,0 +1,172 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file urb_tree_bloom.c
+/// @author Issam SAID
+/// @brief Implement the Bloom filters in front of Red-Black trees.
+///
+/// @details For n keys and a false positive rate p the filter uses 
+/// m = -n ln(p) / ln(2)^2 slots, rounded up to a power of 2, and 
+/// k = m/n ln(2) probes. The i-th probe of a key is h1 + i*h2 where h1 and
+/// h2 are the two halves of the mixed hash (h2 is odd so the probes of a 
+/// key are distinct).
+///
+#include <math.h>
+#include <string.h>
+#include <stdlib.h>
+#include <urb_tree/bloom.h>
+#include <urb_tree/core.h>
+#include <urb_tree/util.h>
+#include <urb_tree/sentinel.h>
+#include <urb_tree/error.h>
+
+CPPGUARD_BEGIN();
+
+static void urb_bloom_add(urb_bloom_t *bloom, void *key) {
+    uint64_t h = urb_tree_mix(bloom->hash_key(key));
+    size_t   p = (size_t)h, q = (size_t)(h >> 32) | 1, s;
+    unsigned i;
+    for (i = 0; i < bloom->k; ++i, p += q) {
+        s = p & (bloom->m - 1);
+        if (bloom->counters == NULL) bloom->bits[s >> 6] |= 1ULL << (s & 63);
+        else if (bloom->counters[s] != UINT8_MAX) bloom->counters[s]++;
+    }
+    bloom->n++;
+}
+
+static void urb_bloom_remove(urb_bloom_t *bloom, void *key) {
+    uint64_t h = urb_tree_mix(bloom->hash_key(key));
+    size_t   p = (size_t)h, q = (size_t)(h >> 32) | 1, s;
+    unsigned i;
+    bloom->n--;
+    if (bloom->counters == NULL) { bloom->pops++; return; }
+    for (i = 0; i < bloom->k; ++i, p += q) {
+        s = p & (bloom->m - 1);
+        if (bloom->counters[s] != UINT8_MAX) bloom->counters[s]--;
+    }
+}
+
+bool urb_bloom_contains(urb_bloom_t *bloom, void *key) {
+    uint64_t h = urb_tree_mix(bloom->hash_key(key));
+    size_t   p = (size_t)h, q = (size_t)(h >> 32) | 1, s;
+    unsigned i;
+    for (i = 0; i < bloom->k; ++i, p += q) {
+        s = p & (bloom->m - 1);
+        if (bloom->counters == NULL) {
+            if (!(bloom->bits[s >> 6] & (1ULL << (s & 63)))) return false;
+        } else if (bloom->counters[s] == 0) return false;
+    }
+    return true;
+}
+
+int urb_bloom_init(urb_bloom_t *bloom, size_t capacity, double fp_rate, 
+                   uint64_t (*hash_key)(void*), bool counting) {
+    double m;
+    if (hash_key == NULL || fp_rate <= 0 || fp_rate >= 1) 
+        return URB_INVALID_VALUE;
+    memset(bloom, 0, sizeof(urb_bloom_t));
+    m = -(double)(capacity ? capacity : 1)*log(fp_rate)/(M_LN2*M_LN2);
+    for (bloom->m = 64; (double)bloom->m < m; bloom->m <<= 1);
+    bloom->k = (unsigned)(m/(capacity ? capacity : 1)*M_LN2 + 0.5);
+    if (bloom->k == 0) bloom->k = 1;
+    bloom->hash_key = hash_key;
+    if (counting) 
+        bloom->counters = (uint8_t *)calloc(bloom->m, sizeof(uint8_t));
+    else 
+        bloom->bits     = (uint64_t *)calloc(bloom->m/64, sizeof(uint64_t));
+    if (bloom->counters == NULL && bloom->bits == NULL)
+        URB_EXIT(URB_OUT_OF_MEMORY, "failed to allocate the Bloom filter");
+    return URB_SUCCESS;
+}
+
+void urb_bloom_delete(urb_bloom_t *bloom) {
+    free(bloom->bits);
+    free(bloom->counters);
+    bloom->bits     = NULL;
+    bloom->counters = NULL;
+}
+
+int urb_bloom_rebuild(urb_bloom_t *bloom, urb_t **urb) {
+    urb_t *i;
+    if (bloom->counters != NULL) 
+        memset(bloom->counters, 0, bloom->m*sizeof(uint8_t));
+    else 
+        memset(bloom->bits, 0, bloom->m/64*sizeof(uint64_t));
+    bloom->n    = 0;
+    bloom->pops = 0;
+    for (i = urb_tree_min(urb); i != NULL && i != &urb_sentinel; 
+         i = urb_tree_succ(i)) urb_bloom_add(bloom, i->key);
+    bloom->stats.rebuilds++;
+    return URB_SUCCESS;
+}
+
+int urb_bloom_put(urb_bloom_t *bloom, urb_t **urb, urb_t *n, 
+                  int (*compare_key)(void*, void*)) {
+    int ret = urb_tree_put(urb, n, compare_key);
+    if (ret == URB_SUCCESS) urb_bloom_add(bloom, n->key);
+    return ret;
+}
+
+urb_t *urb_bloom_find(urb_bloom_t *bloom, urb_t **urb, void *key, 
+                      int (*compare_key)(void*, void*)) {
+    urb_t *n;
+    bloom->stats.queries++;
+    if (!urb_bloom_contains(bloom, key)) {
+        bloom->stats.negatives++;
+        return &urb_sentinel;
+    }
+    if ((n = urb_tree_find(urb, key, compare_key)) == &urb_sentinel) 
+        bloom->stats.false_positives++;
+    return n;
+}
+
+urb_t *urb_bloom_pop(urb_bloom_t *bloom, urb_t **urb, void *key, 
+                     int (*compare_key)(void*, void*)) {
+    urb_t *n;
+    if (!urb_bloom_contains(bloom, key)) return &urb_sentinel;
+    n = urb_tree_pop(urb, key, compare_key);
+    if (n == NULL || n == &urb_sentinel) return n;
+    urb_bloom_remove(bloom, n->key);
+    if (bloom->counters == NULL && 
+        bloom->pops*URB_BLOOM_REBUILD > bloom->n + bloom->pops) 
+        urb_bloom_rebuild(bloom, urb);
+    return n;
+}
+
+void urb_bloom_stats(urb_bloom_t *bloom, urb_bloom_stats_t *stats) {
+    unsigned long long misses;
+    *stats = bloom->stats;
+    /// The lookups that should have been negatives.
+    misses = stats->negatives + stats->false_positives;
+    stats->fp_rate = misses ? (double)stats->false_positives/misses : 0;
+    stats->memory  = sizeof(urb_bloom_t) + (bloom->counters != NULL ? 
+                     bloom->m*sizeof(uint8_t) : bloom->m/8);
+    stats->bits_per_key = bloom->n ? 8.0*stats->memory/bloom->n : 0;
+}
+
+CPPGUARD_END();
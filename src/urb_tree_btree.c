@@ -0,0 +1,429 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file urb_tree_btree.c
+/// @author Issam SAID
+/// @brief Implement the cache-line B+tree engine for integer keys.
+///
+/// @details The rank of a key in a node (the number of node keys that are 
+/// less than the key) is computed over the whole (padded) key array without
+/// any branch: with AVX2 the 16 keys are compared 4 at a time and the masks
+/// are counted. Inner nodes route the keys equal to a separator to the 
+/// right, leaves are split in halves and the first key of the right half 
+/// becomes the separator. A node below URB_BTREE_MIN keys after a removal 
+/// borrows a key from a sibling or is merged with it.
+///
+#include <string.h>
+#include <stdlib.h>
+#include <urb_tree/btree.h>
+#include <urb_tree/error.h>
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define URB_BTREE_AVX2
+#endif
+
+CPPGUARD_BEGIN();
+
+#define URB_BTREE_MIN (URB_BTREE_ORDER/2)
+
+static int urb_btree_avx2 = -1;
+
+static urb_bnode_t *__bnode_create(int leaf) {
+    urb_bnode_t *n;
+    int i;
+    if (posix_memalign((void**)&n, 64, sizeof(urb_bnode_t)))
+        URB_EXIT(URB_OUT_OF_MEMORY, "failed to allocate a B+tree node");
+    memset(n, 0, sizeof(urb_bnode_t));
+    for (i = 0; i < URB_BTREE_ORDER; ++i) n->keys[i] = INT64_MAX;
+    n->leaf = leaf;
+    return n;
+}
+
+///
+/// @brief Reset the keys beyond count to INT64_MAX, they never rank.
+///
+static inline void __bnode_pad(urb_bnode_t *n) {
+    int i;
+    for (i = n->count; i < URB_BTREE_ORDER; ++i) n->keys[i] = INT64_MAX;
+}
+
+static inline int __bnode_rank_scalar(const int64_t *keys, int64_t key) {
+    int i, r = 0;
+    for (i = 0; i < URB_BTREE_ORDER; ++i) r += keys[i] < key;
+    return r;
+}
+
+#ifdef URB_BTREE_AVX2
+__attribute__((target("avx2,popcnt")))
+static int __bnode_rank_avx2(const int64_t *keys, int64_t key) {
+    const __m256i vkey = _mm256_set1_epi64x((long long)key);
+    int i, r = 0;
+    for (i = 0; i < URB_BTREE_ORDER; i += 4) {
+        __m256i lt = _mm256_cmpgt_epi64(vkey, 
+                         _mm256_load_si256((const __m256i *)(keys+i)));
+        r += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(lt)));
+    }
+    return r;
+}
+#endif
+
+static inline int __bnode_rank(const urb_bnode_t *n, int64_t key) {
+#ifdef URB_BTREE_AVX2
+    if (urb_btree_avx2) return __bnode_rank_avx2(n->keys, key);
+#endif
+    return __bnode_rank_scalar(n->keys, key);
+}
+
+///
+/// @brief The child of an inner node where a key is to be found.
+///
+static inline int __bnode_route(const urb_bnode_t *n, int64_t key) {
+    int r = __bnode_rank(n, key);
+    return r + (r < n->count && n->keys[r] == key);
+}
+
+static urb_bnode_t *__btree_leaf(urb_btree_t *btree, int64_t key) {
+    urb_bnode_t *n = btree->root;
+    while (!n->leaf) {
+        n = n->child[__bnode_route(n, key)];
+        __builtin_prefetch(n);
+        __builtin_prefetch((char*)n + 64);
+    }
+    return n;
+}
+
+urb_btree_t *urb_btree_create(void) {
+    urb_btree_t *btree = (urb_btree_t*)malloc(sizeof(urb_btree_t));
+    if (btree == NULL) 
+        URB_EXIT(URB_OUT_OF_MEMORY, "failed to allocate a B+tree");
+    if (urb_btree_avx2 < 0) {
+#ifdef URB_BTREE_AVX2
+        urb_btree_avx2 = __builtin_cpu_supports("avx2") != 0;
+#else
+        urb_btree_avx2 = 0;
+#endif
+    }
+    btree->root   = __bnode_create(1);
+    btree->n      = 0;
+    btree->height = 1;
+    return btree;
+}
+
+static void __bnode_delete(urb_bnode_t *n, void (*release_value)(void*)) {
+    int i;
+    if (n->leaf) {
+        if (release_value) 
+            for (i = 0; i < n->count; ++i) release_value(n->value[i]);
+    } else {
+        for (i = 0; i <= n->count; ++i) 
+            __bnode_delete(n->child[i], release_value);
+    }
+    free(n);
+}
+
+void urb_btree_delete(urb_btree_t *btree, void (*release_value)(void*)) {
+    if (btree == NULL) return;
+    __bnode_delete(btree->root, release_value);
+    free(btree);
+}
+
+///
+/// @brief Insert into the subtree of n, if n is split the separator and 
+///        the new right node are stored in up_key and up and 1 is returned.
+///
+static int __bnode_put(urb_bnode_t *n, int64_t key, void *value,
+                       int64_t *up_key, urb_bnode_t **up) {
+    const int half = URB_BTREE_ORDER/2;
+    int64_t keys[URB_BTREE_ORDER+1];
+    urb_bnode_t *child[URB_BTREE_ORDER+2], *s = NULL;
+    int r;
+    if (n->leaf) {
+        r = __bnode_rank(n, key);
+        if (r < n->count && n->keys[r] == key) 
+            URB_EXIT(URB_DUPLICATE_KEY, "key already exists");
+        if (n->count == URB_BTREE_ORDER) {
+            s = __bnode_create(1);
+            s->count = n->count - half;
+            memcpy(s->keys,  n->keys  + half, s->count*sizeof(int64_t));
+            memcpy(s->value, n->value + half, s->count*sizeof(void*));
+            n->count = half;
+            __bnode_pad(n);
+            s->next = n->next;
+            s->prev = n;
+            if (n->next) n->next->prev = s;
+            n->next = s;
+            /// The new key goes to the half where it belongs.
+            if (r >= half) { r -= half; n = s; }
+        }
+        memmove(n->keys  + r+1, n->keys  + r, (n->count-r)*sizeof(int64_t));
+        memmove(n->value + r+1, n->value + r, (n->count-r)*sizeof(void*));
+        n->keys[r]  = key;
+        n->value[r] = value;
+        n->count++;
+        if (s == NULL) return 0;
+        *up_key = s->keys[0];
+        *up     = s;
+        return 1;
+    }
+    r = __bnode_route(n, key);
+    if (!__bnode_put(n->child[r], key, value, up_key, up)) return 0;
+    /// The child was split: insert the separator at r and the new child at
+    /// r+1, if n is full the middle key of the ORDER+1 keys goes up.
+    if (n->count < URB_BTREE_ORDER) {
+        memmove(n->keys  + r+1, n->keys  + r, 
+                (n->count-r)*sizeof(int64_t));
+        memmove(n->child + r+2, n->child + r+1, 
+                (n->count-r)*sizeof(urb_bnode_t*));
+        n->keys[r]    = *up_key;
+        n->child[r+1] = *up;
+        n->count++;
+        return 0;
+    }
+    memcpy(keys,        n->keys,      r*sizeof(int64_t));
+    memcpy(keys  + r+1, n->keys  + r, (n->count-r)*sizeof(int64_t));
+    memcpy(child,       n->child,     (r+1)*sizeof(urb_bnode_t*));
+    memcpy(child + r+2, n->child + r+1, (n->count-r)*sizeof(urb_bnode_t*));
+    keys[r]    = *up_key;
+    child[r+1] = *up;
+    s = __bnode_create(0);
+    n->count = half;
+    s->count = URB_BTREE_ORDER - half;
+    memcpy(n->keys,  keys,  half*sizeof(int64_t));
+    memcpy(n->child, child, (half+1)*sizeof(urb_bnode_t*));
+    memcpy(s->keys,  keys  + half+1, s->count*sizeof(int64_t));
+    memcpy(s->child, child + half+1, (s->count+1)*sizeof(urb_bnode_t*));
+    __bnode_pad(n);
+    *up_key = keys[half];
+    *up     = s;
+    return 1;
+}
+
+int urb_btree_put(urb_btree_t *btree, int64_t key, void *value) {
+    int64_t up_key;
+    urb_bnode_t *up, *root;
+    if (__bnode_put(btree->root, key, value, &up_key, &up)) {
+        root = __bnode_create(0);
+        root->keys[0]  = up_key;
+        root->child[0] = btree->root;
+        root->child[1] = up;
+        root->count    = 1;
+        btree->root    = root;
+        btree->height++;
+    }
+    btree->n++;
+    return URB_SUCCESS;
+}
+
+urb_bpos_t urb_btree_find(urb_btree_t *btree, int64_t key) {
+    urb_bpos_t pos;
+    urb_bnode_t *n = __btree_leaf(btree, key);
+    int r = __bnode_rank(n, key);
+    pos.leaf  = (r < n->count && n->keys[r] == key) ? n : NULL;
+    pos.index = r;
+    return pos;
+}
+
+///
+/// @brief Refill the child i of n which has less than URB_BTREE_MIN keys,
+///        from its left or right sibling or by merging.
+///
+static void __bnode_fix(urb_bnode_t *n, int i) {
+    urb_bnode_t *c = n->child[i], *l, *r;
+    l = i > 0        ? n->child[i-1] : NULL;
+    r = i < n->count ? n->child[i+1] : NULL;
+    if (l && l->count > URB_BTREE_MIN) {
+        memmove(c->keys + 1, c->keys, c->count*sizeof(int64_t));
+        if (c->leaf) {
+            memmove(c->value + 1, c->value, c->count*sizeof(void*));
+            c->keys[0]    = l->keys[l->count-1];
+            c->value[0]   = l->value[l->count-1];
+            n->keys[i-1]  = c->keys[0];
+        } else {
+            memmove(c->child + 1, c->child, (c->count+1)*sizeof(urb_bnode_t*));
+            c->keys[0]    = n->keys[i-1];
+            c->child[0]   = l->child[l->count];
+            n->keys[i-1]  = l->keys[l->count-1];
+        }
+        c->count++;
+        l->count--;
+        __bnode_pad(l);
+        return;
+    }
+    if (r && r->count > URB_BTREE_MIN) {
+        if (c->leaf) {
+            c->keys[c->count]    = r->keys[0];
+            c->value[c->count]   = r->value[0];
+            memmove(r->value, r->value + 1, (r->count-1)*sizeof(void*));
+            memmove(r->keys,  r->keys  + 1, (r->count-1)*sizeof(int64_t));
+            n->keys[i]           = r->keys[0];
+        } else {
+            c->keys[c->count]    = n->keys[i];
+            c->child[c->count+1] = r->child[0];
+            n->keys[i]           = r->keys[0];
+            memmove(r->keys,  r->keys  + 1, (r->count-1)*sizeof(int64_t));
+            memmove(r->child, r->child + 1, r->count*sizeof(urb_bnode_t*));
+        }
+        c->count++;
+        r->count--;
+        __bnode_pad(r);
+        return;
+    }
+    /// Merge the child i-1 with the child i or the child i with i+1.
+    if (l) { r = c; i--; } else { l = c; }
+    if (l->leaf) {
+        memcpy(l->keys  + l->count, r->keys,  r->count*sizeof(int64_t));
+        memcpy(l->value + l->count, r->value, r->count*sizeof(void*));
+        l->count += r->count;
+        l->next   = r->next;
+        if (r->next) r->next->prev = l;
+    } else {
+        l->keys[l->count] = n->keys[i];
+        memcpy(l->keys  + l->count+1, r->keys,  r->count*sizeof(int64_t));
+        memcpy(l->child + l->count+1, r->child, 
+               (r->count+1)*sizeof(urb_bnode_t*));
+        l->count += r->count + 1;
+    }
+    free(r);
+    memmove(n->keys  + i,   n->keys  + i+1, (n->count-i-1)*sizeof(int64_t));
+    memmove(n->child + i+1, n->child + i+2, 
+            (n->count-i-1)*sizeof(urb_bnode_t*));
+    n->count--;
+    __bnode_pad(n);
+}
+
+static bool __bnode_pop(urb_bnode_t *n, int64_t key, void **value) {
+    int r;
+    if (n->leaf) {
+        r = __bnode_rank(n, key);
+        if (r == n->count || n->keys[r] != key) return false;
+        if (value) *value = n->value[r];
+        memmove(n->keys  + r, n->keys  + r+1, (n->count-r-1)*sizeof(int64_t));
+        memmove(n->value + r, n->value + r+1, (n->count-r-1)*sizeof(void*));
+        n->count--;
+        __bnode_pad(n);
+        return true;
+    }
+    r = __bnode_route(n, key);
+    if (!__bnode_pop(n->child[r], key, value)) return false;
+    if (n->child[r]->count < URB_BTREE_MIN) __bnode_fix(n, r);
+    return true;
+}
+
+bool urb_btree_pop(urb_btree_t *btree, int64_t key, void **value) {
+    urb_bnode_t *root = btree->root;
+    if (!__bnode_pop(root, key, value)) return false;
+    if (!root->leaf && root->count == 0) {
+        btree->root = root->child[0];
+        btree->height--;
+        free(root);
+    }
+    btree->n--;
+    return true;
+}
+
+urb_bpos_t urb_btree_min(urb_btree_t *btree) {
+    urb_bpos_t pos;
+    urb_bnode_t *n = btree->root;
+    while (!n->leaf) n = n->child[0];
+    pos.leaf  = n->count ? n : NULL;
+    pos.index = 0;
+    return pos;
+}
+
+urb_bpos_t urb_btree_max(urb_btree_t *btree) {
+    urb_bpos_t pos;
+    urb_bnode_t *n = btree->root;
+    while (!n->leaf) n = n->child[n->count];
+    pos.leaf  = n->count ? n : NULL;
+    pos.index = n->count-1;
+    return pos;
+}
+
+urb_bpos_t urb_btree_succ(urb_bpos_t pos) {
+    if (pos.leaf == NULL) return pos;
+    if (++pos.index == pos.leaf->count) {
+        pos.leaf  = pos.leaf->next;
+        pos.index = 0;
+    }
+    return pos;
+}
+
+urb_bpos_t urb_btree_prev(urb_bpos_t pos) {
+    if (pos.leaf == NULL) return pos;
+    if (pos.index-- == 0) {
+        pos.leaf  = pos.leaf->prev;
+        pos.index = pos.leaf ? pos.leaf->count-1 : 0;
+    }
+    return pos;
+}
+
+int64_t urb_btree_key(urb_bpos_t pos) { return pos.leaf->keys[pos.index]; }
+
+void *urb_btree_value(urb_bpos_t pos) { return pos.leaf->value[pos.index]; }
+
+size_t urb_btree_size(urb_btree_t *btree) { return btree->n; }
+
+///
+/// @brief Check the subtree of n against the bounds [lo, hi), the depth of
+///        each leaf must be height and each node but the root must have at 
+///        least URB_BTREE_MIN keys.
+///
+static bool __bnode_check(urb_bnode_t *n, int64_t lo, int64_t hi, bool root,
+                          size_t depth, size_t height, size_t *count) {
+    int i;
+    if (n->count > URB_BTREE_ORDER || (!root && n->count < URB_BTREE_MIN)) 
+        return false;
+    for (i = 0; i < n->count; ++i) {
+        if (n->keys[i] < lo || (n->keys[i] >= hi && hi != INT64_MAX)) 
+            return false;
+        if (i && n->keys[i-1] >= n->keys[i]) return false;
+    }
+    for (; i < URB_BTREE_ORDER; ++i) if (n->keys[i] != INT64_MAX) return false;
+    if (n->leaf) {
+        *count += n->count;
+        return depth == height;
+    }
+    for (i = 0; i <= n->count; ++i) {
+        if (!__bnode_check(n->child[i], i ? n->keys[i-1] : lo, 
+                           i < n->count ? n->keys[i] : hi, false, 
+                           depth+1, height, count)) return false;
+    }
+    return true;
+}
+
+bool urb_btree_check(urb_btree_t *btree) {
+    size_t count = 0, scanned = 0;
+    urb_bpos_t pos;
+    if (!__bnode_check(btree->root, INT64_MIN, INT64_MAX, true, 1, 
+                       btree->height, &count)) return false;
+    for (pos = urb_btree_min(btree); pos.leaf; pos = urb_btree_succ(pos)) 
+        scanned++;
+    return count == btree->n && scanned == btree->n;
+}
+
+CPPGUARD_END();
@@ -0,0 +1,183 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file urb_tree_cache.c
+/// @author Issam SAID
+/// @brief Implement the node caches of Red-Black trees.
+///
+/// @details The free nodes are chained through their left link. The pool 
+/// is a stack of chains (linked through the parent link of their first 
+/// node, which also stores the length of the chain in its key), so that a 
+/// batch is moved in and out of the pool in constant time under the lock.
+///
+#include <stdint.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <urb_tree/cache.h>
+#include <urb_tree/compact.h>
+#include <urb_tree/error.h>
+
+CPPGUARD_BEGIN();
+
+typedef struct {
+    urb_t *head;
+    size_t count;
+    urb_cache_stats_t stats;
+} urb_cache_t;
+
+static __thread urb_cache_t urb_cache_local = { NULL, 0, { 0 } };
+
+static urb_t          *urb_cache_pool       = NULL;
+static size_t          urb_cache_pool_count = 0;
+static pthread_mutex_t urb_cache_lock       = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t  urb_cache_once       = PTHREAD_ONCE_INIT;
+static pthread_key_t   urb_cache_key;
+
+#define CHAIN_LENGTH(n) ((size_t)(uintptr_t)(n)->key)
+
+static void urb_cache_free_chain(urb_t *n) {
+    urb_t *next;
+    for (; n != NULL; n = next) { next = n->left; free(n); }
+}
+
+///
+/// @brief Push a chain of count nodes to the pool (or free it if full).
+///
+static void urb_cache_push(urb_t *head, size_t count) {
+    pthread_mutex_lock(&urb_cache_lock);
+    if (urb_cache_pool_count + count <= URB_TREE_POOL_SIZE) {
+        head->key            = (void*)(uintptr_t)count;
+        head->parent         = urb_cache_pool;
+        __atomic_store_n(&urb_cache_pool, head, __ATOMIC_RELAXED);
+        urb_cache_pool_count += count;
+        head = NULL;
+    }
+    pthread_mutex_unlock(&urb_cache_lock);
+    urb_cache_free_chain(head);
+}
+
+static void urb_cache_detach(void *ptr) {
+    urb_cache_t *c = (urb_cache_t *)ptr;
+    if (c->head != NULL) urb_cache_push(c->head, c->count);
+    c->head  = NULL;
+    c->count = 0;
+}
+
+static void urb_cache_init(void) {
+    pthread_key_create(&urb_cache_key, urb_cache_detach);
+}
+
+///
+/// @brief Make sure that the cache is flushed when the thread exits, 
+///        called when an empty cache is about to get nodes.
+///
+static inline void urb_cache_register(urb_cache_t *c) {
+    pthread_once(&urb_cache_once, urb_cache_init);
+    pthread_setspecific(urb_cache_key, c);
+}
+
+urb_t *urb_tree_cache_get(void) {
+    urb_cache_t *c = &urb_cache_local;
+    urb_t *n;
+    if (c->head == NULL && 
+        __atomic_load_n(&urb_cache_pool, __ATOMIC_RELAXED) != NULL) {
+        pthread_mutex_lock(&urb_cache_lock);
+        if ((n = urb_cache_pool) != NULL) {
+            urb_cache_register(c);
+            __atomic_store_n(&urb_cache_pool, n->parent, __ATOMIC_RELAXED);
+            urb_cache_pool_count -= CHAIN_LENGTH(n);
+            c->head  = n;
+            c->count = CHAIN_LENGTH(n);
+            c->stats.refills++;
+        }
+        pthread_mutex_unlock(&urb_cache_lock);
+    }
+    if ((n = c->head) != NULL) {
+        c->head = n->left;
+        c->count--;
+        c->stats.hits++;
+        return n;
+    }
+    c->stats.misses++;
+    if ((n = (urb_t *)malloc(sizeof(urb_t))) == NULL) 
+        URB_EXIT(URB_OUT_OF_MEMORY, "failed to allocate urb_tree pair");       
+    return n;
+}
+
+void urb_tree_release(urb_t *n) {
+    urb_cache_t *c = &urb_cache_local;
+    urb_t *i;
+    size_t k;
+    if (n == NULL) return;
+    /// The nodes of a compacted slab are not freed one by one.
+    if (n->flags & URB_NODE_SLAB) { urb_tree_node_free(n); return; }
+    if (c->count == 0) {
+        urb_cache_register(c);
+    } else if (c->count == URB_TREE_CACHE_SIZE) {
+        /// Spill the oldest nodes, the most recently released stay.
+        for (i = c->head, k = 1; 
+             k < URB_TREE_CACHE_SIZE - URB_TREE_CACHE_BATCH; ++k) i = i->left;
+        urb_cache_push(i->left, URB_TREE_CACHE_BATCH);
+        i->left   = NULL;
+        c->count -= URB_TREE_CACHE_BATCH;
+        c->stats.spills++;
+    }
+    n->left = c->head;
+    c->head = n;
+    c->count++;
+    c->stats.releases++;
+}
+
+void urb_tree_cache_flush(void) { urb_cache_detach(&urb_cache_local); }
+
+void urb_tree_cache_trim(void) {
+    urb_cache_t *c = &urb_cache_local;
+    urb_t *pool, *next;
+    pthread_mutex_lock(&urb_cache_lock);
+    pool = urb_cache_pool;
+    __atomic_store_n(&urb_cache_pool, NULL, __ATOMIC_RELAXED);
+    urb_cache_pool_count = 0;
+    pthread_mutex_unlock(&urb_cache_lock);
+    for (; pool != NULL; pool = next) {
+        next = pool->parent;
+        urb_cache_free_chain(pool);
+    }
+    urb_cache_free_chain(c->head);
+    c->head  = NULL;
+    c->count = 0;
+}
+
+void urb_tree_cache_stats(urb_cache_stats_t *stats) {
+    *stats        = urb_cache_local.stats;
+    stats->local  = urb_cache_local.count;
+    pthread_mutex_lock(&urb_cache_lock);
+    stats->global = urb_cache_pool_count;
+    pthread_mutex_unlock(&urb_cache_lock);
+}
+
+CPPGUARD_END();
@@ -111,4 +111,25 @@ void urb_tree_check_invariant_4(urb_t **urb) {
     __check_black_count_allpaths(urb, 0, __get_black_count(urb));
 }
 
+///
+/// @brief Check the rank rules of a WAVL tree, the sentinel has rank -1.
+///
+static bool __check_wavl_ranks(urb_t *n, urb_t *parent) {
+    int d, rank;
+    if (n == &urb_sentinel) return true;
+    if (n->parent != parent) return false;
+    if (n->left == &urb_sentinel && n->right == &urb_sentinel && n->rank)
+        return false;
+    for (d = 0; d < 2; ++d) {
+        rank = n->child[d] == &urb_sentinel ? -1 : n->child[d]->rank;
+        if (n->rank - rank != 1 && n->rank - rank != 2) return false;
+        if (!__check_wavl_ranks(n->child[d], n)) return false;
+    }
+    return true;
+}
+
+bool urb_wavl_check(urb_t **urb) {
+    return __check_wavl_ranks(*urb, NULL);
+}
+
 CPPGUARD_END();
\ No newline at end of file
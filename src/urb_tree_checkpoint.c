@@ -0,0 +1,498 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+///
+/// @file urb_tree_checkpoint.c
+/// @author Issam SAID
+/// @brief Implement the incremental (delta) checkpoints of Red-Black trees.
+///
+/// @details A file is a header followed by the tombstones (key_size bytes 
+/// each) then the records (key_size + value_size bytes each), both sorted
+/// by key. The number of records is only known at the end of a walk, it 
+/// is written back into the header. 
+///
+/// The merge applies the chain on a tree of entries, an entry records 
+/// whether its key was removed (a tombstone, which is written when the 
+/// output is a delta) and whether it holds a value (a record).
+///
+#define _GNU_SOURCE
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <urb_tree/checkpoint.h>
+#include <urb_tree/core.h>
+#include <urb_tree/util.h>
+#include <urb_tree/cache.h>
+#include <urb_tree/sentinel.h>
+#include <urb_tree/error.h>
+
+CPPGUARD_BEGIN();
+
+#define URB_CHECKPOINT_MAGIC "URBCKPT0"
+
+///
+/// @brief The header of a checkpoint file.
+///
+typedef struct {
+    char     magic[8];
+    uint32_t base;          ///< 1 for a base file, 0 for a delta.
+    uint32_t key_size;
+    uint32_t value_size;
+    uint32_t unused;
+    uint64_t tombstones;
+    uint64_t records;
+} urb_checkpoint_header_t;
+
+///
+/// @brief An entry of a merge: the flags, then the key and the value.
+///
+typedef struct {
+    uint32_t tombstone;
+    uint32_t record;
+} urb_checkpoint_entry_t;
+
+#define URB_ENTRY(key) \
+    ((urb_checkpoint_entry_t *)((unsigned char *)(key) - \
+                                sizeof(urb_checkpoint_entry_t)))
+
+static int urb_checkpoint_compare(const void *a, const void *b, void *arg) {
+    return ((int (*)(void*, void*))arg)((void*)a, (void*)b);
+}
+
+int urb_checkpoint_init(urb_checkpoint_t *checkpoint, urb_t **urb,
+                        size_t key_size, size_t value_size, 
+                        size_t max_deltas, int (*compare_key)(void*, void*)) {
+    if (key_size == 0 || compare_key == NULL) return URB_INVALID_VALUE;
+    checkpoint->urb         = urb;
+    checkpoint->key_size    = key_size;
+    checkpoint->value_size  = value_size;
+    checkpoint->compare_key = compare_key;
+    checkpoint->tombstones  = NULL;
+    checkpoint->removed     = 0;
+    checkpoint->capacity    = 0;
+    checkpoint->max_deltas  = max_deltas;
+    checkpoint->chain       = NULL;
+    checkpoint->length      = 0;
+    checkpoint->deltas      = 0;
+    checkpoint->written     = 0;
+    return URB_SUCCESS;
+}
+
+static void urb_checkpoint_clear_chain(urb_checkpoint_t *checkpoint) {
+    size_t i;
+    for (i = 0; i < checkpoint->length; ++i) free(checkpoint->chain[i]);
+    free(checkpoint->chain);
+    checkpoint->chain  = NULL;
+    checkpoint->length = 0;
+    checkpoint->deltas = 0;
+}
+
+static void urb_checkpoint_append_chain(urb_checkpoint_t *checkpoint, 
+                                        const char *path) {
+    checkpoint->chain = (char **)realloc(checkpoint->chain, 
+                            (checkpoint->length + 1)*sizeof(char*));
+    if (checkpoint->chain == NULL || 
+        (checkpoint->chain[checkpoint->length++] = strdup(path)) == NULL)
+        URB_EXIT(URB_OUT_OF_MEMORY, "failed to allocate the chain");
+}
+
+int urb_checkpoint_delete(urb_checkpoint_t *checkpoint) {
+    urb_checkpoint_clear_chain(checkpoint);
+    free(checkpoint->tombstones);
+    checkpoint->tombstones = NULL;
+    return URB_SUCCESS;
+}
+
+///
+/// @brief Mark a node dirty and its ancestors up to the first one already
+///        marked.
+///
+static void urb_checkpoint_mark(urb_t *n) {
+    n->flags |= URB_NODE_DIRTY;
+    for (n = n->parent; n && n != &urb_sentinel && 
+         !(n->flags & URB_NODE_DIRTY_BELOW); n = n->parent) 
+        n->flags |= URB_NODE_DIRTY_BELOW;
+}
+
+int urb_checkpoint_put(urb_checkpoint_t *checkpoint, urb_t *n) {
+    int ret = urb_tree_put(checkpoint->urb, n, checkpoint->compare_key);
+    urb_checkpoint_mark(n);
+    return ret;
+}
+
+urb_t *urb_checkpoint_pop(urb_checkpoint_t *checkpoint, void *key) {
+    urb_t *n = urb_tree_pop(checkpoint->urb, key, checkpoint->compare_key);
+    if (n == &urb_sentinel) return n;
+    if (checkpoint->removed == checkpoint->capacity) {
+        checkpoint->capacity = checkpoint->capacity ? 
+                               2*checkpoint->capacity : 64;
+        checkpoint->tombstones = (unsigned char *)realloc(
+            checkpoint->tombstones, checkpoint->capacity*checkpoint->key_size);
+        if (checkpoint->tombstones == NULL)
+            URB_EXIT(URB_OUT_OF_MEMORY, "failed to allocate the tombstones");
+    }
+    memcpy(checkpoint->tombstones + checkpoint->removed*checkpoint->key_size,
+           n->key, checkpoint->key_size);
+    checkpoint->removed++;
+    n->flags &= ~URB_NODE_DIRTY_MASK;
+    return n;
+}
+
+void urb_checkpoint_touch(urb_checkpoint_t *checkpoint, urb_t *n) {
+    (void)checkpoint;
+    urb_checkpoint_mark(n);
+}
+
+///
+/// @brief Open a checkpoint file and write its header, the records count 
+///        is written by urb_checkpoint_close.
+///
+static FILE *urb_checkpoint_open(const char *path, bool base, 
+                                 size_t key_size, size_t value_size, 
+                                 size_t tombstones) {
+    urb_checkpoint_header_t h;
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) return NULL;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, URB_CHECKPOINT_MAGIC, sizeof(h.magic));
+    h.base       = base;
+    h.key_size   = (uint32_t)key_size;
+    h.value_size = (uint32_t)value_size;
+    h.tombstones = tombstones;
+    if (fwrite(&h, sizeof(h), 1, f) != 1) { fclose(f); return NULL; }
+    return f;
+}
+
+static int urb_checkpoint_close(FILE *f, size_t records) {
+    uint64_t r = records;
+    int ok = fseek(f, offsetof(urb_checkpoint_header_t, records), SEEK_SET) 
+             == 0 && fwrite(&r, sizeof(r), 1, f) == 1;
+    if (fclose(f) || !ok) return URB_IO_ERROR;
+    return URB_SUCCESS;
+}
+
+static int urb_checkpoint_write(FILE *f, const void *data, size_t size) {
+    static const unsigned char zero[64] = { 0 };
+    size_t s;
+    if (data) return fwrite(data, 1, size, f) == size ? 0 : -1;
+    /// A missing value is written as zeros.
+    for (; size; size -= s) {
+        s = size < sizeof(zero) ? size : sizeof(zero);
+        if (fwrite(zero, 1, s, f) != s) return -1;
+    }
+    return 0;
+}
+
+///
+/// @brief Write the dirty records (or all of them) in the keys order, only
+///        the marked subtrees are visited. The marks are kept until the 
+///        file is complete.
+///
+static int urb_checkpoint_walk(urb_checkpoint_t *checkpoint, urb_t *n, 
+                               FILE *f, bool all) {
+    if (n == &urb_sentinel) return 0;
+    if (!all && !(n->flags & URB_NODE_DIRTY_MASK)) return 0;
+    if (urb_checkpoint_walk(checkpoint, n->left, f, all)) return -1;
+    if (all || (n->flags & URB_NODE_DIRTY)) {
+        if (urb_checkpoint_write(f, n->key, checkpoint->key_size) ||
+            urb_checkpoint_write(f, n->value, checkpoint->value_size)) 
+            return -1;
+        checkpoint->written++;
+    }
+    return urb_checkpoint_walk(checkpoint, n->right, f, all);
+}
+
+///
+/// @brief Clear the marks of the marked subtrees.
+///
+static void urb_checkpoint_clear(urb_t *n) {
+    if (n == &urb_sentinel || !(n->flags & URB_NODE_DIRTY_MASK)) return;
+    n->flags &= ~URB_NODE_DIRTY_MASK;
+    urb_checkpoint_clear(n->left);
+    urb_checkpoint_clear(n->right);
+}
+
+///
+/// @brief Write a base or a delta file of the tree to path.tmp, then 
+///        rename it to path. The marks and the tombstones are dropped once
+///        the file is in place, a failed save can be retried.
+///
+static int urb_checkpoint_save(urb_checkpoint_t *checkpoint, 
+                               const char *path, bool base) {
+    size_t tombstones = base ? 0 : checkpoint->removed;
+    char *tmp = (char *)malloc(strlen(path) + 8);
+    FILE *f;
+    int ret;
+    if (tmp == NULL) 
+        URB_EXIT(URB_OUT_OF_MEMORY, "failed to allocate the chain");
+    sprintf(tmp, "%s.tmp", path);
+    if ((f = urb_checkpoint_open(tmp, base, checkpoint->key_size, 
+                                 checkpoint->value_size, tombstones)) 
+        == NULL) {
+        remove(tmp);
+        free(tmp);
+        return URB_IO_ERROR;
+    }
+    if (tombstones)
+        qsort_r(checkpoint->tombstones, tombstones, checkpoint->key_size,
+                urb_checkpoint_compare, (void*)checkpoint->compare_key);
+    checkpoint->written = 0;
+    if ((tombstones && 
+         urb_checkpoint_write(f, checkpoint->tombstones, 
+                              tombstones*checkpoint->key_size)) ||
+        urb_checkpoint_walk(checkpoint, *checkpoint->urb, f, base)) {
+        fclose(f);
+        ret = URB_IO_ERROR;
+    } else {
+        ret = urb_checkpoint_close(f, checkpoint->written);
+    }
+    if (ret == URB_SUCCESS && rename(tmp, path)) ret = URB_IO_ERROR;
+    if (ret != URB_SUCCESS) remove(tmp);
+    free(tmp);
+    if (ret != URB_SUCCESS) return ret;
+    urb_checkpoint_clear(*checkpoint->urb);
+    checkpoint->removed = 0;
+    return URB_SUCCESS;
+}
+
+int urb_checkpoint_base(urb_checkpoint_t *checkpoint, const char *path) {
+    int ret = urb_checkpoint_save(checkpoint, path, true);
+    if (ret != URB_SUCCESS) return ret;
+    urb_checkpoint_clear_chain(checkpoint);
+    urb_checkpoint_append_chain(checkpoint, path);
+    return URB_SUCCESS;
+}
+
+int urb_checkpoint_delta(urb_checkpoint_t *checkpoint, const char *path) {
+    size_t i, first;
+    char *merged;
+    int ret = urb_checkpoint_save(checkpoint, path, false);
+    if (ret != URB_SUCCESS) return ret;
+    urb_checkpoint_append_chain(checkpoint, path);
+    checkpoint->deltas++;
+    if (checkpoint->max_deltas == 0 || 
+        checkpoint->deltas <= checkpoint->max_deltas) return URB_SUCCESS;
+    /// Merge the deltas into the last one.
+    first  = checkpoint->length - checkpoint->deltas;
+    merged = (char *)malloc(strlen(path) + 8);
+    if (merged == NULL) 
+        URB_EXIT(URB_OUT_OF_MEMORY, "failed to allocate the chain");
+    sprintf(merged, "%s.merge", path);
+    ret = urb_checkpoint_merge((const char **)checkpoint->chain + first, 
+                               checkpoint->deltas, merged, 
+                               checkpoint->compare_key);
+    if (ret == URB_SUCCESS && rename(merged, path)) ret = URB_IO_ERROR;
+    if (ret != URB_SUCCESS) remove(merged);
+    free(merged);
+    if (ret != URB_SUCCESS) return ret;
+    for (i = first; i < checkpoint->length - 1; ++i) {
+        remove(checkpoint->chain[i]);
+        free(checkpoint->chain[i]);
+    }
+    checkpoint->chain[first] = checkpoint->chain[checkpoint->length - 1];
+    checkpoint->length       = first + 1;
+    checkpoint->deltas       = 1;
+    return URB_SUCCESS;
+}
+
+///
+/// @brief The state of a recovery or of a merge.
+///
+typedef struct {
+    urb_t **urb;
+    size_t  key_size;
+    size_t  value_size;
+    size_t  offset;     ///< the bytes before the key in a block.
+    int   (*compare_key)(void*, void*);
+} urb_checkpoint_apply_t;
+
+///
+/// @brief Read a checkpoint file and hand each tombstone then each record 
+///        to apply, the sizes must match the ones of the first file.
+///
+static int urb_checkpoint_read(const char *path, 
+                               urb_checkpoint_header_t *first,
+                               void (*apply)(urb_checkpoint_apply_t*, 
+                                             unsigned char*, 
+                                             unsigned char*, bool),
+                               urb_checkpoint_apply_t *a) {
+    urb_checkpoint_header_t h;
+    unsigned char *buffer;
+    uint64_t i;
+    size_t size;
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) return URB_IO_ERROR;
+    if (fread(&h, sizeof(h), 1, f) != 1 || 
+        memcmp(h.magic, URB_CHECKPOINT_MAGIC, sizeof(h.magic)) || 
+        (first->key_size && (h.key_size   != first->key_size || 
+                             h.value_size != first->value_size))) {
+        fclose(f);
+        return URB_INVALID_VALUE;
+    }
+    if (first->key_size == 0) *first = h;
+    a->key_size   = h.key_size;
+    a->value_size = h.value_size;
+    size   = h.key_size + h.value_size;
+    buffer = (unsigned char *)malloc(size ? size : 1);
+    if (buffer == NULL) 
+        URB_EXIT(URB_OUT_OF_MEMORY, "failed to allocate a record");
+    for (i = 0; i < h.tombstones + h.records; ++i) {
+        bool tombstone = i < h.tombstones;
+        size_t s = tombstone ? h.key_size : size;
+        if (fread(buffer, 1, s, f) != s) break;
+        apply(a, buffer, buffer + h.key_size, tombstone);
+    }
+    free(buffer);
+    fclose(f);
+    return i == h.tombstones + h.records ? URB_SUCCESS : URB_IO_ERROR;
+}
+
+///
+/// @brief Find the node of a key, or insert a new block for it.
+///
+static urb_t *urb_checkpoint_upsert(urb_checkpoint_apply_t *a, 
+                                    unsigned char *key) {
+    unsigned char *block;
+    urb_t *n = urb_tree_find(a->urb, key, a->compare_key);
+    if (n != &urb_sentinel) return n;
+    block = (unsigned char *)calloc(1, a->offset + a->key_size + 
+                                       a->value_size);
+    if (block == NULL) 
+        URB_EXIT(URB_OUT_OF_MEMORY, "failed to allocate a record");
+    memcpy(block + a->offset, key, a->key_size);
+    n = urb_tree_create(block + a->offset, 
+                        block + a->offset + a->key_size);
+    urb_tree_put(a->urb, n, a->compare_key);
+    return n;
+}
+
+static void urb_checkpoint_recover_one(urb_checkpoint_apply_t *a, 
+                                       unsigned char *key, 
+                                       unsigned char *value, bool tombstone) {
+    urb_t *n;
+    if (tombstone) {
+        n = urb_tree_pop(a->urb, key, a->compare_key);
+        if (n == &urb_sentinel) return;
+        free(n->key);
+        urb_tree_release(n);
+        return;
+    }
+    n = urb_checkpoint_upsert(a, key);
+    memcpy(n->value, value, a->value_size);
+}
+
+static void urb_checkpoint_merge_one(urb_checkpoint_apply_t *a, 
+                                     unsigned char *key, 
+                                     unsigned char *value, bool tombstone) {
+    urb_t *n = urb_checkpoint_upsert(a, key);
+    if (tombstone) {
+        URB_ENTRY(n->key)->tombstone = 1;
+        URB_ENTRY(n->key)->record    = 0;
+    } else {
+        URB_ENTRY(n->key)->record    = 1;
+        memcpy(n->value, value, a->value_size);
+    }
+}
+
+static void urb_checkpoint_entry_free(void *key) { free(URB_ENTRY(key)); }
+
+int urb_checkpoint_recover(urb_t **urb, const char **paths, size_t n,
+                           int (*compare_key)(void*, void*)) {
+    urb_checkpoint_header_t first;
+    urb_checkpoint_apply_t a = { urb, 0, 0, 0, compare_key };
+    size_t i;
+    int ret;
+    memset(&first, 0, sizeof(first));
+    for (i = 0; i < n; ++i) {
+        ret = urb_checkpoint_read(paths[i], &first, 
+                                  urb_checkpoint_recover_one, &a);
+        if (ret != URB_SUCCESS) return ret;
+    }
+    return URB_SUCCESS;
+}
+
+///
+/// @brief Write the entries of a merge, in the keys order.
+///
+static int urb_checkpoint_merge_write(urb_t **entries, const char *output,
+                                      urb_checkpoint_header_t *first) {
+    urb_t *e;
+    size_t tombstones = 0, records = 0;
+    int pass, failed = 0;
+    FILE *f;
+    /// The tombstones of a base are applied, they are not written.
+    for (e = urb_tree_min(entries); e && e != &urb_sentinel; 
+         e = urb_tree_succ(e)) 
+        tombstones += !first->base && URB_ENTRY(e->key)->tombstone;
+    f = urb_checkpoint_open(output, first->base, first->key_size, 
+                            first->value_size, tombstones);
+    if (f == NULL) return URB_IO_ERROR;
+    for (pass = 0; pass < 2 && !failed; ++pass) {
+        for (e = urb_tree_min(entries); 
+             e && e != &urb_sentinel && !failed; e = urb_tree_succ(e)) {
+            urb_checkpoint_entry_t *entry = URB_ENTRY(e->key);
+            if (pass == 0 && tombstones && entry->tombstone) {
+                failed = urb_checkpoint_write(f, e->key, first->key_size);
+            } else if (pass == 1 && entry->record) {
+                failed = urb_checkpoint_write(f, e->key, first->key_size) ||
+                         urb_checkpoint_write(f, e->value, first->value_size);
+                records++;
+            }
+        }
+    }
+    if (failed) { 
+        fclose(f); 
+        return URB_IO_ERROR; 
+    }
+    return urb_checkpoint_close(f, records);
+}
+
+int urb_checkpoint_merge(const char **paths, size_t n, const char *output,
+                         int (*compare_key)(void*, void*)) {
+    urb_checkpoint_header_t first;
+    urb_t *entries = &urb_sentinel;
+    urb_checkpoint_apply_t a = { &entries, 0, 0, 
+                                 sizeof(urb_checkpoint_entry_t), compare_key };
+    size_t i;
+    int ret = n ? URB_SUCCESS : URB_INVALID_VALUE;
+    memset(&first, 0, sizeof(first));
+    for (i = 0; i < n && ret == URB_SUCCESS; ++i) {
+        ret = urb_checkpoint_read(paths[i], &first, 
+                                  urb_checkpoint_merge_one, &a);
+    }
+    /// A partial output is not left behind.
+    if (ret == URB_SUCCESS && 
+        (ret = urb_checkpoint_merge_write(&entries, output, &first)) 
+        != URB_SUCCESS) remove(output);
+    urb_tree_delete(&entries, urb_checkpoint_entry_free, NULL);
+    return ret;
+}
+
+CPPGUARD_END();
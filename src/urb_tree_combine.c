@@ -0,0 +1,191 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+///
+/// @file urb_tree_combine.c
+/// @author Issam SAID
+/// @brief Implement the flat combining front end of Red-Black trees.
+///
+/// @details A request is published by filling the slot then setting its 
+/// pending flag (release), the combiner reads the flag (acquire) before 
+/// the request and clears it (release) after writing the result. A waiting
+/// thread tries to become the combiner each time it finds the lock free,
+/// otherwise it yields: with more threads than cores the combiner must 
+/// not be starved by the spinning threads.
+///
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <urb_tree/combine.h>
+#include <urb_tree/core.h>
+#include <urb_tree/sentinel.h>
+#include <urb_tree/error.h>
+
+CPPGUARD_BEGIN();
+
+int urb_combine_init(urb_combine_t *combine, urb_t **urb, size_t n, 
+                     bool sorted, int (*compare_key)(void*, void*)) {
+    void *slots;
+    if (n == 0 || compare_key == NULL) return URB_INVALID_VALUE;
+    if (posix_memalign(&slots, 64, n*sizeof(urb_combine_slot_t)))
+        URB_EXIT(URB_OUT_OF_MEMORY, "failed to allocate the combiner slots");
+    memset(slots, 0, n*sizeof(urb_combine_slot_t));
+    combine->batch = 
+        (urb_combine_slot_t **)malloc(n*sizeof(urb_combine_slot_t*));
+    if (combine->batch == NULL)
+        URB_EXIT(URB_OUT_OF_MEMORY, "failed to allocate the combiner batch");
+    combine->urb         = urb;
+    combine->compare_key = compare_key;
+    combine->slots       = (urb_combine_slot_t *)slots;
+    combine->n           = n;
+    combine->sorted      = sorted;
+    combine->passes      = 0;
+    combine->requests    = 0;
+    pthread_mutex_init(&combine->lock, NULL);
+    return URB_SUCCESS;
+}
+
+int urb_combine_delete(urb_combine_t *combine) {
+    pthread_mutex_destroy(&combine->lock);
+    free(combine->slots);
+    free(combine->batch);
+    combine->slots = NULL;
+    combine->batch = NULL;
+    return URB_SUCCESS;
+}
+
+///
+/// @brief Apply one request to the tree.
+///
+static void urb_combine_apply(urb_combine_t *combine, urb_combine_slot_t *s) {
+    urb_t *n;
+    switch (s->op) {
+        case URB_COMBINE_PUT:
+            s->ret = urb_tree_put(combine->urb, s->node, combine->compare_key);
+            break;
+        case URB_COMBINE_POP:
+            s->node = urb_tree_pop(combine->urb, s->key, combine->compare_key);
+            break;
+        case URB_COMBINE_UPSERT:
+            n = urb_tree_find(combine->urb, s->key, combine->compare_key);
+            if (n == &urb_sentinel) {
+                n = urb_tree_create(s->key, s->value);
+                urb_tree_put(combine->urb, n, combine->compare_key);
+            } else {
+                n->value = s->value;
+            }
+            s->node = n;
+            break;
+        default:
+            break;
+    }
+}
+
+///
+/// @brief Collect the published requests, apply them and post the results.
+///
+static void urb_combine_pass(urb_combine_t *combine) {
+    urb_combine_slot_t *s;
+    size_t i, j, n = 0;
+    for (i = 0; i < combine->n; ++i) {
+        s = &combine->slots[i];
+        if (__atomic_load_n(&s->pending, __ATOMIC_ACQUIRE)) 
+            combine->batch[n++] = s;
+    }
+    if (combine->sorted) {
+        /// An insertion sort, the batches are at most one request per slot.
+        for (i = 1; i < n; ++i) {
+            s = combine->batch[i];
+            void *key = s->op == URB_COMBINE_PUT ? s->node->key : s->key;
+            for (j = i; j > 0; --j) {
+                urb_combine_slot_t *p = combine->batch[j-1];
+                if (combine->compare_key(p->op == URB_COMBINE_PUT ? 
+                                         p->node->key : p->key, key) <= 0)
+                    break;
+                combine->batch[j] = p;
+            }
+            combine->batch[j] = s;
+        }
+    }
+    for (i = 0; i < n; ++i) urb_combine_apply(combine, combine->batch[i]);
+    for (i = 0; i < n; ++i) 
+        __atomic_store_n(&combine->batch[i]->pending, 0, __ATOMIC_RELEASE);
+    combine->passes++;
+    combine->requests += n;
+}
+
+///
+/// @brief Publish the request of a slot and wait for its result.
+///
+static void urb_combine_wait(urb_combine_t *combine, urb_combine_slot_t *s) {
+    __atomic_store_n(&s->pending, 1, __ATOMIC_RELEASE);
+    while (__atomic_load_n(&s->pending, __ATOMIC_ACQUIRE)) {
+        if (pthread_mutex_trylock(&combine->lock) == 0) {
+            urb_combine_pass(combine);
+            pthread_mutex_unlock(&combine->lock);
+        } else {
+            sched_yield();
+        }
+    }
+}
+
+int urb_combine_put(urb_combine_t *combine, size_t id, urb_t *n) {
+    urb_combine_slot_t *s;
+    if (id >= combine->n) return URB_INVALID_VALUE;
+    s = &combine->slots[id];
+    if (n == NULL) 
+        URB_EXIT(URB_INVALID_NODE, "the node to insert can not be NULL");
+    s->op   = URB_COMBINE_PUT;
+    s->node = n;
+    urb_combine_wait(combine, s);
+    return s->ret;
+}
+
+urb_t *urb_combine_pop(urb_combine_t *combine, size_t id, void *key) {
+    urb_combine_slot_t *s;
+    if (id >= combine->n) return &urb_sentinel;
+    s      = &combine->slots[id];
+    s->op  = URB_COMBINE_POP;
+    s->key = key;
+    urb_combine_wait(combine, s);
+    return s->node;
+}
+
+urb_t *urb_combine_upsert(urb_combine_t *combine, size_t id, 
+                          void *key, void *value) {
+    urb_combine_slot_t *s;
+    if (id >= combine->n) return &urb_sentinel;
+    s        = &combine->slots[id];
+    s->op    = URB_COMBINE_UPSERT;
+    s->key   = key;
+    s->value = value;
+    urb_combine_wait(combine, s);
+    return s->node;
+}
+
+CPPGUARD_END();
@@ -0,0 +1,317 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file urb_tree_compact.c
+/// @author Issam SAID
+/// @brief Implement the compaction (defragmentation) of Red-Black trees.
+///
+/// @details A compaction first collects the nodes in the layout order: by 
+/// following urb_tree_succ (in-order), by using the order array as the BFS
+/// queue, or with the van Emde Boas split (the top half of the levels, 
+/// then each subtree below it) run on an explicit stack of pending 
+/// subtrees, after a first pass measuring the height. Each step of the 
+/// collection is one unit of the budget and the order array grows as the
+/// nodes are collected, so the number of nodes is only known at the end 
+/// of the collection. The slab is then allocated and the i-th node is 
+/// moved to the i-th slot of the slab. 
+///
+/// The slabs are registered in a global table, indexed by the slab number
+/// stored in the node flags. A slab counts its live nodes, plus one 
+/// reference held by the compaction in progress, and is freed at zero.
+///
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <urb_tree/compact.h>
+#include <urb_tree/sentinel.h>
+#include <urb_tree/util.h>
+#include <urb_tree/error.h>
+
+CPPGUARD_BEGIN();
+
+typedef struct {
+    size_t live;
+    void  *block;
+} urb_slab_t;
+
+static urb_slab_t     *urb_slabs      = NULL;
+static unsigned        urb_slabs_size = 0;
+static pthread_mutex_t urb_slabs_lock = PTHREAD_MUTEX_INITIALIZER;
+
+#define IS_NODE(n) ((n) != NULL && (n) != &urb_sentinel)
+
+///
+/// @brief Register a slab of n nodes, with one reference.
+///
+static urb_t *urb_slab_create(size_t n, unsigned *id) {
+    void *block;
+    unsigned i;
+    if (posix_memalign(&block, 64, n*sizeof(urb_t)))
+        URB_EXIT(URB_OUT_OF_MEMORY, "failed to allocate a slab of nodes");
+    pthread_mutex_lock(&urb_slabs_lock);
+    for (i = 0; i < urb_slabs_size && urb_slabs[i].block != NULL; ++i);
+    if (i == urb_slabs_size) {
+        urb_slabs_size = urb_slabs_size ? 2*urb_slabs_size : 16;
+        urb_slabs = (urb_slab_t *)realloc(urb_slabs, 
+                                          urb_slabs_size*sizeof(urb_slab_t));
+        if (urb_slabs == NULL) 
+            URB_EXIT(URB_OUT_OF_MEMORY, "failed to grow the slabs table");
+        memset(urb_slabs + i, 0, (urb_slabs_size-i)*sizeof(urb_slab_t));
+    }
+    urb_slabs[i].block = block;
+    urb_slabs[i].live  = 1;
+    pthread_mutex_unlock(&urb_slabs_lock);
+    *id = i;
+    return (urb_t *)block;
+}
+
+///
+/// @brief Drop a reference to a slab and free it at zero.
+///
+static void urb_slab_put(unsigned id) {
+    void *block = NULL;
+    pthread_mutex_lock(&urb_slabs_lock);
+    if (--urb_slabs[id].live == 0) {
+        block = urb_slabs[id].block;
+        urb_slabs[id].block = NULL;
+    }
+    pthread_mutex_unlock(&urb_slabs_lock);
+    free(block);
+}
+
+void urb_tree_node_free(urb_t *n) {
+    if (n->flags & URB_NODE_SLAB) urb_slab_put(n->flags >> URB_NODE_SLAB_SHIFT);
+    else free(n);
+}
+
+urb_t *urb_tree_slab_alloc(size_t n) {
+    unsigned id;
+    size_t i;
+    urb_t *slab;
+    if (n == 0) return NULL;
+    slab = urb_slab_create(n, &id);
+    for (i = 0; i < n; ++i) 
+        slab[i].flags = URB_NODE_SLAB | (id << URB_NODE_SLAB_SHIFT);
+    pthread_mutex_lock(&urb_slabs_lock);
+    urb_slabs[id].live = n;
+    pthread_mutex_unlock(&urb_slabs_lock);
+    return slab;
+}
+
+/// The phases of a compaction.
+#define URB_COMPACT_START   0
+#define URB_COMPACT_HEIGHT  1
+#define URB_COMPACT_COLLECT 2
+#define URB_COMPACT_MOVE    3
+
+/// The kinds of the pending subtrees: the depth of a node (to measure the
+/// height), the layout of height h of a node, and the layouts of height h
+/// of the subtrees d levels below a node.
+#define URB_FRAME_DEPTH     0
+#define URB_FRAME_LAYOUT    1
+#define URB_FRAME_BELOW     2
+
+int urb_compact_begin(urb_compact_t *compact, urb_t **urb, 
+                      urb_layout_t layout) {
+    memset(compact, 0, sizeof(urb_compact_t));
+    compact->urb    = urb;
+    compact->layout = layout;
+    compact->phase  = URB_COMPACT_START;
+    return URB_SUCCESS;
+}
+
+static void urb_compact_collect(urb_compact_t *compact, urb_t *n) {
+    urb_t **order;
+    if (compact->collected == compact->capacity) {
+        compact->capacity = compact->capacity ? 2*compact->capacity : 64;
+        order = (urb_t **)realloc(compact->order, 
+                                  compact->capacity*sizeof(urb_t*));
+        if (order == NULL) 
+            URB_EXIT(URB_OUT_OF_MEMORY, 
+                     "failed to allocate the compaction order");
+        compact->order = order;
+    }
+    compact->order[compact->collected++] = n;
+}
+
+static void urb_compact_push(urb_compact_t *compact, urb_t *n, 
+                             unsigned kind, size_t d, size_t h) {
+    urb_compact_frame_t *stack;
+    if (!IS_NODE(n) || (kind == URB_FRAME_LAYOUT && h == 0)) return;
+    if (compact->depth == compact->frames) {
+        compact->frames = compact->frames ? 2*compact->frames : 64;
+        stack = (urb_compact_frame_t *)realloc(compact->stack, 
+                    compact->frames*sizeof(urb_compact_frame_t));
+        if (stack == NULL) 
+            URB_EXIT(URB_OUT_OF_MEMORY, 
+                     "failed to allocate the compaction stack");
+        compact->stack = stack;
+    }
+    compact->stack[compact->depth].node = n;
+    compact->stack[compact->depth].kind = kind;
+    compact->stack[compact->depth].d    = d;
+    compact->stack[compact->depth].h    = h;
+    compact->depth++;
+}
+
+///
+/// @brief Visit one pending subtree of the van Emde Boas collection (or of
+///        the height), the frames are pushed in the reverse order of the 
+///        recursion.
+///
+static void urb_compact_frame(urb_compact_t *compact) {
+    urb_compact_frame_t f = compact->stack[--compact->depth];
+    size_t top;
+    switch (f.kind) {
+        case URB_FRAME_DEPTH:
+            if (f.d > compact->height) compact->height = f.d;
+            urb_compact_push(compact, f.node->right, f.kind, f.d + 1, 0);
+            urb_compact_push(compact, f.node->left,  f.kind, f.d + 1, 0);
+            break;
+        case URB_FRAME_LAYOUT:
+            if (f.h == 1) { urb_compact_collect(compact, f.node); break; }
+            top = f.h/2;
+            urb_compact_push(compact, f.node, URB_FRAME_BELOW, top, f.h-top);
+            urb_compact_push(compact, f.node, URB_FRAME_LAYOUT, 0, top);
+            break;
+        case URB_FRAME_BELOW:
+            if (f.d == 0) {
+                urb_compact_push(compact, f.node, URB_FRAME_LAYOUT, 0, f.h);
+                break;
+            }
+            urb_compact_push(compact, f.node->right, f.kind, f.d-1, f.h);
+            urb_compact_push(compact, f.node->left,  f.kind, f.d-1, f.h);
+            break;
+    }
+}
+
+///
+/// @brief Run one unit of the collection, allocate the slab at its end.
+///
+static void urb_compact_collect_step(urb_compact_t *compact) {
+    urb_t *n, *root = *compact->urb;
+    bool   done = false;
+    switch (compact->phase) {
+        case URB_COMPACT_START:
+            compact->phase = URB_COMPACT_COLLECT;
+            if (!IS_NODE(root)) { done = true; break; }
+            if (compact->layout == URB_LAYOUT_INORDER) {
+                compact->next = urb_tree_min(compact->urb);
+            } else if (compact->layout == URB_LAYOUT_BFS) {
+                urb_compact_collect(compact, root);
+            } else {
+                compact->phase = URB_COMPACT_HEIGHT;
+                urb_compact_push(compact, root, URB_FRAME_DEPTH, 1, 0);
+            }
+            break;
+        case URB_COMPACT_HEIGHT:
+            if (compact->depth) { urb_compact_frame(compact); break; }
+            compact->phase = URB_COMPACT_COLLECT;
+            urb_compact_push(compact, root, URB_FRAME_LAYOUT, 0, 
+                             compact->height);
+            break;
+        default:
+            if (compact->layout == URB_LAYOUT_INORDER) {
+                if (!(done = !IS_NODE(compact->next))) {
+                    urb_compact_collect(compact, compact->next);
+                    compact->next = urb_tree_succ(compact->next);
+                }
+            } else if (compact->layout == URB_LAYOUT_BFS) {
+                if (!(done = compact->scanned == compact->collected)) {
+                    n = compact->order[compact->scanned++];
+                    if (n->left  != &urb_sentinel) 
+                        urb_compact_collect(compact, n->left);
+                    if (n->right != &urb_sentinel) 
+                        urb_compact_collect(compact, n->right);
+                }
+            } else if (!(done = compact->depth == 0)) {
+                urb_compact_frame(compact);
+            }
+            break;
+    }
+    if (!done) return;
+    compact->phase = URB_COMPACT_MOVE;
+    compact->n     = compact->collected;
+    if (compact->n) compact->slab = urb_slab_create(compact->n, &compact->id);
+}
+
+///
+/// @brief Move the node n into the slot s and fix the links to it.
+///
+static void urb_compact_move(urb_compact_t *compact, urb_t *n, urb_t *s) {
+    *s = *n;
+    s->flags = URB_NODE_SLAB | (compact->id << URB_NODE_SLAB_SHIFT) |
+               (n->flags & URB_NODE_DIRTY_MASK);
+    if (IS_NODE(n->parent)) {
+        if (n->parent->left == n) n->parent->left  = s;
+        else                      n->parent->right = s;
+    } else { *compact->urb = s; }
+    if (n->left  != &urb_sentinel) n->left->parent  = s;
+    if (n->right != &urb_sentinel) n->right->parent = s;
+    /// The slab reference is taken before the previous one is dropped, 
+    /// the node may come from the same slab (a second compaction).
+    pthread_mutex_lock(&urb_slabs_lock);
+    urb_slabs[compact->id].live++;
+    pthread_mutex_unlock(&urb_slabs_lock);
+    urb_tree_node_free(n);
+}
+
+bool urb_compact_step(urb_compact_t *compact, size_t budget) {
+    while (budget && compact->phase != URB_COMPACT_MOVE) {
+        urb_compact_collect_step(compact);
+        budget--;
+    }
+    while (budget && compact->moved < compact->n) {
+        urb_compact_move(compact, compact->order[compact->moved], 
+                         compact->slab + compact->moved);
+        compact->moved++;
+        budget--;
+    }
+    if (compact->phase != URB_COMPACT_MOVE || compact->moved < compact->n) 
+        return false;
+    urb_compact_abort(compact);
+    return true;
+}
+
+void urb_compact_abort(urb_compact_t *compact) {
+    if (compact->slab != NULL) urb_slab_put(compact->id);
+    free(compact->order);
+    free(compact->stack);
+    compact->order = NULL;
+    compact->stack = NULL;
+    compact->slab  = NULL;
+}
+
+int urb_tree_compact(urb_t **urb, urb_layout_t layout) {
+    urb_compact_t compact;
+    urb_compact_begin(&compact, urb, layout);
+    while (!urb_compact_step(&compact, (size_t)-1));
+    return URB_SUCCESS;
+}
+
+CPPGUARD_END();
@@ -34,131 +34,320 @@
 #include <urb_tree/core.h>
 #include <urb_tree/fixin.h>
 #include <urb_tree/error.h>
+#include <urb_tree/stats.h>
+#include <urb_tree/cache.h>
+#include <urb_tree/destroy.h>
 
 CPPGUARD_BEGIN();
 
-urb_t urb_sentinel = { &urb_sentinel, \
+urb_t urb_sentinel = { { { &urb_sentinel, \
+                           &urb_sentinel } }, \
                        &urb_sentinel, \
-                       &urb_sentinel, \
-                       black, NULL, NULL};
+                       { black }, 0, NULL, NULL
+#ifdef __URB_TREE_PREFIX
+                       , 0
+#endif
+                       };
 
 urb_t *urb_tree_create(void *key, void *value) {
-    urb_t *n  = (urb_t *)malloc(sizeof(urb_t));
-    if (n == NULL) 
-        URB_EXIT(URB_OUT_OF_MEMORY, "failed to allocate urb_tree pair");       
+    urb_t *n  = urb_tree_cache_get();
     n->parent = &urb_sentinel;                              
     n->left   = &urb_sentinel;                              
     n->right  = &urb_sentinel;                              
     n->color  = red;                           
+    n->flags  = 0;
     n->key    = key;                                 
     n->value  = value;
+#ifdef __URB_TREE_PREFIX
+    n->prefix = 0;
+#endif
     return n;
 }
 
 int urb_tree_delete(urb_t **urb, 
                     void (*release_key)(void*), void (*release_value)(void*)) {
-    urb_t *i = *urb;
-    while (i != &urb_sentinel) {          
-        if (i->left != &urb_sentinel) {   
-            i = i->left;             
-        } else{
-            if(i->right != &urb_sentinel) { 
-                i = i->right;                 
-            } else {                          
-                if (release_key) { release_key(i->key); }
-                if (release_value) { release_value(i->value); }
-                if (i->parent) {                             
-                    i = i->parent;                           
-                    if (i->left != &urb_sentinel){                
-                        free(i->left);                       
-                        i->left = &urb_sentinel;                  
-                    } else {
-                        if (i->right != &urb_sentinel) {       
-                            free(i->right );                     
-                            i->right = &urb_sentinel;                 
-                        }
-                    }                                         
-                } else {                                     
-                    free(i);                                 
-                    i = &urb_sentinel;                            
-                }                                               
-            }                                                 
-        }
-    }                                                       
+    urb_destroy_t destroy;
+    urb_tree_detach(&destroy, urb, release_key, release_value);
+    urb_destroy_step(&destroy, (size_t)-1);
     return URB_SUCCESS;                                      
 }
 
 int urb_tree_put(urb_t **urb, urb_t *n, int (*compare_key)(void*, void*)) {
-    int ret;                                       
+    int ret = 0;                                     
     urb_t *p = NULL;        
     urb_t *i = *urb;
     if (n == NULL) 
         URB_EXIT(URB_INVALID_NODE, "the node to insert can not be NULL");
+    size_t depth = 0;
     while (i != &urb_sentinel) {                            
+        depth++;
         if((ret = compare_key(n->key, i->key))==0) 
             URB_EXIT(URB_DUPLICATE_KEY, "key already exists");
         p = i;
-        i = (ret < 0) ? i->left : i->right;                                        
+        i = i->child[ret > 0];
     }                                                      
     n->parent = p;                                    
     if (p) {    
-        if (compare_key(n->key, p->key) < 0) p->left = n;                              
-        else p->right = n;                             
+        p->child[ret > 0] = n;
     } else {
         *urb = n;
     }                                                  
+    URB_STATS_OP(put, depth, depth);
     urb_tree_fix_put(urb, n);                    
     return URB_SUCCESS;                                    
 }                                               
 
-urb_t *urb_tree_find(urb_t **urb, void *key, int (*compare_key)(void*, void*)) {       
+///
+/// @brief Descend from the root to the node holding the key, the number of
+///        visited nodes (hence of comparator calls) is stored in depth.
+///
+static inline urb_t *urb_tree_descend(urb_t **urb, void *key, 
+                                      int (*compare_key)(void*, void*),
+                                      size_t *depth) {
     int ret    = 0;                            
     urb_t *i   = *urb;  
     bool found = false;       
+    size_t d   = 0;
     while (i != &urb_sentinel) {                 
+        d++;
         if ((ret = compare_key(key, i->key)) == 0) { found = true; break; }
-        i = ret < 0 ? i->left : i->right;            
+        i = i->child[ret > 0];
     }                                                     
+    *depth = d;
     return found == true ? i : &urb_sentinel;      
 }
 
+urb_t *urb_tree_find(urb_t **urb, void *key, int (*compare_key)(void*, void*)) {       
+    size_t depth;
+    urb_t *n = urb_tree_descend(urb, key, compare_key, &depth);
+    URB_STATS_OP(find, depth, depth);
+    return n;
+}
+
+///
+/// @brief The state of one in-flight descent of urb_tree_find_batch: the
+///        node is prefetched when the descent moves to it, then its key is
+///        prefetched, and the comparison happens one round later.
+///
+typedef struct {
+    urb_t *node;
+    size_t index;
+    size_t depth;
+    bool   loaded;
+} urb_tree_lookup_t;
+
+void urb_tree_find_batch(urb_t **urb, void **keys, size_t n, urb_t **results,
+                         int (*compare_key)(void*, void*)) {
+    urb_tree_lookup_t slots[URB_TREE_BATCH_WIDTH];
+    size_t next = 0, active = 0, s;
+    int ret;
+    for (s = 0; s < URB_TREE_BATCH_WIDTH; ++s) {
+        slots[s].node   = next < n ? *urb : NULL;
+        slots[s].index  = next < n ? next++ : 0;
+        slots[s].depth  = 0;
+        slots[s].loaded = false;
+        if (slots[s].node) active++;
+    }
+    while (active) {
+        for (s = 0; s < URB_TREE_BATCH_WIDTH; ++s) {
+            urb_tree_lookup_t *l = &slots[s];
+            if (l->node == NULL) continue;
+            if (l->node != &urb_sentinel) {
+                if (!l->loaded) {
+                    __builtin_prefetch(l->node->key);
+                    l->loaded = true;
+                    continue;
+                }
+                l->depth++;
+                ret = compare_key(keys[l->index], l->node->key);
+                if (ret != 0) {
+                    l->node   = l->node->child[ret > 0];
+                    l->loaded = false;
+                    __builtin_prefetch(l->node);
+                    continue;
+                }
+            }
+            /// The descent is over: store the result and start a new one.
+            results[l->index] = l->node;
+            URB_STATS_OP(find, l->depth, l->depth);
+            if (next < n) {
+                l->node   = *urb;
+                l->index  = next++;
+                l->depth  = 0;
+                l->loaded = false;
+            } else {
+                l->node   = NULL;
+                active--;
+            }
+        }
+    }
+}
+
+///
+/// @brief Put v (possibly the sentinel) in the place of u.
+///
+static inline void urb_tree_transplant(urb_t **urb, urb_t *u, urb_t *v) {
+    if (u->parent) u->parent->child[u == u->parent->child[1]] = v;
+    else           *urb = v;
+    v->parent = u->parent;
+}
+
+urb_t *urb_tree_erase_node(urb_t **urb, urb_t *n) {
+    urb_t *y = n;
+    urb_t *kid;
+    color_t color = y->color;
+    if (n->left == &urb_sentinel) {
+        kid = n->right;
+        urb_tree_transplant(urb, n, n->right);
+    } else if (n->right == &urb_sentinel) {
+        kid = n->left;
+        urb_tree_transplant(urb, n, n->left);
+    } else {
+        /// The successor takes the place (and the color) of n.
+        y = n->right;
+        while (y->left != &urb_sentinel) y = y->left;
+        color = y->color;
+        kid   = y->right;
+        if (y->parent == n) {
+            kid->parent = y;
+        } else {
+            urb_tree_transplant(urb, y, y->right);
+            y->right         = n->right;
+            y->right->parent = y;
+        }
+        urb_tree_transplant(urb, n, y);
+        y->left         = n->left;
+        y->left->parent = y;
+        y->color        = n->color;
+        y->flags       |= n->flags & URB_NODE_DIRTY_BELOW;
+    }
+    if (color == black) urb_tree_fix_pop(urb, kid);
+    n->left   = &urb_sentinel;
+    n->parent = &urb_sentinel;
+    n->right  = &urb_sentinel;
+    return n;
+}
+
 urb_t *urb_tree_pop(urb_t **urb, void *key, int (*compare_key)(void*, void*)) {
-    urb_t *kid   = &urb_sentinel;                           
-    urb_t *pleaf = &urb_sentinel;       
-    urb_t *n     = urb_tree_find(urb, key, compare_key);                     
+    size_t depth;
+    urb_t *n     = urb_tree_descend(urb, key, compare_key, &depth);
+    URB_STATS_OP(pop, depth, depth);
     if (n == &urb_sentinel) return &urb_sentinel;                             
-    if (n->left  == &urb_sentinel || n->right == &urb_sentinel) {      
-        pleaf = n;                                           
-    } else {                                                  
-        pleaf = n->right;                                     
-        while (pleaf->left != &urb_sentinel) pleaf = pleaf->left;  
-    }                                                          
-    if (pleaf->left != &urb_sentinel) kid = pleaf->left;            
-    else kid = pleaf->right;                                 
-                                                                 
-    kid->parent = pleaf->parent;                              
-    if (pleaf->parent) {                                      
-        if (pleaf == pleaf->parent->left)                    
-            pleaf->parent->left = kid;                       
-        else                                                        
-            pleaf->parent->right = kid;                             
-    } else { *urb = kid; }
-    if (pleaf != n) {                                               
-        void *ktmp;                                                    
-        void *vtmp;                                                    
-        ktmp         = n->key;                                     
-        n->key       = pleaf->key;                                
-        pleaf->key   = ktmp;                                      
-        vtmp         = n->value;                                  
-        n->value     = pleaf->value;                              
-        pleaf->value = vtmp;                                        
-    }                                                              
-                                                                       
-    if (pleaf->color == black) urb_tree_fix_pop(urb, kid);  
-    pleaf->left   = &urb_sentinel;
-    pleaf->parent = &urb_sentinel;
-    pleaf->right  = &urb_sentinel;                                              
-    return pleaf; 
-}                                                 
+    return urb_tree_erase_node(urb, n);
+}
+
+#ifdef __URB_TREE_PREFIX
+///
+/// @brief Compare a key, whose prefix is given, to the key of a node: the 
+///        comparator is only called (and counted) when the prefixes tie.
+///
+static inline int urb_tree_compare_prefixed(void *key, uint64_t prefix,
+                                            urb_t *i, 
+                                            int (*compare_key)(void*, void*),
+                                            size_t *compares) {
+    if (prefix != i->prefix) return prefix < i->prefix ? -1 : 1;
+    (*compares)++;
+    return compare_key(key, i->key);
+}
+
+///
+/// @brief Descend from the root to the node holding the key by comparing
+///        the prefixes first.
+///
+static inline urb_t *urb_tree_descend_prefixed(urb_t **urb, void *key, 
+                                               uint64_t prefix,
+                                               int (*compare_key)(void*, void*),
+                                               size_t *compares, 
+                                               size_t *depth) {
+    int ret;
+    urb_t *i = *urb;
+    size_t c = 0, d = 0;
+    while (i != &urb_sentinel) {
+        d++;
+        if ((ret = urb_tree_compare_prefixed(key, prefix, i, 
+                                             compare_key, &c)) == 0) break;
+        i = i->child[ret > 0];
+    }
+    *compares = c;
+    *depth    = d;
+    return i;
+}
+#endif
+
+int urb_tree_put_prefixed(urb_t **urb, urb_t *n, 
+                          uint64_t (*normalize_key)(void*),
+                          int (*compare_key)(void*, void*)) {
+#ifdef __URB_TREE_PREFIX
+    int ret = 0;
+    urb_t *p = NULL;
+    urb_t *i = *urb;
+    size_t depth = 0, compares = 0;
+    if (n == NULL) 
+        URB_EXIT(URB_INVALID_NODE, "the node to insert can not be NULL");
+    n->prefix = normalize_key(n->key);
+    while (i != &urb_sentinel) {
+        depth++;
+        if ((ret = urb_tree_compare_prefixed(n->key, n->prefix, i, 
+                                             compare_key, &compares)) == 0)
+            URB_EXIT(URB_DUPLICATE_KEY, "key already exists");
+        p = i;
+        i = i->child[ret > 0];
+    }
+    n->parent = p;
+    if (p) {
+        p->child[ret > 0] = n;
+    } else {
+        *urb = n;
+    }
+    URB_STATS_OP(put, compares, depth);
+    urb_tree_fix_put(urb, n);
+    return URB_SUCCESS;
+#else
+    (void)normalize_key;
+    return urb_tree_put(urb, n, compare_key);
+#endif
+}
+
+urb_t *urb_tree_find_prefixed(urb_t **urb, void *key,
+                              uint64_t (*normalize_key)(void*),
+                              int (*compare_key)(void*, void*)) {
+#ifdef __URB_TREE_PREFIX
+    size_t compares, depth;
+    urb_t *n = urb_tree_descend_prefixed(urb, key, normalize_key(key), 
+                                         compare_key, &compares, &depth);
+    URB_STATS_OP(find, compares, depth);
+    return n;
+#else
+    (void)normalize_key;
+    return urb_tree_find(urb, key, compare_key);
+#endif
+}
+
+urb_t *urb_tree_pop_prefixed(urb_t **urb, void *key,
+                             uint64_t (*normalize_key)(void*),
+                             int (*compare_key)(void*, void*)) {
+#ifdef __URB_TREE_PREFIX
+    size_t compares, depth;
+    urb_t *n = urb_tree_descend_prefixed(urb, key, normalize_key(key), 
+                                         compare_key, &compares, &depth);
+    URB_STATS_OP(pop, compares, depth);
+    if (n == &urb_sentinel) return &urb_sentinel;
+    return urb_tree_erase_node(urb, n);
+#else
+    (void)normalize_key;
+    return urb_tree_pop(urb, key, compare_key);
+#endif
+}
+
+uint64_t urb_tree_prefix_string(void *key) {
+    const unsigned char *s = (const unsigned char *)key;
+    uint64_t prefix = 0;
+    int i;
+    for (i = 0; i < 8; ++i) {
+        prefix = (prefix << 8) | s[i];
+        if (s[i] == 0) { prefix <<= 8*(7-i); break; }
+    }
+    return prefix;
+}
  
 CPPGUARD_END();
\ No newline at end of file
@@ -0,0 +1,112 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file urb_tree_cursor.c
+/// @author Issam SAID
+/// @brief Implement the cursors (finger search) of Red-Black trees.
+///
+/// @details When the key is on the right of the node x, the keys between 
+/// x and its successor ancestor a (the parent of the top of the right 
+/// spine that goes up from x) are exactly the right subtree of x. So if the
+/// key is less than a's key the descent starts from x, otherwise x moves up
+/// to a and the test is repeated. The left side is symmetric. A node 
+/// without such an ancestor is on the right (left) spine of the tree and 
+/// the key can only be below it.
+///
+#include <stdbool.h>
+#include <urb_tree/cursor.h>
+#include <urb_tree/sentinel.h>
+#include <urb_tree/util.h>
+#include <urb_tree/stats.h>
+
+CPPGUARD_BEGIN();
+
+#define IS_ROOT(n) ((n)->parent == NULL || (n)->parent == &urb_sentinel)
+
+void urb_cursor_init(urb_cursor_t *cursor, urb_t **urb, 
+                     int (*compare_key)(void*, void*)) {
+    cursor->urb         = urb;
+    cursor->node        = NULL;
+    cursor->compare_key = compare_key;
+}
+
+urb_t *urb_cursor_seek(urb_cursor_t *cursor, void *key) {
+    urb_t *x = cursor->node, *u, *a;
+    size_t compares = 1, depth = 1;
+    int ret, up;
+    if (x == NULL || x == &urb_sentinel) x = *cursor->urb;
+    if (x == &urb_sentinel) return &urb_sentinel;
+    ret = cursor->compare_key(key, x->key);
+    /// Climb while the key is beyond the successor (predecessor) ancestor.
+    while (ret != 0) {
+        for (u = x; !IS_ROOT(u); u = u->parent) {
+            if (u != u->parent->child[ret > 0]) break;
+            depth++;
+        }
+        if (IS_ROOT(u)) break;
+        a  = u->parent;
+        up = cursor->compare_key(key, a->key);
+        compares++;
+        depth++;
+        if (up != 0 && (up > 0) != (ret > 0)) break;
+        x   = a;
+        ret = up;
+    }
+    /// Descend from x.
+    while (ret != 0) {
+        u = x->child[ret > 0];
+        if (u == &urb_sentinel) break;
+        x   = u;
+        ret = cursor->compare_key(key, x->key);
+        compares++;
+        depth++;
+    }
+    URB_STATS_OP(find, compares, depth);
+    cursor->node = x;
+    return ret == 0 ? x : &urb_sentinel;
+}
+
+urb_t *urb_cursor_node(urb_cursor_t *cursor) { return cursor->node; }
+
+urb_t *urb_cursor_next(urb_cursor_t *cursor) {
+    urb_t *n;
+    if (cursor->node == NULL) return NULL;
+    n = urb_tree_succ(cursor->node);
+    if (n == NULL || n == &urb_sentinel) return NULL;
+    return cursor->node = n;
+}
+
+urb_t *urb_cursor_prev(urb_cursor_t *cursor) {
+    urb_t *n;
+    if (cursor->node == NULL) return NULL;
+    n = urb_tree_prev(cursor->node);
+    if (n == NULL || n == &urb_sentinel) return NULL;
+    return cursor->node = n;
+}
+
+CPPGUARD_END();
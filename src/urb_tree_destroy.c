@@ -0,0 +1,130 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file urb_tree_destroy.c
+/// @author Issam SAID
+/// @brief Implement the deferred destruction of Red-Black trees.
+///
+/// @details The teardown does not need a stack: it goes down to a leaf, 
+/// releases it and unlinks it from its parent, then resumes from the 
+/// parent. The only state between two slices is the current node.
+///
+#include <stdlib.h>
+#include <pthread.h>
+#include <urb_tree/destroy.h>
+#include <urb_tree/sentinel.h>
+#include <urb_tree/cache.h>
+#include <urb_tree/error.h>
+
+CPPGUARD_BEGIN();
+
+static size_t          urb_destroy_pending = 0;
+static pthread_mutex_t urb_destroy_lock    = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  urb_destroy_done    = PTHREAD_COND_INITIALIZER;
+
+void urb_tree_detach(urb_destroy_t *destroy, urb_t **urb, 
+                     void (*release_key)(void*), 
+                     void (*release_value)(void*)) {
+    destroy->node          = *urb;
+    destroy->release_key   = release_key;
+    destroy->release_value = release_value;
+    *urb = &urb_sentinel;
+}
+
+bool urb_destroy_step(urb_destroy_t *destroy, size_t budget) {
+    urb_t *i = destroy->node;
+    while (i != &urb_sentinel && budget) {
+        if (i->left != &urb_sentinel) {
+            i = i->left;
+        } else if (i->right != &urb_sentinel) {
+            i = i->right;
+        } else {
+            if (destroy->release_key)   destroy->release_key(i->key);
+            if (destroy->release_value) destroy->release_value(i->value);
+            /// A node never put in a tree has the sentinel as parent.
+            if (i->parent && i->parent != &urb_sentinel) {
+                i = i->parent;
+                if (i->left != &urb_sentinel) {
+                    urb_tree_release(i->left);
+                    i->left = &urb_sentinel;
+                } else {
+                    urb_tree_release(i->right);
+                    i->right = &urb_sentinel;
+                }
+            } else {
+                urb_tree_release(i);
+                i = &urb_sentinel;
+            }
+            budget--;
+        }
+    }
+    destroy->node = i;
+    return i == &urb_sentinel;
+}
+
+static void *urb_destroy_run(void *arg) {
+    urb_destroy_t *destroy = (urb_destroy_t *)arg;
+    urb_destroy_step(destroy, (size_t)-1);
+    free(destroy);
+    pthread_mutex_lock(&urb_destroy_lock);
+    if (--urb_destroy_pending == 0) pthread_cond_broadcast(&urb_destroy_done);
+    pthread_mutex_unlock(&urb_destroy_lock);
+    return NULL;
+}
+
+int urb_tree_delete_async(urb_t **urb, 
+                          void (*release_key)(void*), 
+                          void (*release_value)(void*)) {
+    pthread_t thread;
+    pthread_attr_t attr;
+    urb_destroy_t *destroy;
+    if (*urb == &urb_sentinel) return URB_SUCCESS;
+    if ((destroy = (urb_destroy_t *)malloc(sizeof(urb_destroy_t))) == NULL)
+        URB_EXIT(URB_OUT_OF_MEMORY, "failed to allocate a destroy state");
+    urb_tree_detach(destroy, urb, release_key, release_value);
+    pthread_mutex_lock(&urb_destroy_lock);
+    urb_destroy_pending++;
+    pthread_mutex_unlock(&urb_destroy_lock);
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    if (pthread_create(&thread, &attr, urb_destroy_run, destroy)) {
+        /// No thread available, release the nodes in the caller.
+        urb_destroy_run(destroy);
+    }
+    pthread_attr_destroy(&attr);
+    return URB_SUCCESS;
+}
+
+void urb_tree_delete_wait(void) {
+    pthread_mutex_lock(&urb_destroy_lock);
+    while (urb_destroy_pending) 
+        pthread_cond_wait(&urb_destroy_done, &urb_destroy_lock);
+    pthread_mutex_unlock(&urb_destroy_lock);
+}
+
+CPPGUARD_END();
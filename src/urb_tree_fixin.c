@@ -65,144 +65,145 @@
 ///       - do rotation to bring it to CASE 2
 ///       - process CASE 2
 ///
+/// The cases are written once: the side of the parent (put) or of the node
+/// (pop) gives a direction d and the children are indexed with child[d] and
+/// child[!d], a single rotation routine is parameterized by d.
+///
 #include <stdio.h>
 #include <urb_tree/sentinel.h>
 #include <urb_tree/fixin.h>
 #include <urb_tree/flags.h>
+#include <urb_tree/stats.h>
 
-static inline void urb_tree_left_rotate(urb_t **urb, urb_t *n) {  
-    urb_t *y = n->right;
-    n->right = y->left;
-    if (y->left != &urb_sentinel) y->left->parent = n;
-    if (y       != &urb_sentinel) y->parent = n->parent;
-    if (n->parent){           
-        if (n == n->parent->left) n->parent->left = y; 
-        else n->parent->right = y;
+///
+/// @brief Rotate around n towards the direction d: the child of n opposite
+///        to d takes its place (d = 0 is a left rotation, 1 a right one).
+///
+static inline void urb_tree_rotate(urb_t **urb, urb_t *n, int d) {  
+    urb_t *y = n->child[!d];
+    URB_STATS_ADD(left_rotations,  !d);
+    URB_STATS_ADD(right_rotations,  d);
+    /// y takes the subtree of n: a dirty node below either one is marked
+    /// below both (see checkpoint.h).
+    if (n != &urb_sentinel && y != &urb_sentinel && 
+        ((n->flags | y->flags) & URB_NODE_DIRTY_MASK)) {
+        n->flags |= URB_NODE_DIRTY_BELOW;
+        y->flags |= URB_NODE_DIRTY_BELOW;
+    }
+    n->child[!d] = y->child[d];
+    if (y->child[d] != &urb_sentinel) y->child[d]->parent = n;
+    if (y          != &urb_sentinel) y->parent = n->parent;
+    if (n->parent) {           
+        n->parent->child[n == n->parent->child[1]] = y;
     } else { *urb = y; }    
-    y->left = n;                 
-    if (n != &urb_sentinel) n->parent = y;
-}
-
-static inline void urb_tree_right_rotate(urb_t **urb, urb_t *n) {  
-    urb_t *y = n->left; 
-    n->left  = y->right;           
-    if (y->right != &urb_sentinel) y->right->parent = n;     
-    if (y != &urb_sentinel) y->parent = n->parent;    
-    if (n->parent) {              
-        if (n == n->parent->right) n->parent->right = y; 
-        else n->parent->left = y;  
-    } else { *urb = y; }     
-    y->right = n;                 
+    y->child[d] = n;                 
     if (n != &urb_sentinel) n->parent = y;
 }
 
 int urb_tree_fix_put(urb_t **urb, urb_t *n) {
     urb_t *uncle;  
     urb_t *child = n;
+    int d;
     while (child != *urb && child->parent->color == red) {
-        //if (child->parent->parent != &urb_sentinel) {
-            if (child->parent == child->parent->parent->left) {
-                uncle = child->parent->parent->right;
-                //if (uncle != &urb_sentinel) {
-                    if (uncle->color == red) {           
-                        /// CASE 1: uncle and parent are RED.
-                        child->parent->color         = black; 
-                        uncle->color                 = black; 
-                        child->parent->parent->color = red;   
-                        child                        = child->parent->parent;
-                    } else {
-                        /// CASE 3: parent is RED, uncle is BLACK and child, 
-                        ///         parent, and grandpa are not aligned.
-                        if (child == child->parent->right) {
-                            child  = child->parent;         
-                            urb_tree_left_rotate(urb, child);
-                        }                     
-                        /// CASE 2: parent is RED, uncle is BLACK.
-                        child->parent->color         = black; 
-                        child->parent->parent->color = red;   
-                        urb_tree_right_rotate(urb, child->parent->parent);
-                    }
-                //} else { break; }                                                       
-            } else {                                                    
-                uncle = child->parent->parent->left; 
-                //if (uncle != &urb_sentinel) {                   
-                    if (uncle->color == red) {                             
-                        /// CASE 1 
-                        child->parent->color         = black;              
-                        uncle->color                 = black;              
-                        child->parent->parent->color = red;                
-                        child                        = child->parent->parent;
-                    } else {                       
-                        /// CASE 3
-                        if (child == child->parent->left) {
-                            child  = child->parent; 
-                            urb_tree_right_rotate(urb, child);
-                        }
-                        /// CASE 2 
-                        child->parent->color         = black;  
-                        child->parent->parent->color = red;    
-                        urb_tree_left_rotate(urb, child->parent->parent); 
-                    }
-                //} else { break; }
-            }
-        //} else { break; }                                                         
+        /// The side of the parent, the cases below are written for a left 
+        /// parent (d = 0) and mirrored otherwise.
+        d     = child->parent == child->parent->parent->child[1];
+        uncle = child->parent->parent->child[!d];
+        if (uncle->color == red) {           
+            /// CASE 1: uncle and parent are RED.
+            child->parent->color         = black; 
+            uncle->color                 = black; 
+            child->parent->parent->color = red;   
+            URB_STATS_ADD(put_recolors, 3);
+            child                        = child->parent->parent;
+        } else {
+            /// CASE 3: parent is RED, uncle is BLACK and child, 
+            ///         parent, and grandpa are not aligned.
+            if (child == child->parent->child[!d]) {
+                child  = child->parent;         
+                urb_tree_rotate(urb, child, d);
+            }                     
+            /// CASE 2: parent is RED, uncle is BLACK.
+            child->parent->color         = black; 
+            child->parent->parent->color = red;   
+            URB_STATS_ADD(put_recolors, 2);
+            urb_tree_rotate(urb, child->parent->parent, !d);
+        }
     }                                                               
     (*urb)->color = black;                                       
     return URB_SUCCESS;
 }
 
+urb_t *urb_tree_fix_red(urb_t **urb, urb_t *n) {
+    urb_t *uncle;  
+    urb_t *child = n;
+    int d;
+    /// Climb the chain of red nodes up to a red child whose grandparent is
+    /// black, the cases of urb_tree_fix_put hold there.
+    while (child->parent->parent && child->parent->parent->color == red)
+        child = child->parent;
+    if (child->parent->parent == NULL) {
+        /// The red parent is the root.
+        child->parent->color = black;
+        URB_STATS_ADD(put_recolors, 1);
+        return NULL;
+    }
+    d     = child->parent == child->parent->parent->child[1];
+    uncle = child->parent->parent->child[!d];
+    if (uncle->color == red) {           
+        /// CASE 1: uncle and parent are RED.
+        child->parent->color         = black; 
+        uncle->color                 = black; 
+        child->parent->parent->color = red;   
+        URB_STATS_ADD(put_recolors, 3);
+        return child->parent->parent;
+    }
+    /// CASE 3 then CASE 2.
+    if (child == child->parent->child[!d]) {
+        child  = child->parent;         
+        urb_tree_rotate(urb, child, d);
+    }                     
+    child->parent->color         = black; 
+    child->parent->parent->color = red;   
+    URB_STATS_ADD(put_recolors, 2);
+    urb_tree_rotate(urb, child->parent->parent, !d);
+    return NULL;
+}
+
 int urb_tree_fix_pop(urb_t **urb, urb_t *n) {
+    urb_t *w;
+    int d;
     while (n != *urb && n->color == black) { 
-        if (n == n->parent->left) {               
-            urb_t *w = n->parent->right;
-            if (w->color == red) {               
-                w->color         = black;        
-                n->parent->color = red;          
-                urb_tree_left_rotate(urb, n->parent);
-                w = n->parent->right;                       
-            }                                               
-            if (w->left->color == black && w->right->color == black) { 
-                w->color = red;                                     
-                n = n->parent;                                      
-            } else {                                                
-                if (w->right->color == black)  {                    
-                    w->left->color = black;                         
-                    w->color       = red;                          
-                    urb_tree_right_rotate(urb, w);          
-                    w = n->parent->right;                          
-                }                                                  
-                w->color = n->parent->color;                       
-                n->parent->color = black;                          
-                w->right->color = black;                           
-                urb_tree_left_rotate(urb, n->parent);       
-                n = *urb;                                     
-            }                                                      
-        } else {                                                   
-            urb_t *w = n->parent->left;                  
-            if (w->color == red) {                                 
-                w->color = black;                                  
-                n->parent->color = red;                            
-                urb_tree_right_rotate(urb, n->parent);      
-                w = n->parent->left;                               
-            }                                                      
-            if (w->right->color == black && w->left->color == black) {
-                w->color = red;                                    
-                n = n->parent;                                     
-            } else {                                               
-                if (w->left->color == black) {                     
-                    w->right->color = black;                       
-                    w->color = red;                                
-                    urb_tree_left_rotate(urb, w);           
-                    w = n->parent->left;                           
-                }                                                  
-                w->color = n->parent->color;                       
-                n->parent->color = black;                          
-                w->left->color   = black;                            
-                urb_tree_right_rotate(urb, n->parent);      
-                n = *urb;                                     
-            }                                                      
-        }                                                          
+        /// The side of n (a left sentinel first), mirrored as above.
+        d = n != n->parent->child[0];
+        w = n->parent->child[!d];
+        if (w->color == red) {               
+            w->color         = black;        
+            n->parent->color = red;          
+            URB_STATS_ADD(pop_recolors, 2);
+            urb_tree_rotate(urb, n->parent, d);
+            w = n->parent->child[!d];                       
+        }                                               
+        if (w->child[0]->color == black && w->child[1]->color == black) { 
+            w->color = red;                                     
+            URB_STATS_ADD(pop_recolors, 1);
+            n = n->parent;                                      
+        } else {                                                
+            if (w->child[!d]->color == black)  {                    
+                w->child[d]->color = black;                         
+                w->color           = red;                          
+                URB_STATS_ADD(pop_recolors, 2);
+                urb_tree_rotate(urb, w, !d);          
+                w = n->parent->child[!d];                          
+            }                                                  
+            w->color            = n->parent->color;                       
+            n->parent->color    = black;                          
+            w->child[!d]->color = black;                           
+            URB_STATS_ADD(pop_recolors, 3);
+            urb_tree_rotate(urb, n->parent, d);       
+            n = *urb;                                     
+        }                                                      
     }                                                              
     n->color = black;                                              
     return URB_SUCCESS;
-}
\ No newline at end of file
+}
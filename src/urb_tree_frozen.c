@@ -0,0 +1,344 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file urb_tree_frozen.c
+/// @author Issam SAID
+/// @brief Implement the read-only (frozen) form of Red-Black trees.
+///
+/// @details The tree is copied with an in-order walk that fills the 
+/// Eytzinger slots recursively (left subtree 2i, slot i, right subtree 
+/// 2i+1). A descent never branches on the comparison: it goes down to a 
+/// missing slot and the answer is recovered from the path bits, the slot 
+/// where the descent went left for the last time is found by shifting out 
+/// the trailing ones of the final index (and one more bit).
+///
+#include <string.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <urb_tree/frozen.h>
+#include <urb_tree/sentinel.h>
+#include <urb_tree/util.h>
+#include <urb_tree/error.h>
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define URB_FROZEN_AVX2
+#endif
+
+CPPGUARD_BEGIN();
+
+#define URB_FROZEN_MAGIC "URBFRZ1"
+
+///
+/// @brief The header of a saved frozen tree, the arrays are 64-byte aligned.
+///
+typedef struct {
+    char     magic[8];
+    uint64_t n;
+    uint64_t key_size;
+    uint64_t value_size;
+    uint64_t keys_offset;
+    uint64_t values_offset;
+} urb_frozen_header_t;
+
+#define KEY_STRIDE(f)   ((f)->key_size   ? (f)->key_size   : sizeof(void*))
+#define VALUE_STRIDE(f) ((f)->value_size ? (f)->value_size : sizeof(void*))
+#define ALIGN64(x)      (((x) + 63) & ~(size_t)63)
+
+static inline void *__frozen_key(urb_frozen_t *f, size_t i) {
+    unsigned char *p = f->keys + i*KEY_STRIDE(f);
+    return f->key_size ? (void*)p : *(void**)p;
+}
+
+static inline size_t __frozen_last_left(size_t i) {
+    return i >> __builtin_ffsll((long long)~i);
+}
+
+static urb_t *__frozen_fill(urb_frozen_t *f, size_t i, urb_t *n) {
+    if (i > f->n) return n;
+    n = __frozen_fill(f, 2*i, n);
+    if (f->key_size) memcpy(f->keys + i*f->key_size, n->key, f->key_size);
+    else ((void**)f->keys)[i] = n->key;
+    if (f->value_size) 
+        memcpy(f->values + i*f->value_size, n->value, f->value_size);
+    else ((void**)f->values)[i] = n->value;
+    return __frozen_fill(f, 2*i+1, urb_tree_succ(n));
+}
+
+urb_frozen_t *urb_tree_freeze(urb_t **urb, size_t key_size, size_t value_size) {
+    urb_frozen_t *f = (urb_frozen_t *)calloc(1, sizeof(urb_frozen_t));
+    if (f == NULL) 
+        URB_EXIT(URB_OUT_OF_MEMORY, "failed to allocate urb_tree frozen tree");
+    f->n          = urb_tree_size(urb);
+    f->key_size   = key_size;
+    f->value_size = value_size;
+    if (posix_memalign((void**)&f->keys,   64, 
+                       ALIGN64((f->n+1)*KEY_STRIDE(f)))   != 0 ||
+        posix_memalign((void**)&f->values, 64, 
+                       ALIGN64((f->n+1)*VALUE_STRIDE(f))) != 0)
+        URB_EXIT(URB_OUT_OF_MEMORY, "failed to allocate urb_tree frozen arrays");
+    memset(f->keys,   0, KEY_STRIDE(f));
+    memset(f->values, 0, VALUE_STRIDE(f));
+    if (f->n) __frozen_fill(f, 1, urb_tree_min(urb));
+    return f;
+}
+
+void urb_frozen_delete(urb_frozen_t *frozen) {
+    if (frozen == NULL) return;
+    if (frozen->map) {
+        munmap(frozen->map, frozen->map_size);
+    } else {
+        free(frozen->keys);
+        free(frozen->values);
+    }
+    free(frozen);
+}
+
+void *urb_frozen_key(urb_frozen_t *frozen, size_t i) { 
+    return __frozen_key(frozen, i);
+}
+
+void *urb_frozen_value(urb_frozen_t *frozen, size_t i) {
+    unsigned char *p = frozen->values + i*VALUE_STRIDE(frozen);
+    return frozen->value_size ? (void*)p : *(void**)p;
+}
+
+size_t urb_frozen_lower_bound(urb_frozen_t *frozen, void *key,
+                              int (*compare_key)(void*, void*)) {
+    size_t i = 1;
+    while (i <= frozen->n) 
+        i = 2*i + (compare_key(__frozen_key(frozen, i), key) < 0);
+    return __frozen_last_left(i);
+}
+
+size_t urb_frozen_find(urb_frozen_t *frozen, void *key, 
+                       int (*compare_key)(void*, void*)) {
+    size_t i = urb_frozen_lower_bound(frozen, key, compare_key);
+    if (i && compare_key(__frozen_key(frozen, i), key) == 0) return i;
+    return 0;
+}
+
+size_t urb_frozen_min(urb_frozen_t *frozen) {
+    size_t i = 1;
+    if (frozen->n == 0) return 0;
+    while (2*i <= frozen->n) i = 2*i;
+    return i;
+}
+
+size_t urb_frozen_max(urb_frozen_t *frozen) {
+    size_t i = 1;
+    if (frozen->n == 0) return 0;
+    while (2*i+1 <= frozen->n) i = 2*i+1;
+    return i;
+}
+
+size_t urb_frozen_succ(urb_frozen_t *frozen, size_t i) {
+    if (2*i+1 <= frozen->n) {
+        i = 2*i+1;
+        while (2*i <= frozen->n) i = 2*i;
+        return i;
+    }
+    while (i & 1) i >>= 1;
+    return i >> 1;
+}
+
+size_t urb_frozen_prev(urb_frozen_t *frozen, size_t i) {
+    if (2*i <= frozen->n) {
+        i = 2*i;
+        while (2*i+1 <= frozen->n) i = 2*i+1;
+        return i;
+    }
+    while (i > 1 && !(i & 1)) i >>= 1;
+    return i >> 1;
+}
+
+size_t urb_frozen_find_int64(urb_frozen_t *frozen, int64_t key) {
+    const int64_t *k = (const int64_t *)frozen->keys;
+    size_t i = 1, n = frozen->n;
+    if (frozen->key_size != sizeof(int64_t)) 
+        URB_EXIT(URB_INVALID_VALUE, "the frozen keys are not 64-bit integers");
+    while (i <= n) {
+        /// The 8 descendants three levels below share one cache line.
+        __builtin_prefetch(k + 8*i);
+        i = 2*i + (k[i] < key);
+    }
+    i = __frozen_last_left(i);
+    return (i && k[i] == key) ? i : 0;
+}
+
+#ifdef URB_FROZEN_AVX2
+__attribute__((target("avx2")))
+static size_t __frozen_find_int64_avx2(const int64_t *k, size_t n, 
+                                       const int64_t *keys, size_t m,
+                                       size_t *results) {
+    const __m256i vlimit = _mm256_set1_epi64x((long long)n+1);
+    const __m256i zero   = _mm256_setzero_si256();
+    size_t j, levels = 0, t;
+    for (t = n; t; t >>= 1) levels++;
+    /// Two groups of 4 lanes in flight to overlap 8 cache misses.
+    for (j = 0; j+8 <= m; j += 8) {
+        __m256i vkey[2], vi[2];
+        size_t l, g, lane, idx[8];
+        vkey[0] = _mm256_loadu_si256((const __m256i *)(keys+j));
+        vkey[1] = _mm256_loadu_si256((const __m256i *)(keys+j+4));
+        vi[0]   = vi[1] = _mm256_set1_epi64x(1);
+        for (l = 0; l < levels; ++l) {
+            for (g = 0; g < 2; ++g) {
+                __m256i active = _mm256_cmpgt_epi64(vlimit, vi[g]);
+                __m256i vk     = _mm256_mask_i64gather_epi64(zero, 
+                                     (const long long *)k, vi[g], active, 8);
+                __m256i lt     = _mm256_cmpgt_epi64(vkey[g], vk);
+                __m256i next   = _mm256_sub_epi64(_mm256_add_epi64(vi[g], 
+                                                                   vi[g]), lt);
+                vi[g] = _mm256_blendv_epi8(vi[g], next, active);
+            }
+        }
+        _mm256_storeu_si256((__m256i *)idx,     vi[0]);
+        _mm256_storeu_si256((__m256i *)(idx+4), vi[1]);
+        for (lane = 0; lane < 8; ++lane) {
+            size_t i = __frozen_last_left(idx[lane]);
+            results[j+lane] = (i && k[i] == keys[j+lane]) ? i : 0;
+        }
+    }
+    return j;
+}
+#endif
+
+void urb_frozen_find_int64_batch(urb_frozen_t *frozen, const int64_t *keys,
+                                 size_t n, size_t *results) {
+    const int64_t *k = (const int64_t *)frozen->keys;
+    size_t j = 0, l, s;
+    if (frozen->key_size != sizeof(int64_t)) 
+        URB_EXIT(URB_INVALID_VALUE, "the frozen keys are not 64-bit integers");
+#ifdef URB_FROZEN_AVX2
+    if (__builtin_cpu_supports("avx2"))
+        j = __frozen_find_int64_avx2(k, frozen->n, keys, n, results);
+#endif
+    /// Scalar fallback: 8 interleaved descents.
+    for (; j < n; j += 8) {
+        size_t idx[8], w = (n-j < 8) ? n-j : 8;
+        for (s = 0; s < w; ++s) idx[s] = 1;
+        for (l = 0; l < 64; ++l) {
+            int active = 0;
+            for (s = 0; s < w; ++s) {
+                if (idx[s] > frozen->n) continue;
+                idx[s] = 2*idx[s] + (k[idx[s]] < keys[j+s]);
+                active = 1;
+            }
+            if (!active) break;
+        }
+        for (s = 0; s < w; ++s) {
+            size_t i = __frozen_last_left(idx[s]);
+            results[j+s] = (i && k[i] == keys[j+s]) ? i : 0;
+        }
+    }
+}
+
+int urb_frozen_save(urb_frozen_t *frozen, const char *path) {
+    urb_frozen_header_t h;
+    size_t keys_bytes, values_bytes;
+    static const char pad[64] = { 0 };
+    FILE *f;
+    if (frozen->key_size == 0 || frozen->value_size == 0) 
+        return URB_INVALID_VALUE;
+    keys_bytes   = (frozen->n+1)*frozen->key_size;
+    values_bytes = (frozen->n+1)*frozen->value_size;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, URB_FROZEN_MAGIC, sizeof(URB_FROZEN_MAGIC));
+    h.n             = frozen->n;
+    h.key_size      = frozen->key_size;
+    h.value_size    = frozen->value_size;
+    h.keys_offset   = ALIGN64(sizeof(h));
+    h.values_offset = h.keys_offset + ALIGN64(keys_bytes);
+    if ((f = fopen(path, "wb")) == NULL) return URB_IO_ERROR;
+    if (fwrite(&h, sizeof(h), 1, f) != 1 ||
+        fwrite(pad, h.keys_offset-sizeof(h), 1, f) != 1 ||
+        fwrite(frozen->keys, keys_bytes, 1, f) != 1 ||
+        (ALIGN64(keys_bytes) != keys_bytes &&
+         fwrite(pad, ALIGN64(keys_bytes)-keys_bytes, 1, f) != 1) ||
+        fwrite(frozen->values, values_bytes, 1, f) != 1) {
+        fclose(f);
+        return URB_IO_ERROR;
+    }
+    return fclose(f) == 0 ? URB_SUCCESS : URB_IO_ERROR;
+}
+
+///
+/// @brief Check that the arrays of a saved frozen tree are aligned, in 
+///        order and within the file (without overflowing).
+///
+static bool urb_frozen_check_header(const urb_frozen_header_t *h, 
+                                    uint64_t size) {
+    uint64_t keys, values;
+    if (memcmp(h->magic, URB_FROZEN_MAGIC, sizeof(URB_FROZEN_MAGIC)) != 0 ||
+        h->key_size == 0 || h->value_size == 0 || h->n >= size ||
+        h->n + 1 > size / h->key_size || h->n + 1 > size / h->value_size)
+        return false;
+    keys   = (h->n + 1)*h->key_size;
+    values = (h->n + 1)*h->value_size;
+    return h->keys_offset   >= sizeof(*h) && h->keys_offset   % 64 == 0 &&
+           h->values_offset >= h->keys_offset && h->values_offset % 64 == 0 &&
+           h->values_offset - h->keys_offset >= keys &&
+           h->values_offset <= size && size - h->values_offset >= values;
+}
+
+urb_frozen_t *urb_frozen_load(const char *path) {
+    struct stat st;
+    urb_frozen_header_t *h;
+    urb_frozen_t *frozen;
+    void *map;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(*h)) {
+        close(fd);
+        return NULL;
+    }
+    map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return NULL;
+    h = (urb_frozen_header_t *)map;
+    if (!urb_frozen_check_header(h, (uint64_t)st.st_size)) {
+        munmap(map, st.st_size);
+        return NULL;
+    }
+    frozen = (urb_frozen_t *)calloc(1, sizeof(urb_frozen_t));
+    if (frozen == NULL) 
+        URB_EXIT(URB_OUT_OF_MEMORY, "failed to allocate urb_tree frozen tree");
+    frozen->n          = h->n;
+    frozen->key_size   = h->key_size;
+    frozen->value_size = h->value_size;
+    frozen->keys       = (unsigned char *)map + h->keys_offset;
+    frozen->values     = (unsigned char *)map + h->values_offset;
+    frozen->map        = map;
+    frozen->map_size   = st.st_size;
+    return frozen;
+}
+
+CPPGUARD_END();
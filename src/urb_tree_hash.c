@@ -0,0 +1,173 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file urb_tree_hash.c
+/// @author Issam SAID
+/// @brief Implement the hybrid hash and Red-Black tree index.
+///
+/// @details The full hash of a key is stored in its slot, the comparator 
+/// is only called when the hashes are equal. The table is rebuilt when the
+/// used slots (keys and removed) reach half of the slots, with enough 
+/// slots for the keys to fill at most a quarter of them.
+///
+#include <stdlib.h>
+#include <urb_tree/hash.h>
+#include <urb_tree/core.h>
+#include <urb_tree/util.h>
+#include <urb_tree/sentinel.h>
+#include <urb_tree/error.h>
+
+CPPGUARD_BEGIN();
+
+static urb_hash_slot_t *urb_hash_alloc(size_t capacity) {
+    urb_hash_slot_t *slots = 
+        (urb_hash_slot_t *)calloc(capacity, sizeof(urb_hash_slot_t));
+    if (slots == NULL) 
+        URB_EXIT(URB_OUT_OF_MEMORY, "failed to allocate the hash table");
+    return slots;
+}
+
+///
+/// @brief Return the slot of a key, or NULL if the key is missing.
+///
+static urb_hash_slot_t *urb_hash_lookup(urb_hash_t *hash, void *key, 
+                                        uint64_t h,
+                                        int (*compare_key)(void*, void*)) {
+    size_t i = (size_t)h & (hash->capacity - 1);
+    urb_hash_slot_t *s;
+    for (;; i = (i + 1) & (hash->capacity - 1)) {
+        s = &hash->slots[i];
+        if (s->node == NULL) return NULL;
+        if (s->node != &urb_sentinel && s->hash == h && 
+            compare_key(key, s->node->key) == 0) return s;
+    }
+}
+
+///
+/// @brief Store a node in the first free (empty or removed) slot.
+///
+static void urb_hash_store(urb_hash_t *hash, urb_t *n, uint64_t h) {
+    size_t i = (size_t)h & (hash->capacity - 1);
+    while (hash->slots[i].node != NULL && 
+           hash->slots[i].node != &urb_sentinel) 
+        i = (i + 1) & (hash->capacity - 1);
+    if (hash->slots[i].node == &urb_sentinel) hash->removed--;
+    hash->slots[i].hash = h;
+    hash->slots[i].node = n;
+    hash->n++;
+}
+
+static void urb_hash_rebuild(urb_hash_t *hash) {
+    urb_hash_slot_t *slots = hash->slots;
+    size_t i, capacity = hash->capacity;
+    hash->capacity = 16;
+    while (hash->capacity < 4*(hash->n + 1)) hash->capacity <<= 1;
+    hash->slots   = urb_hash_alloc(hash->capacity);
+    hash->n       = 0;
+    hash->removed = 0;
+    for (i = 0; i < capacity; ++i) 
+        if (slots[i].node != NULL && slots[i].node != &urb_sentinel) 
+            urb_hash_store(hash, slots[i].node, slots[i].hash);
+    free(slots);
+}
+
+int urb_hash_init(urb_hash_t *hash, size_t capacity, 
+                  uint64_t (*hash_key)(void*)) {
+    if (hash_key == NULL) return URB_INVALID_VALUE;
+    hash->root     = &urb_sentinel;
+    hash->capacity = 16;
+    while (hash->capacity < 2*capacity) hash->capacity <<= 1;
+    hash->slots    = urb_hash_alloc(hash->capacity);
+    hash->n        = 0;
+    hash->removed  = 0;
+    hash->hash_key = hash_key;
+    return URB_SUCCESS;
+}
+
+int urb_hash_delete(urb_hash_t *hash, 
+                    void (*release_key)(void*), void (*release_value)(void*)) {
+    urb_tree_delete(&hash->root, release_key, release_value);
+    free(hash->slots);
+    hash->slots    = NULL;
+    hash->capacity = 0;
+    hash->n        = 0;
+    return URB_SUCCESS;
+}
+
+int urb_hash_put(urb_hash_t *hash, urb_t *n, int (*compare_key)(void*, void*)) {
+    int ret;
+    if (n == NULL) 
+        URB_EXIT(URB_INVALID_NODE, "the node to insert can not be NULL");
+    if ((ret = urb_tree_put(&hash->root, n, compare_key)) != URB_SUCCESS) 
+        return ret;
+    if (2*(hash->n + hash->removed + 1) > hash->capacity) 
+        urb_hash_rebuild(hash);
+    urb_hash_store(hash, n, urb_tree_mix(hash->hash_key(n->key)));
+    return URB_SUCCESS;
+}
+
+urb_t *urb_hash_upsert(urb_hash_t *hash, void *key, void *value, 
+                       int (*compare_key)(void*, void*)) {
+    uint64_t h = urb_tree_mix(hash->hash_key(key));
+    urb_hash_slot_t *s = urb_hash_lookup(hash, key, h, compare_key);
+    urb_t *n;
+    if (s != NULL) {
+        s->node->value = value;
+        return s->node;
+    }
+    n = urb_tree_create(key, value);
+    urb_tree_put(&hash->root, n, compare_key);
+    if (2*(hash->n + hash->removed + 1) > hash->capacity) 
+        urb_hash_rebuild(hash);
+    urb_hash_store(hash, n, h);
+    return n;
+}
+
+urb_t *urb_hash_find(urb_hash_t *hash, void *key, 
+                     int (*compare_key)(void*, void*)) {
+    urb_hash_slot_t *s = 
+        urb_hash_lookup(hash, key, urb_tree_mix(hash->hash_key(key)), 
+                        compare_key);
+    return s == NULL ? &urb_sentinel : s->node;
+}
+
+urb_t *urb_hash_pop(urb_hash_t *hash, void *key, 
+                    int (*compare_key)(void*, void*)) {
+    urb_hash_slot_t *s = 
+        urb_hash_lookup(hash, key, urb_tree_mix(hash->hash_key(key)), 
+                        compare_key);
+    urb_t *n;
+    if (s == NULL) return &urb_sentinel;
+    n       = s->node;
+    s->node = &urb_sentinel;
+    hash->n--;
+    hash->removed++;
+    return urb_tree_erase_node(&hash->root, n);
+}
+
+CPPGUARD_END();
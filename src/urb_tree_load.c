@@ -0,0 +1,263 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file urb_tree_load.c
+/// @author Issam SAID
+/// @brief Implement the bulk loading of Red-Black trees.
+///
+/// @details With the middle split, the levels 0 to h-1 of the built tree 
+/// are complete, h = floor(log2(n+1)), and the remaining nodes are at 
+/// level h. Coloring the level h in red keeps the same number of black 
+/// nodes on every path and no red node has a red child.
+///
+#define _GNU_SOURCE
+#include <time.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <urb_tree/load.h>
+#include <urb_tree/compact.h>
+#include <urb_tree/sentinel.h>
+#include <urb_tree/error.h>
+
+CPPGUARD_BEGIN();
+
+static double urb_load_now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + 1e-9*t.tv_nsec;
+}
+
+///
+/// @brief Link the nodes [lo, hi) in order under the parent p.
+///
+static urb_t *urb_build_range(urb_t *nodes, size_t lo, size_t hi, 
+                              urb_t *p, size_t depth, size_t h) {
+    size_t mid;
+    urb_t *n;
+    if (lo >= hi) return &urb_sentinel;
+    mid       = lo + (hi - lo)/2;
+    n         = &nodes[mid];
+    n->parent = p;
+    n->color  = depth >= h ? red : black;
+    n->left   = urb_build_range(nodes, lo, mid, n, depth+1, h);
+    n->right  = urb_build_range(nodes, mid+1, hi, n, depth+1, h);
+    return n;
+}
+
+///
+/// @brief Link n nodes whose keys are sorted into a tree.
+///
+static urb_t *urb_build_link(urb_t *nodes, size_t n) {
+    size_t h;
+    for (h = 0; ((size_t)2 << h) <= n + 1; ++h);
+    return urb_build_range(nodes, 0, n, NULL, 0, h);
+}
+
+int urb_tree_build(urb_t **urb, void **keys, void **values, size_t n) {
+    urb_t *nodes;
+    size_t i;
+    if (*urb != &urb_sentinel) return URB_INVALID_VALUE;
+    if (n == 0) return URB_SUCCESS;
+    nodes = urb_tree_slab_alloc(n);
+    for (i = 0; i < n; ++i) {
+        nodes[i].key   = keys[i];
+        nodes[i].value = values ? values[i] : NULL;
+#ifdef __URB_TREE_PREFIX
+        nodes[i].prefix = 0;
+#endif
+    }
+    *urb = urb_build_link(nodes, n);
+    return URB_SUCCESS;
+}
+
+typedef struct {
+    char   *records;
+    size_t  n;
+    FILE   *run;
+    const urb_load_config_t *config;
+} urb_load_run_t;
+
+static int urb_load_compare(const void *a, const void *b, void *arg) {
+    return ((int (*)(void*, void*))arg)((void*)a, (void*)b);
+}
+
+static void *urb_load_sort(void *arg) {
+    urb_load_run_t *r = (urb_load_run_t *)arg;
+    qsort_r(r->records, r->n, r->config->record_size, urb_load_compare, 
+            (void*)r->config->compare_key);
+    return NULL;
+}
+
+static FILE *urb_load_tmpfile(const char *tmpdir) {
+    char path[4096];
+    int fd;
+    FILE *f;
+    snprintf(path, sizeof(path), "%s/urb_tree_run_XXXXXX", 
+             tmpdir ? tmpdir : "/tmp");
+    if ((fd = mkstemp(path)) < 0) return NULL;
+    unlink(path);
+    if ((f = fdopen(fd, "w+b")) == NULL) close(fd);
+    return f;
+}
+
+///
+/// @brief The head of a run in the merge heap.
+///
+typedef struct {
+    char  *record;
+    FILE  *run;
+} urb_load_head_t;
+
+static void urb_load_sift(urb_load_head_t *heap, size_t k, size_t i, 
+                          int (*compare_key)(void*, void*)) {
+    urb_load_head_t t;
+    size_t c;
+    for (; (c = 2*i + 1) < k; i = c) {
+        if (c + 1 < k && compare_key(heap[c+1].record, heap[c].record) < 0) 
+            c++;
+        if (compare_key(heap[c].record, heap[i].record) >= 0) break;
+        t = heap[i]; heap[i] = heap[c]; heap[c] = t;
+    }
+}
+
+static int urb_load_merge(urb_load_run_t *runs, size_t k, size_t n,
+                          const urb_load_config_t *config, urb_load_t *load) {
+    size_t rs = config->record_size, i, m = 0;
+    urb_load_head_t *heap = 
+        (urb_load_head_t *)malloc(k*sizeof(urb_load_head_t));
+    char *buffer = (char *)malloc(k*rs), *out;
+    int ret = URB_SUCCESS;
+    if ((load->records = malloc(n ? n*rs : 1)) == NULL || 
+        heap == NULL || buffer == NULL) 
+        URB_EXIT(URB_OUT_OF_MEMORY, "failed to allocate the merge buffers");
+    out = (char *)load->records;
+    for (i = 0; i < k; ++i) {
+        rewind(runs[i].run);
+        heap[i].record = buffer + i*rs;
+        heap[i].run    = runs[i].run;
+        if (fread(heap[i].record, rs, 1, heap[i].run) != 1) ret = URB_IO_ERROR;
+    }
+    for (i = k; i-- > 0;) urb_load_sift(heap, k, i, config->compare_key);
+    while (k > 0 && ret == URB_SUCCESS) {
+        if (m > 0 && config->compare_key(out + (m-1)*rs, heap[0].record) == 0)
+            load->duplicates++;
+        else 
+            memcpy(out + (m++)*rs, heap[0].record, rs);
+        if (fread(heap[0].record, rs, 1, heap[0].run) != 1) heap[0] = heap[--k];
+        urb_load_sift(heap, k, 0, config->compare_key);
+    }
+    load->n = m;
+    free(heap);
+    free(buffer);
+    return ret;
+}
+
+int urb_tree_load(urb_t **urb, FILE *input, 
+                  const urb_load_config_t *config, urb_load_t *load) {
+    size_t rs = config->record_size, per, n = 0, k = 0, cap = 0, i;
+    int threads = config->threads > 0 ? config->threads : 1, t, ret;
+    urb_load_run_t *runs = NULL, *grown, batch[threads];
+    pthread_t workers[threads];
+    bool started[threads];
+    char *block;
+    urb_t *nodes;
+    double t0;
+    if (rs == 0 || config->compare_key == NULL) return URB_INVALID_VALUE;
+    if (*urb != &urb_sentinel) return URB_INVALID_VALUE;
+    memset(load, 0, sizeof(urb_load_t));
+    per   = config->memory/threads/rs;
+    if (per == 0) per = 1;
+    if ((block = (char *)malloc(threads*per*rs)) == NULL)
+        URB_EXIT(URB_OUT_OF_MEMORY, "failed to allocate the run buffers");
+    for (ret = URB_SUCCESS; ret == URB_SUCCESS && !feof(input);) {
+        /// Fill one run per thread.
+        t0 = urb_load_now();
+        for (t = 0; t < threads; ++t) {
+            batch[t].records = block + t*per*rs;
+            batch[t].n       = fread(batch[t].records, rs, per, input);
+            batch[t].config  = config;
+            n += batch[t].n;
+        }
+        load->read += urb_load_now() - t0;
+        t0 = urb_load_now();
+        /// No worker for an empty run (the last read round).
+        for (t = 0; t < threads; ++t) {
+            started[t] = batch[t].n > 0 &&
+                         !pthread_create(&workers[t], NULL, 
+                                         urb_load_sort, &batch[t]);
+            if (!started[t] && batch[t].n > 0) urb_load_sort(&batch[t]);
+        }
+        for (t = 0; t < threads; ++t) 
+            if (started[t]) pthread_join(workers[t], NULL);
+        load->sort += urb_load_now() - t0;
+        t0 = urb_load_now();
+        for (t = 0; t < threads && batch[t].n > 0; ++t) {
+            if (k == cap) {
+                cap   = cap ? 2*cap : 16;
+                grown = (urb_load_run_t *)realloc(runs, 
+                                                  cap*sizeof(urb_load_run_t));
+                if (grown == NULL) 
+                    URB_EXIT(URB_OUT_OF_MEMORY, "failed to grow the runs");
+                runs = grown;
+            }
+            runs[k] = batch[t];
+            if ((runs[k].run = urb_load_tmpfile(config->tmpdir)) == NULL ||
+                fwrite(batch[t].records, rs, batch[t].n, runs[k].run) 
+                != batch[t].n) ret = URB_IO_ERROR;
+            if (runs[k].run != NULL) k++;
+        }
+        load->spill += urb_load_now() - t0;
+        if (ferror(input)) ret = URB_IO_ERROR;
+    }
+    free(block);
+    load->runs = k;
+    t0 = urb_load_now();
+    if (ret == URB_SUCCESS) ret = urb_load_merge(runs, k, n, config, load);
+    for (i = 0; i < k; ++i) fclose(runs[i].run);
+    free(runs);
+    load->merge = urb_load_now() - t0;
+    if (ret != URB_SUCCESS) return ret;
+    t0 = urb_load_now();
+    if ((nodes = urb_tree_slab_alloc(load->n)) != NULL) {
+        for (i = 0; i < load->n; ++i) {
+            nodes[i].key   = (char *)load->records + i*rs;
+            nodes[i].value = nodes[i].key;
+#ifdef __URB_TREE_PREFIX
+            nodes[i].prefix = 0;
+#endif
+        }
+        *urb = urb_build_link(nodes, load->n);
+    }
+    load->build = urb_load_now() - t0;
+    return URB_SUCCESS;
+}
+
+CPPGUARD_END();
@@ -0,0 +1,494 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file urb_tree_pool.c
+/// @author Issam SAID
+/// @brief Implement the index-based Red-Black trees (node pools).
+///
+/// @details The rotations and the fixes are the ones of urb_tree_fixin.c 
+/// and of urb_tree_erase_node written with indices. The sentinel (index 0)
+/// is black, its parent link is written by the removal (as in the pointer
+/// version) and reset afterwards.
+///
+/// The COLD macro reaches the parent link, the color and the value, in the
+/// nodes themselves or in the cold array of a split pool.
+///
+#include <string.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <urb_tree/pool.h>
+#include <urb_tree/error.h>
+
+CPPGUARD_BEGIN();
+
+#ifdef __URB_TREE_POOL_SPLIT
+#define URB_POOL_MAGIC "URBPOLS2"
+#define COLD(i)   (pool->cold[i])
+#else
+#define URB_POOL_MAGIC "URBPOOL2"
+#define COLD(i)   (pool->nodes[i])
+#endif
+
+///
+/// @brief The header of a saved pool, followed by the nodes [0, size) (and
+///        the cold nodes [0, size) of a split pool).
+///
+typedef struct {
+    char     magic[8];
+    uint32_t size;
+    uint32_t n;
+    uint32_t root;
+    uint32_t free;
+} urb_pool_header_t;
+
+/// The bytes of a node in a saved pool.
+#ifdef __URB_TREE_POOL_SPLIT
+#define URB_POOL_NODE (sizeof(urb_pnode_t) + sizeof(urb_pcold_t))
+#else
+#define URB_POOL_NODE sizeof(urb_pnode_t)
+#endif
+
+#define NODE(i)   (pool->nodes[i])
+#define LEFT(i)   (NODE(i).left)
+#define RIGHT(i)  (NODE(i).right)
+#define PARENT(i) (COLD(i).parent)
+#define IS_RED(i) (COLD(i).red)
+
+static inline void urb_pool_set_parent(urb_pool_t *pool, 
+                                       uint32_t i, uint32_t p) {
+    COLD(i).parent = p;
+}
+
+static inline void urb_pool_set_red(urb_pool_t *pool, uint32_t i, bool red) {
+    COLD(i).red = red;
+}
+
+static inline void urb_pool_left_rotate(urb_pool_t *pool, uint32_t n) {
+    uint32_t y = RIGHT(n), p = PARENT(n);
+    RIGHT(n) = LEFT(y);
+    if (LEFT(y)) urb_pool_set_parent(pool, LEFT(y), n);
+    urb_pool_set_parent(pool, y, p);
+    if (p == 0)            pool->root = y;
+    else if (n == LEFT(p)) LEFT(p)    = y;
+    else                   RIGHT(p)   = y;
+    LEFT(y) = n;
+    urb_pool_set_parent(pool, n, y);
+}
+
+static inline void urb_pool_right_rotate(urb_pool_t *pool, uint32_t n) {
+    uint32_t y = LEFT(n), p = PARENT(n);
+    LEFT(n) = RIGHT(y);
+    if (RIGHT(y)) urb_pool_set_parent(pool, RIGHT(y), n);
+    urb_pool_set_parent(pool, y, p);
+    if (p == 0)             pool->root = y;
+    else if (n == RIGHT(p)) RIGHT(p)   = y;
+    else                    LEFT(p)    = y;
+    RIGHT(y) = n;
+    urb_pool_set_parent(pool, n, y);
+}
+
+static void urb_pool_fix_put(urb_pool_t *pool, uint32_t n) {
+    uint32_t p, g, uncle;
+    while (n != pool->root && IS_RED(p = PARENT(n))) {
+        g = PARENT(p);
+        if (p == LEFT(g)) {
+            uncle = RIGHT(g);
+            if (IS_RED(uncle)) {
+                /// CASE 1: uncle and parent are RED.
+                urb_pool_set_red(pool, p, false);
+                urb_pool_set_red(pool, uncle, false);
+                urb_pool_set_red(pool, g, true);
+                n = g;
+            } else {
+                /// CASE 3: bring it to CASE 2.
+                if (n == RIGHT(p)) {
+                    n = p;
+                    urb_pool_left_rotate(pool, n);
+                    p = PARENT(n);
+                }
+                /// CASE 2: parent is RED, uncle is BLACK.
+                urb_pool_set_red(pool, p, false);
+                urb_pool_set_red(pool, g, true);
+                urb_pool_right_rotate(pool, g);
+            }
+        } else {
+            uncle = LEFT(g);
+            if (IS_RED(uncle)) {
+                /// CASE 1
+                urb_pool_set_red(pool, p, false);
+                urb_pool_set_red(pool, uncle, false);
+                urb_pool_set_red(pool, g, true);
+                n = g;
+            } else {
+                /// CASE 3
+                if (n == LEFT(p)) {
+                    n = p;
+                    urb_pool_right_rotate(pool, n);
+                    p = PARENT(n);
+                }
+                /// CASE 2
+                urb_pool_set_red(pool, p, false);
+                urb_pool_set_red(pool, g, true);
+                urb_pool_left_rotate(pool, g);
+            }
+        }
+    }
+    urb_pool_set_red(pool, pool->root, false);
+}
+
+static void urb_pool_fix_pop(urb_pool_t *pool, uint32_t n) {
+    uint32_t w;
+    while (n != pool->root && !IS_RED(n)) {
+        if (n == LEFT(PARENT(n))) {
+            w = RIGHT(PARENT(n));
+            if (IS_RED(w)) {
+                urb_pool_set_red(pool, w, false);
+                urb_pool_set_red(pool, PARENT(n), true);
+                urb_pool_left_rotate(pool, PARENT(n));
+                w = RIGHT(PARENT(n));
+            }
+            if (!IS_RED(LEFT(w)) && !IS_RED(RIGHT(w))) {
+                urb_pool_set_red(pool, w, true);
+                n = PARENT(n);
+            } else {
+                if (!IS_RED(RIGHT(w))) {
+                    urb_pool_set_red(pool, LEFT(w), false);
+                    urb_pool_set_red(pool, w, true);
+                    urb_pool_right_rotate(pool, w);
+                    w = RIGHT(PARENT(n));
+                }
+                urb_pool_set_red(pool, w, IS_RED(PARENT(n)));
+                urb_pool_set_red(pool, PARENT(n), false);
+                urb_pool_set_red(pool, RIGHT(w), false);
+                urb_pool_left_rotate(pool, PARENT(n));
+                n = pool->root;
+            }
+        } else {
+            w = LEFT(PARENT(n));
+            if (IS_RED(w)) {
+                urb_pool_set_red(pool, w, false);
+                urb_pool_set_red(pool, PARENT(n), true);
+                urb_pool_right_rotate(pool, PARENT(n));
+                w = LEFT(PARENT(n));
+            }
+            if (!IS_RED(RIGHT(w)) && !IS_RED(LEFT(w))) {
+                urb_pool_set_red(pool, w, true);
+                n = PARENT(n);
+            } else {
+                if (!IS_RED(LEFT(w))) {
+                    urb_pool_set_red(pool, RIGHT(w), false);
+                    urb_pool_set_red(pool, w, true);
+                    urb_pool_left_rotate(pool, w);
+                    w = LEFT(PARENT(n));
+                }
+                urb_pool_set_red(pool, w, IS_RED(PARENT(n)));
+                urb_pool_set_red(pool, PARENT(n), false);
+                urb_pool_set_red(pool, LEFT(w), false);
+                urb_pool_right_rotate(pool, PARENT(n));
+                n = pool->root;
+            }
+        }
+    }
+    urb_pool_set_red(pool, n, false);
+}
+
+///
+/// @brief Replace the subtree rooted at u by the subtree rooted at v.
+///
+static inline void urb_pool_transplant(urb_pool_t *pool, 
+                                       uint32_t u, uint32_t v) {
+    uint32_t p = PARENT(u);
+    if (p == 0)            pool->root = v;
+    else if (u == LEFT(p)) LEFT(p)    = v;
+    else                   RIGHT(p)   = v;
+    urb_pool_set_parent(pool, v, p);
+}
+
+///
+/// @brief Move the nodes to arrays of a given capacity, the new nodes are
+///        zeroed. The (hot) nodes are 64-byte aligned.
+///
+static void urb_pool_resize(urb_pool_t *pool, uint32_t capacity) {
+    void *nodes;
+    if (posix_memalign(&nodes, 64, (size_t)capacity*sizeof(urb_pnode_t)))
+        URB_EXIT(URB_OUT_OF_MEMORY, "failed to allocate urb_tree pool");
+    memset(nodes, 0, (size_t)capacity*sizeof(urb_pnode_t));
+    if (pool->nodes != NULL) 
+        memcpy(nodes, pool->nodes, (size_t)pool->size*sizeof(urb_pnode_t));
+    free(pool->nodes);
+    pool->nodes = (urb_pnode_t *)nodes;
+#ifdef __URB_TREE_POOL_SPLIT
+    pool->cold = (urb_pcold_t *)realloc(pool->cold, 
+                                        (size_t)capacity*sizeof(urb_pcold_t));
+    if (pool->cold == NULL) 
+        URB_EXIT(URB_OUT_OF_MEMORY, "failed to allocate urb_tree pool");
+    memset(pool->cold + pool->size, 0, 
+           (size_t)(capacity - pool->size)*sizeof(urb_pcold_t));
+#endif
+    pool->capacity = capacity;
+}
+
+int urb_pool_init(urb_pool_t *pool, uint32_t capacity) {
+    memset(pool, 0, sizeof(urb_pool_t));
+    urb_pool_resize(pool, capacity < 16 ? 16 : 
+                          capacity >= URB_POOL_INDEX ? URB_POOL_INDEX : 
+                          capacity + 1);
+    pool->size = 1;
+    return URB_SUCCESS;
+}
+
+void urb_pool_delete(urb_pool_t *pool) {
+    free(pool->nodes);
+#ifdef __URB_TREE_POOL_SPLIT
+    free(pool->cold);
+#endif
+    memset(pool, 0, sizeof(urb_pool_t));
+}
+
+///
+/// @brief Take a node from the free list, or from the end of the array.
+///
+static uint32_t urb_pool_alloc(urb_pool_t *pool) {
+    uint32_t i;
+    if ((i = pool->free) != 0) {
+        pool->free = LEFT(i);
+        return i;
+    }
+    if (pool->size == pool->capacity) {
+        if (pool->capacity == URB_POOL_INDEX) 
+            URB_EXIT(URB_OUT_OF_MEMORY, "urb_tree pool is full");
+        urb_pool_resize(pool, pool->capacity > URB_POOL_INDEX/2 ? 
+                              URB_POOL_INDEX : 2*pool->capacity);
+    }
+    return pool->size++;
+}
+
+uint32_t urb_pool_put(urb_pool_t *pool, int64_t key, uint64_t value) {
+    uint32_t i = pool->root, p = 0, n;
+    while (i) {
+        if (key == NODE(i).key) 
+            URB_EXIT(URB_DUPLICATE_KEY, "key already exists");
+        p = i;
+        i = key < NODE(i).key ? LEFT(i) : RIGHT(i);
+    }
+    n = urb_pool_alloc(pool);
+    NODE(n).key    = key;
+    NODE(n).left   = 0;
+    NODE(n).right  = 0;
+    COLD(n).value  = value;
+    COLD(n).parent = p;
+    COLD(n).red    = 1;
+    if (p == 0)                 pool->root = n;
+    else if (key < NODE(p).key) LEFT(p)    = n;
+    else                        RIGHT(p)   = n;
+    urb_pool_fix_put(pool, n);
+    pool->n++;
+    return n;
+}
+
+uint32_t urb_pool_find(urb_pool_t *pool, int64_t key) {
+    const urb_pnode_t *nodes = pool->nodes;
+    uint32_t i = pool->root;
+    while (i && key != nodes[i].key) 
+        i = key < nodes[i].key ? nodes[i].left : nodes[i].right;
+    return i;
+}
+
+bool urb_pool_pop(urb_pool_t *pool, int64_t key, uint64_t *value) {
+    uint32_t z = urb_pool_find(pool, key), y, x;
+    bool red;
+    if (z == 0) return false;
+    if (value) *value = COLD(z).value;
+    y   = z;
+    red = IS_RED(y);
+    if (LEFT(z) == 0) {
+        x = RIGHT(z);
+        urb_pool_transplant(pool, z, x);
+    } else if (RIGHT(z) == 0) {
+        x = LEFT(z);
+        urb_pool_transplant(pool, z, x);
+    } else {
+        for (y = RIGHT(z); LEFT(y); y = LEFT(y));
+        red = IS_RED(y);
+        x   = RIGHT(y);
+        if (PARENT(y) == z) {
+            urb_pool_set_parent(pool, x, y);
+        } else {
+            urb_pool_transplant(pool, y, x);
+            RIGHT(y) = RIGHT(z);
+            urb_pool_set_parent(pool, RIGHT(y), y);
+        }
+        urb_pool_transplant(pool, z, y);
+        LEFT(y) = LEFT(z);
+        urb_pool_set_parent(pool, LEFT(y), y);
+        urb_pool_set_red(pool, y, IS_RED(z));
+    }
+    if (!red) urb_pool_fix_pop(pool, x);
+    COLD(0).parent = 0;
+    NODE(0).left   = 0;
+    NODE(0).right  = 0;
+    LEFT(z)    = pool->free;
+    pool->free = z;
+    pool->n--;
+    return true;
+}
+
+int64_t urb_pool_key(urb_pool_t *pool, uint32_t i) { return NODE(i).key; }
+
+uint64_t urb_pool_value(urb_pool_t *pool, uint32_t i) { return COLD(i).value; }
+
+uint32_t urb_pool_min(urb_pool_t *pool) {
+    uint32_t i = pool->root;
+    if (i) while (LEFT(i)) i = LEFT(i);
+    return i;
+}
+
+uint32_t urb_pool_max(urb_pool_t *pool) {
+    uint32_t i = pool->root;
+    if (i) while (RIGHT(i)) i = RIGHT(i);
+    return i;
+}
+
+uint32_t urb_pool_succ(urb_pool_t *pool, uint32_t i) {
+    uint32_t p;
+    if (RIGHT(i)) {
+        for (i = RIGHT(i); LEFT(i); i = LEFT(i));
+        return i;
+    }
+    for (p = PARENT(i); p && i == RIGHT(p); i = p, p = PARENT(p));
+    return p;
+}
+
+uint32_t urb_pool_prev(urb_pool_t *pool, uint32_t i) {
+    uint32_t p;
+    if (LEFT(i)) {
+        for (i = LEFT(i); RIGHT(i); i = RIGHT(i));
+        return i;
+    }
+    for (p = PARENT(i); p && i == LEFT(p); i = p, p = PARENT(p));
+    return p;
+}
+
+int urb_pool_save(urb_pool_t *pool, const char *path) {
+    urb_pool_header_t h;
+    FILE *f;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, URB_POOL_MAGIC, sizeof(h.magic));
+    h.size = pool->size;
+    h.n    = pool->n;
+    h.root = pool->root;
+    h.free = pool->free;
+    if ((f = fopen(path, "wb")) == NULL) return URB_IO_ERROR;
+    if (fwrite(&h, sizeof(h), 1, f) != 1 ||
+        fwrite(pool->nodes, sizeof(urb_pnode_t), pool->size, f) 
+        != pool->size
+#ifdef __URB_TREE_POOL_SPLIT
+        || fwrite(pool->cold, sizeof(urb_pcold_t), pool->size, f) 
+        != pool->size
+#endif
+        ) {
+        fclose(f);
+        return URB_IO_ERROR;
+    }
+    return fclose(f) == 0 ? URB_SUCCESS : URB_IO_ERROR;
+}
+
+///
+/// @brief Check that the links of the nodes [0, size) stay in the pool and
+///        that the sentinel has none.
+///
+static bool urb_pool_check_links(urb_pool_t *pool, uint32_t size) {
+    uint32_t i;
+    if (LEFT(0) || RIGHT(0) || PARENT(0)) return false;
+    for (i = 1; i < size; ++i) 
+        if (LEFT(i) >= size || RIGHT(i) >= size || PARENT(i) >= size) 
+            return false;
+    return true;
+}
+
+int urb_pool_load(urb_pool_t *pool, const char *path) {
+    urb_pool_header_t h;
+    struct stat st;
+    FILE *f;
+    if ((f = fopen(path, "rb")) == NULL) return URB_IO_ERROR;
+    /// Any 32-bit size is a valid pool, the file must hold its nodes.
+    if (fread(&h, sizeof(h), 1, f) != 1 || fstat(fileno(f), &st) != 0 ||
+        memcmp(h.magic, URB_POOL_MAGIC, sizeof(h.magic)) != 0 ||
+        h.size == 0 || h.n >= h.size || 
+        h.root >= h.size || h.free >= h.size ||
+        (uint64_t)st.st_size != sizeof(h) + (uint64_t)h.size*URB_POOL_NODE) {
+        fclose(f);
+        return URB_IO_ERROR;
+    }
+    urb_pool_init(pool, h.size);
+    if (fread(pool->nodes, sizeof(urb_pnode_t), h.size, f) != h.size
+#ifdef __URB_TREE_POOL_SPLIT
+        || fread(pool->cold, sizeof(urb_pcold_t), h.size, f) != h.size
+#endif
+        || !urb_pool_check_links(pool, h.size)) {
+        fclose(f);
+        urb_pool_delete(pool);
+        return URB_IO_ERROR;
+    }
+    fclose(f);
+    pool->size = h.size;
+    pool->n    = h.n;
+    pool->root = h.root;
+    pool->free = h.free;
+    return URB_SUCCESS;
+}
+
+///
+/// @brief Return the black height of a subtree, or -1 if it is invalid.
+///
+static int urb_pool_check_node(urb_pool_t *pool, uint32_t i, 
+                               const int64_t *lo, const int64_t *hi, 
+                               uint32_t *count) {
+    int l, r;
+    if (i == 0) return 1;
+    if ((lo && NODE(i).key <= *lo) || (hi && NODE(i).key >= *hi)) return -1;
+    if (IS_RED(i) && (IS_RED(LEFT(i)) || IS_RED(RIGHT(i)))) return -1;
+    if ((LEFT(i)  && PARENT(LEFT(i))  != i) || 
+        (RIGHT(i) && PARENT(RIGHT(i)) != i)) return -1;
+    (*count)++;
+    l = urb_pool_check_node(pool, LEFT(i),  lo, &NODE(i).key, count);
+    r = urb_pool_check_node(pool, RIGHT(i), &NODE(i).key, hi, count);
+    if (l < 0 || l != r) return -1;
+    return l + !IS_RED(i);
+}
+
+bool urb_pool_check(urb_pool_t *pool) {
+    uint32_t count = 0;
+    if (IS_RED(0) || IS_RED(pool->root) || PARENT(pool->root) != 0) 
+        return false;
+    if (urb_pool_check_node(pool, pool->root, NULL, NULL, &count) < 0) 
+        return false;
+    return count == pool->n;
+}
+
+CPPGUARD_END();
@@ -0,0 +1,112 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file urb_tree_pq.c
+/// @author Issam SAID
+/// @brief Implement the priority queue mode of Red-Black trees.
+///
+#include <stdbool.h>
+#include <urb_tree/pq.h>
+#include <urb_tree/core.h>
+#include <urb_tree/fixin.h>
+#include <urb_tree/util.h>
+#include <urb_tree/sentinel.h>
+#include <urb_tree/error.h>
+
+CPPGUARD_BEGIN();
+
+///
+/// @brief The neighbours returned by urb_tree_succ/prev may be NULL or the 
+///        sentinel at the ends of the tree.
+///
+static inline urb_t *urb_pq_node(urb_t *n) {
+    return n == &urb_sentinel ? NULL : n;
+}
+
+///
+/// @brief Check whether n is on the left (right) spine with no left (right)
+///        child, i.e. holds the smallest (largest) key. Most nodes leave 
+///        the spine after a couple of steps up.
+///
+static inline bool urb_pq_extreme(urb_t *n, bool left) {
+    if (n->child[!left] != &urb_sentinel) return false;
+    while (n->parent != NULL && n->parent != &urb_sentinel) {
+        if (n != n->parent->child[!left]) return false;
+        n = n->parent;
+    }
+    return true;
+}
+
+void urb_pq_init(urb_pq_t *pq) {
+    pq->root = &urb_sentinel;
+    pq->min  = NULL;
+    pq->max  = NULL;
+}
+
+int urb_pq_put(urb_pq_t *pq, urb_t *n, int (*compare_key)(void*, void*)) {
+    int ret = urb_tree_put(&pq->root, n, compare_key);
+    if (pq->min == NULL || urb_pq_extreme(n, true))  pq->min = n;
+    if (pq->max == NULL || urb_pq_extreme(n, false)) pq->max = n;
+    return ret;
+}
+
+///
+/// @brief Unlink a node and keep the extremes up to date.
+///
+static urb_t *urb_pq_unlink(urb_pq_t *pq, urb_t *n) {
+    if (n == pq->min) pq->min = urb_pq_node(urb_tree_succ(n));
+    if (n == pq->max) pq->max = urb_pq_node(urb_tree_prev(n));
+    return urb_tree_erase_node(&pq->root, n);
+}
+
+urb_t *urb_pq_pop(urb_pq_t *pq, void *key, int (*compare_key)(void*, void*)) {
+    urb_t *n = urb_tree_find(&pq->root, key, compare_key);
+    if (n == &urb_sentinel) return &urb_sentinel;
+    return urb_pq_unlink(pq, n);
+}
+
+urb_t *urb_pq_min(urb_pq_t *pq) { return pq->min; }
+
+urb_t *urb_pq_max(urb_pq_t *pq) { return pq->max; }
+
+urb_t *urb_tree_pop_min(urb_pq_t *pq) {
+    return pq->min ? urb_pq_unlink(pq, pq->min) : NULL;
+}
+
+urb_t *urb_tree_pop_max(urb_pq_t *pq) {
+    return pq->max ? urb_pq_unlink(pq, pq->max) : NULL;
+}
+
+int urb_pq_delete(urb_pq_t *pq, 
+                  void (*release_key)(void*), void (*release_value)(void*)) {
+    int ret = urb_tree_delete(&pq->root, release_key, release_value);
+    urb_pq_init(pq);
+    return ret;
+}
+
+CPPGUARD_END();
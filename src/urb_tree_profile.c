@@ -0,0 +1,226 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file urb_tree_profile.c
+/// @author Issam SAID
+/// @brief Implement the routines that profile the shape and the memory 
+/// footprint of Red-Black trees.
+///
+/// @details The full profile visits every node once: the top of the tree
+/// is walked sequentially down to URB_PROFILE_SPLIT_DEPTH and the subtrees
+/// hanging below are profiled in parallel with OpenMP. The sampled profile
+/// runs random descents picking a child uniformly at each level, every 
+/// visited node is weighted by the product of the branching factors above 
+/// it, which gives an unbiased estimate of the counts (Knuth's estimator).
+///
+#include <string.h>
+#include <urb_tree/profile.h>
+#include <urb_tree/sentinel.h>
+#include <urb_tree/error.h>
+
+CPPGUARD_BEGIN();
+
+///
+/// @brief The depth where the tree is split into parallel subtrees.
+///
+#define URB_PROFILE_SPLIT_DEPTH 7
+
+typedef struct {
+    double nodes, red, black, depth_sum, key_bytes, value_bytes;
+    double depths[URB_PROFILE_DEPTHS];
+    size_t height;
+} urb_profile_acc_t;
+
+static inline void __profile_node(urb_t *n, size_t depth, double weight,
+                                  size_t (*key_size)(void*), 
+                                  size_t (*value_size)(void*),
+                                  urb_profile_acc_t *acc) {
+    acc->nodes     += weight;
+    acc->depth_sum += weight*depth;
+    if (n->color == red) acc->red   += weight;
+    else                 acc->black += weight;
+    if (depth < URB_PROFILE_DEPTHS) acc->depths[depth] += weight;
+    if (depth > acc->height) acc->height = depth;
+    if (key_size)   acc->key_bytes   += weight*key_size(n->key);
+    if (value_size) acc->value_bytes += weight*value_size(n->value);
+}
+
+static void __profile_merge(urb_profile_acc_t *dst, urb_profile_acc_t *src) {
+    size_t d;
+    dst->nodes       += src->nodes;
+    dst->red         += src->red;
+    dst->black       += src->black;
+    dst->depth_sum   += src->depth_sum;
+    dst->key_bytes   += src->key_bytes;
+    dst->value_bytes += src->value_bytes;
+    for (d = 0; d < URB_PROFILE_DEPTHS; ++d) dst->depths[d] += src->depths[d];
+    if (src->height > dst->height) dst->height = src->height;
+}
+
+static void __profile_subtree(urb_t **urb, size_t depth,
+                              size_t (*key_size)(void*), 
+                              size_t (*value_size)(void*),
+                              urb_profile_acc_t *acc) {
+    if ((*urb) == &urb_sentinel) return;
+    __profile_node(*urb, depth, 1.0, key_size, value_size, acc);
+    __profile_subtree(&(*urb)->left,  depth+1, key_size, value_size, acc);
+    __profile_subtree(&(*urb)->right, depth+1, key_size, value_size, acc);
+}
+
+///
+/// @brief Profile the top of the tree and collect the subtrees rooted at 
+///        the split depth.
+///
+static void __profile_top(urb_t **urb, size_t depth,
+                          size_t (*key_size)(void*), 
+                          size_t (*value_size)(void*),
+                          urb_profile_acc_t *acc, 
+                          urb_t ***roots, size_t *nroots) {
+    if ((*urb) == &urb_sentinel) return;
+    if (depth == URB_PROFILE_SPLIT_DEPTH) { roots[(*nroots)++] = urb; return; }
+    __profile_node(*urb, depth, 1.0, key_size, value_size, acc);
+    __profile_top(&(*urb)->left,  depth+1, key_size, value_size, 
+                  acc, roots, nroots);
+    __profile_top(&(*urb)->right, depth+1, key_size, value_size, 
+                  acc, roots, nroots);
+}
+
+static void __profile_finish(urb_t **urb, urb_profile_acc_t *acc, 
+                             double scale, urb_profile_t *profile) {
+    size_t d;
+    urb_t *n = *urb;
+    profile->nodes        = (size_t)(acc->nodes*scale + 0.5);
+    profile->red          = (size_t)(acc->red*scale + 0.5);
+    profile->black        = (size_t)(acc->black*scale + 0.5);
+    profile->height       = acc->height;
+    profile->avg_depth    = acc->nodes > 0 ? acc->depth_sum/acc->nodes : 0;
+    profile->red_ratio    = acc->nodes > 0 ? acc->red/acc->nodes : 0;
+    profile->node_bytes   = profile->nodes*sizeof(urb_t);
+    profile->key_bytes    = (size_t)(acc->key_bytes*scale + 0.5);
+    profile->value_bytes  = (size_t)(acc->value_bytes*scale + 0.5);
+    for (d = 0; d < URB_PROFILE_DEPTHS; ++d) 
+        profile->depths[d] = (size_t)(acc->depths[d]*scale + 0.5);
+    profile->black_height = 0;
+    while (n != &urb_sentinel) {
+        if (n->color == black) profile->black_height++;
+        n = n->left;
+    }
+}
+
+int urb_tree_profile(urb_t **urb, 
+                     size_t (*key_size)(void*), size_t (*value_size)(void*),
+                     urb_profile_t *profile) {
+    urb_t **roots[1 << (URB_PROFILE_SPLIT_DEPTH-1)];
+    size_t nroots = 0;
+    long i;
+    urb_profile_acc_t acc;
+    if (profile == NULL) 
+        URB_EXIT(URB_INVALID_VALUE, "the profile can not be NULL");
+    memset(&acc, 0, sizeof(acc));
+    __profile_top(urb, 1, key_size, value_size, &acc, roots, &nroots);
+    #pragma omp parallel for schedule(dynamic)
+    for (i = 0; i < (long)nroots; ++i) {
+        urb_profile_acc_t local;
+        memset(&local, 0, sizeof(local));
+        __profile_subtree(roots[i], URB_PROFILE_SPLIT_DEPTH, 
+                          key_size, value_size, &local);
+        #pragma omp critical
+        __profile_merge(&acc, &local);
+    }
+    memset(profile, 0, sizeof(urb_profile_t));
+    __profile_finish(urb, &acc, 1.0, profile);
+    return URB_SUCCESS;
+}
+
+static inline unsigned int __profile_rand(unsigned int *state) {
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+int urb_tree_profile_sampled(urb_t **urb, size_t samples, unsigned int seed,
+                             size_t (*key_size)(void*), 
+                             size_t (*value_size)(void*),
+                             urb_profile_t *profile) {
+    long s;
+    urb_profile_acc_t acc;
+    if (profile == NULL) 
+        URB_EXIT(URB_INVALID_VALUE, "the profile can not be NULL");
+    if (samples == 0) 
+        URB_EXIT(URB_INVALID_VALUE, "the number of samples can not be 0");
+    memset(&acc, 0, sizeof(acc));
+    #pragma omp parallel
+    {
+        urb_profile_acc_t local;
+        memset(&local, 0, sizeof(local));
+        #pragma omp for schedule(static)
+        for (s = 0; s < (long)samples; ++s) {
+            unsigned int state = (seed ^ (unsigned int)s*2654435761u) | 1u;
+            double weight = 1.0;
+            size_t depth  = 1;
+            urb_t *n      = *urb;
+            while (n != &urb_sentinel) {
+                urb_t *kids[2];
+                int nkids = 0;
+                __profile_node(n, depth, weight, key_size, value_size, &local);
+                if (n->left  != &urb_sentinel) kids[nkids++] = n->left;
+                if (n->right != &urb_sentinel) kids[nkids++] = n->right;
+                if (nkids == 0) break;
+                n       = kids[nkids == 1 ? 0 : __profile_rand(&state) & 1];
+                weight *= nkids;
+                depth++;
+            }
+        }
+        #pragma omp critical
+        __profile_merge(&acc, &local);
+    }
+    memset(profile, 0, sizeof(urb_profile_t));
+    __profile_finish(urb, &acc, 1.0/samples, profile);
+    profile->sampled = true;
+    return URB_SUCCESS;
+}
+
+void urb_tree_profile_print(FILE *stream, urb_profile_t *profile, 
+                            bool verbose) {
+    size_t d;
+    fprintf(stream, "... %s profile: %zu nodes (%zu red, %zu black, "
+            "red ratio %.3f).\n", profile->sampled ? "sampled" : "full",
+            profile->nodes, profile->red, profile->black, profile->red_ratio);
+    fprintf(stream, "... height %zu, black height %zu, average depth %.2f.\n",
+            profile->height, profile->black_height, profile->avg_depth);
+    fprintf(stream, "... %zu bytes of nodes, %zu bytes of keys, "
+            "%zu bytes of values.\n", profile->node_bytes, 
+            profile->key_bytes, profile->value_bytes);
+    if (!verbose) return;
+    for (d = 1; d < URB_PROFILE_DEPTHS && d <= profile->height; ++d)
+        fprintf(stream, "...   depth %3zu: %zu nodes.\n", d, profile->depths[d]);
+}
+
+CPPGUARD_END();
@@ -0,0 +1,141 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+///
+/// @file urb_tree_relaxed.c
+/// @author Issam SAID
+/// @brief Implement the relaxed (deferred) balancing of Red-Black trees.
+///
+/// @details The pending nodes are kept in a stack. A step takes the last 
+/// one, drops it if it is no longer in violation, otherwise does one 
+/// fix-up step with urb_tree_fix_red and pushes the recolored grandparent,
+/// if any. Every red node with a red parent is on the stack: a rotation 
+/// only gives a new red parent to a node that already had one.
+///
+#include <stdlib.h>
+#include <urb_tree/relaxed.h>
+#include <urb_tree/core.h>
+#include <urb_tree/fixin.h>
+#include <urb_tree/sentinel.h>
+#include <urb_tree/error.h>
+#include <urb_tree/stats.h>
+
+CPPGUARD_BEGIN();
+
+#define IN_VIOLATION(n) \
+    ((n)->color == red && (n)->parent && (n)->parent->color == red)
+
+static void urb_relaxed_push(urb_relaxed_t *relaxed, urb_t *n) {
+    if (relaxed->n == relaxed->capacity) {
+        relaxed->capacity = relaxed->capacity ? 2*relaxed->capacity : 64;
+        relaxed->pending  = (urb_t **)realloc(relaxed->pending, 
+                                      relaxed->capacity*sizeof(urb_t*));
+        if (relaxed->pending == NULL)
+            URB_EXIT(URB_OUT_OF_MEMORY, "failed to allocate the violations");
+    }
+    relaxed->pending[relaxed->n++] = n;
+}
+
+int urb_relaxed_begin(urb_relaxed_t *relaxed, urb_t **urb, size_t budget) {
+    relaxed->urb      = urb;
+    relaxed->pending  = NULL;
+    relaxed->n        = 0;
+    relaxed->capacity = 0;
+    relaxed->budget   = budget;
+    relaxed->steps    = 0;
+    return URB_SUCCESS;
+}
+
+int urb_relaxed_put(urb_relaxed_t *relaxed, urb_t *n,
+                    int (*compare_key)(void*, void*)) {
+    int ret = 0;                                       
+    urb_t *p = NULL;        
+    urb_t *i = *relaxed->urb;
+    if (n == NULL) 
+        URB_EXIT(URB_INVALID_NODE, "the node to insert can not be NULL");
+    size_t depth = 0;
+    while (i != &urb_sentinel) {                            
+        depth++;
+        if((ret = compare_key(n->key, i->key))==0) 
+            URB_EXIT(URB_DUPLICATE_KEY, "key already exists");
+        p = i;
+        i = i->child[ret > 0];
+    }                                                      
+    n->parent = p;                                    
+    n->color  = red;
+    if (p) p->child[ret > 0] = n;
+    else   *relaxed->urb = n;
+    URB_STATS_OP(put, depth, depth);
+    if (p == NULL)       n->color = black;
+    else if (p->color == red) urb_relaxed_push(relaxed, n);
+    if (relaxed->budget) urb_relaxed_step(relaxed, relaxed->budget);
+    return URB_SUCCESS;                                    
+}
+
+urb_t *urb_relaxed_pop(urb_relaxed_t *relaxed, void *key,
+                       int (*compare_key)(void*, void*)) {
+    if (relaxed->n) urb_tree_rebalance(relaxed);
+    return urb_tree_pop(relaxed->urb, key, compare_key);
+}
+
+bool urb_relaxed_step(urb_relaxed_t *relaxed, size_t budget) {
+    urb_t *n, *up;
+    while (relaxed->n && budget) {
+        n = relaxed->pending[relaxed->n - 1];
+        if (!IN_VIOLATION(n)) {
+            relaxed->n--;
+            continue;
+        }
+        up = urb_tree_fix_red(relaxed->urb, n);
+        if (up) {
+            if (up->parent == NULL) up->color = black;
+            else if (IN_VIOLATION(up)) urb_relaxed_push(relaxed, up);
+        }
+        relaxed->steps++;
+        budget--;
+    }
+    /// Drop the nodes that are no longer in violation.
+    while (relaxed->n && !IN_VIOLATION(relaxed->pending[relaxed->n - 1]))
+        relaxed->n--;
+    return relaxed->n == 0;
+}
+
+int urb_tree_rebalance(urb_relaxed_t *relaxed) {
+    urb_relaxed_step(relaxed, (size_t)-1);
+    return URB_SUCCESS;
+}
+
+int urb_relaxed_end(urb_relaxed_t *relaxed) {
+    urb_tree_rebalance(relaxed);
+    free(relaxed->pending);
+    relaxed->pending  = NULL;
+    relaxed->capacity = 0;
+    return URB_SUCCESS;
+}
+
+CPPGUARD_END();
@@ -0,0 +1,262 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file urb_tree_shm.c
+/// @author Issam SAID
+/// @brief Implement the shared trees (pools in shared memory).
+///
+/// @details The segment is laid out as the header, the nodes of the pool 
+/// (and the cold nodes of a split pool) then the fixed-size values, each 
+/// part starting on a 64-byte boundary. The node 0 is the sentinel of the
+/// pool, it is zeroed (black, no link) like the rest of a new segment. 
+/// The pool view of a process points to its own mapping, its counters are
+/// loaded from the header when the lock is taken and stored back when a 
+/// write lock is released.
+///
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <urb_tree/shm.h>
+#include <urb_tree/error.h>
+
+CPPGUARD_BEGIN();
+
+#ifdef __URB_TREE_POOL_SPLIT
+#define URB_SHM_MAGIC "URBSHT2"
+#else
+#define URB_SHM_MAGIC "URBSHM2"
+#endif
+
+#define URB_SHM_ALIGN(x) (((x) + 63) & ~(size_t)63)
+
+///
+/// @brief Compute the offsets of the nodes, of the cold nodes and of the 
+///        values in a segment, return the bytes of the segment.
+///
+static size_t urb_shm_offsets(uint32_t capacity, size_t value_size, 
+                              size_t offsets[3]) {
+    offsets[0] = URB_SHM_ALIGN(sizeof(urb_shm_header_t));
+    offsets[1] = offsets[0] + 
+                 URB_SHM_ALIGN((size_t)capacity*sizeof(urb_pnode_t));
+#ifdef __URB_TREE_POOL_SPLIT
+    offsets[2] = offsets[1] + 
+                 URB_SHM_ALIGN((size_t)capacity*sizeof(urb_pcold_t));
+#else
+    offsets[2] = offsets[1];
+#endif
+    return offsets[2] + (size_t)capacity*value_size;
+}
+
+///
+/// @brief Point the pool view and the values to the parts of the mapping,
+///        return the bytes of the segment.
+///
+static size_t urb_shm_layout(urb_shm_t *shm, 
+                             uint32_t capacity, size_t value_size) {
+    unsigned char *base = (unsigned char *)shm->header;
+    size_t offsets[3], length = urb_shm_offsets(capacity, value_size, 
+                                                offsets);
+    memset(&shm->pool, 0, sizeof(urb_pool_t));
+    shm->pool.nodes    = (urb_pnode_t *)(base + offsets[0]);
+#ifdef __URB_TREE_POOL_SPLIT
+    shm->pool.cold     = (urb_pcold_t *)(base + offsets[1]);
+#endif
+    shm->pool.capacity = capacity;
+    shm->value_size    = value_size;
+    shm->data          = value_size ? base + offsets[2] : NULL;
+    return length;
+}
+
+///
+/// @brief Open a shared memory object ("/name") or a file.
+///
+static int urb_shm_open(const char *name, int flags) {
+    if (name[0] == '/' && strchr(name + 1, '/') == NULL)
+        return shm_open(name, flags, 0600);
+    return open(name, flags, 0600);
+}
+
+int urb_shm_create(urb_shm_t *shm, const char *name, 
+                   uint32_t capacity, size_t value_size) {
+    pthread_rwlockattr_t attr;
+    size_t offsets[3], length;
+    memset(shm, 0, sizeof(urb_shm_t));
+    if (capacity == 0 || capacity >= URB_POOL_INDEX) 
+        return URB_INVALID_VALUE;
+    length = urb_shm_offsets(capacity + 1, value_size, offsets);
+    if ((shm->fd = urb_shm_open(name, O_RDWR | O_CREAT | O_EXCL)) < 0)
+        return URB_IO_ERROR;
+    if (ftruncate(shm->fd, (off_t)length) != 0 ||
+        (shm->header = (urb_shm_header_t *)mmap(NULL, length, 
+                                                PROT_READ | PROT_WRITE, 
+                                                MAP_SHARED, shm->fd, 0)) 
+        == MAP_FAILED) {
+        close(shm->fd);
+        memset(shm, 0, sizeof(urb_shm_t));
+        return URB_IO_ERROR;
+    }
+    shm->length = length;
+    urb_shm_layout(shm, capacity + 1, value_size);
+    pthread_rwlockattr_init(&attr);
+    pthread_rwlockattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_rwlock_init(&shm->header->lock, &attr);
+    pthread_rwlockattr_destroy(&attr);
+    shm->header->length     = length;
+    shm->header->value_size = value_size;
+    shm->header->capacity   = capacity + 1;
+    shm->header->size       = 1;
+    /// The magic comes last, a segment is attached once it is set up: the
+    /// fence orders the stores above before it.
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(shm->header->magic, URB_SHM_MAGIC, sizeof(shm->header->magic));
+    return URB_SUCCESS;
+}
+
+int urb_shm_attach(urb_shm_t *shm, const char *name) {
+    struct stat st;
+    urb_shm_header_t *h;
+    memset(shm, 0, sizeof(urb_shm_t));
+    if ((shm->fd = urb_shm_open(name, O_RDWR)) < 0) return URB_IO_ERROR;
+    if (fstat(shm->fd, &st) != 0 || 
+        (size_t)st.st_size < sizeof(urb_shm_header_t) ||
+        (h = (urb_shm_header_t *)mmap(NULL, (size_t)st.st_size, 
+                                      PROT_READ | PROT_WRITE, MAP_SHARED, 
+                                      shm->fd, 0)) == MAP_FAILED) {
+        close(shm->fd);
+        memset(shm, 0, sizeof(urb_shm_t));
+        return URB_IO_ERROR;
+    }
+    shm->header = h;
+    shm->length = (size_t)st.st_size;
+    if (memcmp(h->magic, URB_SHM_MAGIC, sizeof(h->magic)) != 0) {
+        urb_shm_detach(shm);
+        return URB_IO_ERROR;
+    }
+    /// Pairs with the fence of urb_shm_create, the header is read after 
+    /// the magic.
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (h->length != shm->length || h->capacity == 0 ||
+        urb_shm_layout(shm, h->capacity, h->value_size) != shm->length) {
+        urb_shm_detach(shm);
+        return URB_IO_ERROR;
+    }
+    return URB_SUCCESS;
+}
+
+int urb_shm_detach(urb_shm_t *shm) {
+    int error = URB_SUCCESS;
+    if (shm->header != NULL && munmap(shm->header, shm->length) != 0) 
+        error = URB_IO_ERROR;
+    if (close(shm->fd) != 0) error = URB_IO_ERROR;
+    memset(shm, 0, sizeof(urb_shm_t));
+    return error;
+}
+
+int urb_shm_unlink(const char *name) {
+    if (name[0] == '/' && strchr(name + 1, '/') == NULL)
+        return shm_unlink(name) == 0 ? URB_SUCCESS : URB_IO_ERROR;
+    return unlink(name) == 0 ? URB_SUCCESS : URB_IO_ERROR;
+}
+
+void urb_shm_lock(urb_shm_t *shm, bool write) {
+    urb_shm_header_t *h = shm->header;
+    if (write) pthread_rwlock_wrlock(&h->lock);
+    else       pthread_rwlock_rdlock(&h->lock);
+    shm->write     = write;
+    shm->pool.size = h->size;
+    shm->pool.n    = h->n;
+    shm->pool.root = h->root;
+    shm->pool.free = h->free;
+}
+
+void urb_shm_unlock(urb_shm_t *shm) {
+    urb_shm_header_t *h = shm->header;
+    if (shm->write) {
+        h->size = shm->pool.size;
+        h->n    = shm->pool.n;
+        h->root = shm->pool.root;
+        h->free = shm->pool.free;
+    }
+    pthread_rwlock_unlock(&h->lock);
+}
+
+void *urb_shm_data(urb_shm_t *shm, uint32_t i) {
+    return shm->data ? shm->data + (size_t)i*shm->value_size : NULL;
+}
+
+int urb_shm_put(urb_shm_t *shm, int64_t key, uint64_t value, 
+                const void *data) {
+    urb_pool_t *pool = &shm->pool;
+    int error = URB_SUCCESS;
+    uint32_t i;
+    urb_shm_lock(shm, true);
+    /// The pool would leave the process on both errors.
+    if (urb_pool_find(pool, key)) {
+        error = URB_DUPLICATE_KEY;
+    } else if (pool->free == 0 && pool->size == pool->capacity) {
+        error = URB_OUT_OF_MEMORY;
+    } else {
+        i = urb_pool_put(pool, key, value);
+        if (shm->data) {
+            if (data) memcpy(urb_shm_data(shm, i), data, shm->value_size);
+            else      memset(urb_shm_data(shm, i), 0, shm->value_size);
+        }
+    }
+    urb_shm_unlock(shm);
+    return error;
+}
+
+bool urb_shm_find(urb_shm_t *shm, int64_t key, uint64_t *value, 
+                  void *data) {
+    uint32_t i;
+    urb_shm_lock(shm, false);
+    if ((i = urb_pool_find(&shm->pool, key)) != 0) {
+        if (value) *value = urb_pool_value(&shm->pool, i);
+        if (data && shm->data) 
+            memcpy(data, urb_shm_data(shm, i), shm->value_size);
+    }
+    urb_shm_unlock(shm);
+    return i != 0;
+}
+
+bool urb_shm_pop(urb_shm_t *shm, int64_t key, uint64_t *value, void *data) {
+    uint32_t i;
+    urb_shm_lock(shm, true);
+    /// The node is only put on the free list, its values stay in place.
+    if ((i = urb_pool_find(&shm->pool, key)) != 0) {
+        if (data && shm->data) 
+            memcpy(data, urb_shm_data(shm, i), shm->value_size);
+        urb_pool_pop(&shm->pool, key, value);
+    }
+    urb_shm_unlock(shm);
+    return i != 0;
+}
+
+CPPGUARD_END();
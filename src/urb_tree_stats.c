@@ -0,0 +1,136 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file urb_tree_stats.c
+/// @author Issam SAID
+/// @brief Implement the structural counters of Red-Black trees.
+///
+/// @details Every thread owns a block of counters, allocated the first 
+/// time it updates a tree and chained into a global list so that the 
+/// blocks can be summed. When a thread exits its counters are merged into
+/// the retired block and its own block is released.
+///
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <urb_tree/stats.h>
+#include <urb_tree/error.h>
+
+CPPGUARD_BEGIN();
+
+#ifdef __URB_TREE_STATS
+
+typedef struct __urb_stats_block_t {
+    urb_stats_t counters;
+    struct __urb_stats_block_t *next;
+} urb_stats_block_t;
+
+__thread urb_stats_t *urb_stats_local = NULL;
+
+static urb_stats_block_t *urb_stats_blocks  = NULL;
+static urb_stats_t        urb_stats_retired;
+static pthread_mutex_t    urb_stats_lock    = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t     urb_stats_once    = PTHREAD_ONCE_INIT;
+static pthread_key_t      urb_stats_key;
+
+#define URB_STATS_FIELDS (sizeof(urb_stats_t)/sizeof(unsigned long long))
+
+static void urb_stats_merge(urb_stats_t *dst, urb_stats_t *src) {
+    unsigned long long *d = (unsigned long long *)dst;
+    unsigned long long *s = (unsigned long long *)src;
+    size_t i;
+    for (i = 0; i < URB_STATS_FIELDS; ++i) {
+        if (&d[i] == &dst->max_depth) { if (s[i] > d[i]) d[i] = s[i]; }
+        else d[i] += s[i];
+    }
+}
+
+static void urb_stats_detach(void *ptr) {
+    urb_stats_block_t *b = (urb_stats_block_t *)ptr, **i;
+    pthread_mutex_lock(&urb_stats_lock);
+    for (i = &urb_stats_blocks; *i != NULL; i = &(*i)->next) {
+        if (*i == b) { *i = b->next; break; }
+    }
+    urb_stats_merge(&urb_stats_retired, &b->counters);
+    pthread_mutex_unlock(&urb_stats_lock);
+    free(b);
+    /// The destructor runs in the exiting thread, a later operation (from 
+    /// another TLS destructor) attaches a fresh block.
+    urb_stats_local = NULL;
+}
+
+static void urb_stats_init(void) {
+    pthread_key_create(&urb_stats_key, urb_stats_detach);
+}
+
+urb_stats_t *urb_tree_stats_attach(void) {
+    urb_stats_block_t *b = (urb_stats_block_t *)calloc(1, sizeof(*b));
+    if (b == NULL) 
+        URB_EXIT(URB_OUT_OF_MEMORY, "failed to allocate urb_tree counters");
+    pthread_once(&urb_stats_once, urb_stats_init);
+    pthread_setspecific(urb_stats_key, b);
+    pthread_mutex_lock(&urb_stats_lock);
+    b->next          = urb_stats_blocks;
+    urb_stats_blocks = b;
+    pthread_mutex_unlock(&urb_stats_lock);
+    return urb_stats_local = &b->counters;
+}
+
+bool urb_tree_stats_enabled(void) { return true; }
+
+void urb_tree_stats(urb_stats_t *stats) {
+    urb_stats_block_t *b;
+    pthread_mutex_lock(&urb_stats_lock);
+    memcpy(stats, &urb_stats_retired, sizeof(urb_stats_t));
+    for (b = urb_stats_blocks; b != NULL; b = b->next) 
+        urb_stats_merge(stats, &b->counters);
+    pthread_mutex_unlock(&urb_stats_lock);
+}
+
+void urb_tree_stats_reset(void) {
+    urb_stats_block_t *b;
+    pthread_mutex_lock(&urb_stats_lock);
+    memset(&urb_stats_retired, 0, sizeof(urb_stats_t));
+    for (b = urb_stats_blocks; b != NULL; b = b->next) 
+        memset(&b->counters, 0, sizeof(urb_stats_t));
+    pthread_mutex_unlock(&urb_stats_lock);
+}
+
+#else
+
+bool urb_tree_stats_enabled(void) { return false; }
+
+void urb_tree_stats(urb_stats_t *stats) { 
+    memset(stats, 0, sizeof(urb_stats_t)); 
+}
+
+void urb_tree_stats_reset(void) { }
+
+#endif  // __URB_TREE_STATS
+
+CPPGUARD_END();
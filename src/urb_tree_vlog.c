@@ -0,0 +1,243 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+///
+/// @file urb_tree_vlog.c
+/// @author Issam SAID
+/// @brief Implement the value logs (tiered values).
+///
+/// @details The values are appended at 8-byte aligned offsets. The file is
+/// grown by doubling (ftruncate) inside the reserved mapping, which never
+/// moves. The chunks of the LRU list are linked by their numbers, 
+/// URB_VLOG_NONE ends the list. The mapping is shared with the file, so 
+/// dropping a chunk (MADV_DONTNEED) keeps its content in the file.
+///
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <urb_tree/vlog.h>
+#include <urb_tree/core.h>
+#include <urb_tree/util.h>
+#include <urb_tree/sentinel.h>
+#include <urb_tree/error.h>
+
+CPPGUARD_BEGIN();
+
+#define URB_VLOG_NONE    UINT32_MAX
+#define URB_VLOG_MIN     (1UL << 20)
+#define URB_VLOG_ALIGN(x) (((x) + 7) & ~(size_t)7)
+
+int urb_vlog_open(urb_vlog_t *vlog, const char *path, 
+                  size_t reserve, size_t budget) {
+    reserve = (reserve + URB_VLOG_CHUNK - 1) & ~(URB_VLOG_CHUNK - 1);
+    if (reserve == 0 || 
+        reserve > (1ULL << (64 - URB_VLOG_LENGTH_BITS))) 
+        return URB_INVALID_VALUE;
+    if ((vlog->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600)) < 0)
+        return URB_IO_ERROR;
+    vlog->map = (uint8_t *)mmap(NULL, reserve, PROT_READ | PROT_WRITE, 
+                                MAP_SHARED, vlog->fd, 0);
+    if (vlog->map == MAP_FAILED) {
+        close(vlog->fd);
+        return URB_OUT_OF_MEMORY;
+    }
+    vlog->chunks = (urb_vlog_chunk_t *)calloc(reserve / URB_VLOG_CHUNK, 
+                                              sizeof(urb_vlog_chunk_t));
+    if (vlog->chunks == NULL)
+        URB_EXIT(URB_OUT_OF_MEMORY, "failed to allocate the value log");
+    vlog->reserve   = reserve;
+    vlog->capacity  = 0;
+    vlog->size      = 0;
+    vlog->garbage   = 0;
+    vlog->head      = URB_VLOG_NONE;
+    vlog->tail      = URB_VLOG_NONE;
+    vlog->resident  = 0;
+    vlog->budget    = budget / URB_VLOG_CHUNK ? budget / URB_VLOG_CHUNK : 1;
+    vlog->evictions = 0;
+    return URB_SUCCESS;
+}
+
+int urb_vlog_close(urb_vlog_t *vlog) {
+    munmap(vlog->map, vlog->reserve);
+    close(vlog->fd);
+    free(vlog->chunks);
+    vlog->map    = NULL;
+    vlog->chunks = NULL;
+    return URB_SUCCESS;
+}
+
+static inline void urb_vlog_unlink(urb_vlog_t *vlog, uint32_t c) {
+    urb_vlog_chunk_t *k = &vlog->chunks[c];
+    if (k->prev != URB_VLOG_NONE) vlog->chunks[k->prev].next = k->next;
+    else                          vlog->head = k->next;
+    if (k->next != URB_VLOG_NONE) vlog->chunks[k->next].prev = k->prev;
+    else                          vlog->tail = k->prev;
+}
+
+///
+/// @brief Drop the least recently used chunk from memory.
+///
+static void urb_vlog_evict(urb_vlog_t *vlog) {
+    uint32_t c = vlog->tail;
+    urb_vlog_unlink(vlog, c);
+    vlog->chunks[c].resident = 0;
+    vlog->resident--;
+    vlog->evictions++;
+    madvise(vlog->map + (size_t)c*URB_VLOG_CHUNK, URB_VLOG_CHUNK, 
+            MADV_DONTNEED);
+}
+
+///
+/// @brief Move the chunks of [offset, offset + length) to the front of the 
+///        LRU list, the least recently used ones are dropped beyond the 
+///        budget. The chunks of the range are never dropped, even when the
+///        range spans more chunks than the budget.
+///
+static void urb_vlog_touch(urb_vlog_t *vlog, size_t offset, size_t length) {
+    uint32_t first = (uint32_t)(offset / URB_VLOG_CHUNK), c = first;
+    uint32_t last  = (uint32_t)((offset + (length ? length - 1 : 0)) / 
+                                URB_VLOG_CHUNK);
+    for (; c <= last; ++c) {
+        urb_vlog_chunk_t *k = &vlog->chunks[c];
+        if (k->resident) {
+            if (vlog->head == c) continue;
+            urb_vlog_unlink(vlog, c);
+        } else {
+            k->resident = 1;
+            vlog->resident++;
+        }
+        k->prev = URB_VLOG_NONE;
+        k->next = vlog->head;
+        if (vlog->head != URB_VLOG_NONE) vlog->chunks[vlog->head].prev = c;
+        else                             vlog->tail = c;
+        vlog->head = c;
+    }
+    /// The range is at the front of the list, the tail is in the range 
+    /// once all the other chunks are dropped.
+    while (vlog->resident > vlog->budget && 
+           (vlog->tail < first || vlog->tail > last)) urb_vlog_evict(vlog);
+}
+
+uint64_t urb_vlog_append(urb_vlog_t *vlog, const void *data, size_t length) {
+    size_t offset = URB_VLOG_ALIGN(vlog->size);
+    if (length >= (1UL << URB_VLOG_LENGTH_BITS))
+        URB_EXIT(URB_INVALID_VALUE, "the value is too large for a handle");
+    if (offset + length > vlog->reserve)
+        URB_EXIT(URB_OUT_OF_MEMORY, "the value log is full");
+    if (offset + length > vlog->capacity) {
+        size_t capacity = vlog->capacity ? vlog->capacity : URB_VLOG_MIN;
+        while (capacity < offset + length) capacity *= 2;
+        if (capacity > vlog->reserve) capacity = vlog->reserve;
+        if (ftruncate(vlog->fd, (off_t)capacity))
+            URB_EXIT(URB_IO_ERROR, "failed to grow the value log");
+        vlog->capacity = capacity;
+    }
+    /// Copy first, the chunks dropped by the touch are not faulted back.
+    memcpy(vlog->map + offset, data, length);
+    urb_vlog_touch(vlog, offset, length);
+    vlog->size = offset + length;
+    return URB_VLOG_HANDLE(offset, length);
+}
+
+void *urb_vlog_read(urb_vlog_t *vlog, uint64_t handle) {
+    urb_vlog_touch(vlog, URB_VLOG_OFFSET(handle), URB_VLOG_LENGTH(handle));
+    return vlog->map + URB_VLOG_OFFSET(handle);
+}
+
+int urb_vlog_put(urb_vlog_t *vlog, urb_t **urb, void *key, 
+                 const void *data, size_t length,
+                 int (*compare_key)(void*, void*)) {
+    uint64_t handle = urb_vlog_append(vlog, data, length);
+    return urb_tree_put(urb, urb_tree_create(key, (void*)(uintptr_t)handle),
+                        compare_key);
+}
+
+void *urb_vlog_value(urb_vlog_t *vlog, urb_t *n, size_t *length) {
+    uint64_t handle = (uint64_t)(uintptr_t)n->value;
+    if (length) *length = URB_VLOG_LENGTH(handle);
+    return urb_vlog_read(vlog, handle);
+}
+
+urb_t *urb_vlog_pop(urb_vlog_t *vlog, urb_t **urb, void *key,
+                    int (*compare_key)(void*, void*)) {
+    urb_t *n = urb_tree_pop(urb, key, compare_key);
+    if (n != &urb_sentinel) 
+        vlog->garbage += URB_VLOG_LENGTH((uint64_t)(uintptr_t)n->value);
+    return n;
+}
+
+static int urb_vlog_compare_offsets(const void *a, const void *b) {
+    uint64_t x = (uint64_t)(uintptr_t)(*(urb_t *const *)a)->value;
+    uint64_t y = (uint64_t)(uintptr_t)(*(urb_t *const *)b)->value;
+    return (x > y) - (x < y);
+}
+
+int urb_vlog_compact(urb_vlog_t *vlog, urb_t **urb) {
+    size_t i, n = urb_tree_size(urb), size = 0, capacity;
+    urb_t **nodes, *x;
+    if ((nodes = (urb_t **)malloc((n ? n : 1)*sizeof(urb_t*))) == NULL)
+        URB_EXIT(URB_OUT_OF_MEMORY, "failed to allocate the compaction");
+    for (i = 0, x = urb_tree_min(urb); 
+         x != NULL && x != &urb_sentinel; x = urb_tree_succ(x)) 
+        nodes[i++] = x;
+    /// Each value moves down (or stays) when they are taken by offset.
+    qsort(nodes, n, sizeof(urb_t*), urb_vlog_compare_offsets);
+    for (i = 0; i < n; ++i) {
+        uint64_t handle = (uint64_t)(uintptr_t)nodes[i]->value;
+        size_t   offset = URB_VLOG_ALIGN(size);
+        size_t   length = URB_VLOG_LENGTH(handle);
+        if (offset != URB_VLOG_OFFSET(handle))
+            memmove(vlog->map + offset, 
+                    vlog->map + URB_VLOG_OFFSET(handle), length);
+        nodes[i]->value = (void*)(uintptr_t)URB_VLOG_HANDLE(offset, length);
+        size = offset + length;
+    }
+    free(nodes);
+    /// Drop the whole log from memory and shrink the file.
+    madvise(vlog->map, vlog->capacity, MADV_DONTNEED);
+    memset(vlog->chunks, 0, 
+           vlog->reserve / URB_VLOG_CHUNK * sizeof(urb_vlog_chunk_t));
+    vlog->head     = URB_VLOG_NONE;
+    vlog->tail     = URB_VLOG_NONE;
+    vlog->resident = 0;
+    capacity = URB_VLOG_MIN;
+    while (capacity < size) capacity *= 2;
+    if (capacity > vlog->reserve) capacity = vlog->reserve;
+    if (capacity < vlog->capacity) {
+        if (ftruncate(vlog->fd, (off_t)capacity))
+            return URB_IO_ERROR;
+        vlog->capacity = capacity;
+    }
+    vlog->size    = size;
+    vlog->garbage = 0;
+    return URB_SUCCESS;
+}
+
+CPPGUARD_END();
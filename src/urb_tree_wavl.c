@@ -0,0 +1,251 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+///
+/// @file urb_tree_wavl.c
+/// @author Issam SAID
+/// @brief Implement the WAVL (weak AVL) balancing routines.
+///
+/// @details The routines follow Haeupler, Sen and Tarjan (Rank-Balanced 
+/// Trees). A node with children of rank differences i and j is an i,j 
+/// node, and as for the Red-Black trees the cases are written for one side
+/// (the side d of the node being fixed) and mirrored with child[d] and 
+/// child[!d].
+///
+/// Insertion, the new node x is a leaf of rank 0, while x is a 0-child:
+///   1. the sibling of x is a 1-child: promote the parent and go up.
+///   2. the inner child of x is a 2-child: rotate x up, demote the parent.
+///   3. otherwise: double rotate the inner child z of x up, promote z and
+///      demote x and the parent.
+///
+/// Deletion, the removed node is replaced by its child x (possibly the 
+/// sentinel), if the parent becomes a 2,2 leaf it is demoted, then while 
+/// x is a 3-child:
+///   1. the sibling y of x is a 2-child: demote the parent and go up.
+///   2. y is a 2,2 node: demote the parent and y and go up.
+///   3. the outer child of y is a 1-child: rotate y up, promote y and 
+///      demote the parent (twice if it becomes a leaf).
+///   4. otherwise: double rotate the inner child v of y up, promote v 
+///      twice, demote y once and the parent twice.
+///
+/// The shared sentinel is never written: its rank is read as -1 and the 
+/// parent of the node being fixed is tracked instead of being stored in 
+/// the sentinel.
+///
+#include <urb_tree/wavl.h>
+#include <urb_tree/sentinel.h>
+#include <urb_tree/error.h>
+#include <urb_tree/stats.h>
+
+CPPGUARD_BEGIN();
+
+///
+/// @brief The rank of a node, -1 for the sentinel.
+///
+#define URB_WAVL_RANK(n) ((n) == &urb_sentinel ? -1 : (n)->rank)
+
+///
+/// @brief The rank difference of the child d of a node.
+///
+#define URB_WAVL_DIFF(n, d) ((n)->rank - URB_WAVL_RANK((n)->child[d]))
+
+///
+/// @brief Rotate around n towards the direction d: the child of n opposite
+///        to d takes its place (d = 0 is a left rotation, 1 a right one).
+///
+static inline void urb_wavl_rotate(urb_t **urb, urb_t *n, int d) {  
+    urb_t *y = n->child[!d];
+    URB_STATS_ADD(left_rotations,  !d);
+    URB_STATS_ADD(right_rotations,  d);
+    n->child[!d] = y->child[d];
+    if (y->child[d] != &urb_sentinel) y->child[d]->parent = n;
+    y->parent = n->parent;
+    if (n->parent) {           
+        n->parent->child[n == n->parent->child[1]] = y;
+    } else { *urb = y; }    
+    y->child[d] = n;                 
+    n->parent   = y;
+}
+
+///
+/// @brief Put v (possibly the sentinel, which is left untouched) in the 
+///        place of u.
+///
+static inline void urb_wavl_transplant(urb_t **urb, urb_t *u, urb_t *v) {
+    if (u->parent) u->parent->child[u == u->parent->child[1]] = v;
+    else           *urb = v;
+    if (v != &urb_sentinel) v->parent = u->parent;
+}
+
+static void urb_wavl_fix_put(urb_t **urb, urb_t *x) {
+    urb_t *p = x->parent, *z;
+    int d;
+    while (p && p->rank == x->rank) {
+        d = x == p->child[1];
+        if (URB_WAVL_DIFF(p, !d) == 1) {
+            /// CASE 1: promote the parent.
+            p->rank++;
+            x = p;
+            p = x->parent;
+            continue;
+        }
+        z = x->child[!d];
+        if (x->rank - URB_WAVL_RANK(z) == 2) {
+            /// CASE 2: single rotation.
+            urb_wavl_rotate(urb, p, !d);
+            p->rank--;
+        } else {
+            /// CASE 3: double rotation.
+            urb_wavl_rotate(urb, x, d);
+            urb_wavl_rotate(urb, p, !d);
+            z->rank++;
+            x->rank--;
+            p->rank--;
+        }
+        break;
+    }
+}
+
+///
+/// @brief Fix the tree after the child d of p has been removed or replaced.
+///
+static void urb_wavl_fix_pop(urb_t **urb, urb_t *p, int d) {
+    urb_t *x, *y, *v;
+    if (p->left == &urb_sentinel && p->right == &urb_sentinel && p->rank) {
+        /// The parent is a 2,2 leaf: demote it.
+        p->rank = 0;
+        x = p;
+        if ((p = x->parent) == NULL) return;
+        d = x == p->child[1];
+    }
+    while (URB_WAVL_DIFF(p, d) == 3) {
+        y = p->child[!d];
+        if (URB_WAVL_DIFF(p, !d) == 2) {
+            /// CASE 1: demote the parent.
+            p->rank--;
+        } else if (URB_WAVL_DIFF(y, 0) == 2 && URB_WAVL_DIFF(y, 1) == 2) {
+            /// CASE 2: demote the parent and the sibling.
+            p->rank--;
+            y->rank--;
+        } else if (URB_WAVL_DIFF(y, !d) == 1) {
+            /// CASE 3: single rotation.
+            urb_wavl_rotate(urb, p, d);
+            y->rank++;
+            p->rank--;
+            if (p->left == &urb_sentinel && p->right == &urb_sentinel) 
+                p->rank--;
+            return;
+        } else {
+            /// CASE 4: double rotation.
+            v = y->child[d];
+            urb_wavl_rotate(urb, y, !d);
+            urb_wavl_rotate(urb, p, d);
+            v->rank += 2;
+            y->rank--;
+            p->rank -= 2;
+            return;
+        }
+        x = p;
+        if ((p = x->parent) == NULL) return;
+        d = x == p->child[1];
+    }
+}
+
+int urb_wavl_put(urb_t **urb, urb_t *n, int (*compare_key)(void*, void*)) {
+    int ret = 0;
+    urb_t *p = NULL;        
+    urb_t *i = *urb;
+    if (n == NULL) 
+        URB_EXIT(URB_INVALID_NODE, "the node to insert can not be NULL");
+    size_t depth = 0;
+    while (i != &urb_sentinel) {                            
+        depth++;
+        if((ret = compare_key(n->key, i->key))==0) 
+            URB_EXIT(URB_DUPLICATE_KEY, "key already exists");
+        p = i;
+        i = i->child[ret > 0];
+    }                                                      
+    n->parent = p;                                    
+    n->left   = &urb_sentinel;
+    n->right  = &urb_sentinel;
+    n->rank   = 0;
+    if (p) p->child[ret > 0] = n;
+    else   *urb = n;
+    URB_STATS_OP(put, depth, depth);
+    urb_wavl_fix_put(urb, n);                    
+    return URB_SUCCESS;                                    
+}                                               
+
+urb_t *urb_wavl_erase_node(urb_t **urb, urb_t *n) {
+    urb_t *y, *p;
+    int d;
+    if (n->left == &urb_sentinel || n->right == &urb_sentinel) {
+        p = n->parent;
+        d = p && n == p->child[1];
+        urb_wavl_transplant(urb, n, n->child[n->left == &urb_sentinel]);
+    } else {
+        /// The successor takes the place (and the rank) of n.
+        y = n->right;
+        while (y->left != &urb_sentinel) y = y->left;
+        if (y->parent == n) {
+            p = y;
+            d = 1;
+        } else {
+            p = y->parent;
+            d = 0;
+            urb_wavl_transplant(urb, y, y->right);
+            y->right         = n->right;
+            y->right->parent = y;
+        }
+        urb_wavl_transplant(urb, n, y);
+        y->left         = n->left;
+        y->left->parent = y;
+        y->rank         = n->rank;
+    }
+    if (p) urb_wavl_fix_pop(urb, p, d);
+    n->left   = &urb_sentinel;
+    n->parent = &urb_sentinel;
+    n->right  = &urb_sentinel;
+    return n;
+}
+
+urb_t *urb_wavl_pop(urb_t **urb, void *key, int (*compare_key)(void*, void*)) {
+    int ret;
+    urb_t *i     = *urb;
+    size_t depth = 0;
+    while (i != &urb_sentinel) {
+        depth++;
+        if ((ret = compare_key(key, i->key)) == 0) break;
+        i = i->child[ret > 0];
+    }
+    URB_STATS_OP(pop, depth, depth);
+    if (i == &urb_sentinel) return &urb_sentinel;                             
+    return urb_wavl_erase_node(urb, i);
+}
+
+CPPGUARD_END();
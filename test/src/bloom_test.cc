@@ -0,0 +1,116 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file test/src/bloom_test.cc
+/// @author Issam SAID
+/// @brief Unit testing file for the urb_tree Bloom filters.
+/// 
+#include <gtest/gtest.h>
+#include <urb_tree/urb_tree.h>
+
+namespace {
+
+    int      urb_cmp(void *a, void *b) { return *(int*)a-*(int*)b; }
+
+    uint64_t urb_hash(void *a) { return (uint64_t)*(int*)a; }
+
+    class BloomTest : public ::testing::Test {
+    protected:
+        virtual void SetUp() { for (int i = 0; i < 2*T; ++i) keys[i] = i; }
+        virtual void TearDown() { }
+        /// The even keys in [0, 2*T).
+        void build(bool counting) {
+            urb = &urb_sentinel;
+            ASSERT_EQ(URB_SUCCESS, 
+                      urb_bloom_init(&bloom, T, 0.01, urb_hash, counting));
+            for (int i = 0; i < T; ++i) 
+                ASSERT_EQ(URB_SUCCESS, 
+                          urb_bloom_put(&bloom, &urb, 
+                                        urb_tree_create(&keys[2*i], NULL), 
+                                        urb_cmp));
+        }
+        void clear() { 
+            urb_tree_delete(&urb, NULL, NULL); 
+            urb_bloom_delete(&bloom);
+        }
+        static const int T = 10000;
+        int keys[2*T];
+        urb_t *urb;
+        urb_bloom_t bloom;
+    };
+
+    TEST_F(BloomTest, find) {
+        urb_bloom_stats_t s;
+        for (int counting = 0; counting < 2; ++counting) {
+            build(counting);
+            for (int i = 0; i < 2*T; ++i) {
+                urb_t *n = urb_bloom_find(&bloom, &urb, &keys[i], urb_cmp);
+                ASSERT_EQ(urb_tree_find(&urb, &keys[i], urb_cmp), n);
+            }
+            urb_bloom_stats(&bloom, &s);
+            ASSERT_EQ(2ULL*T, s.queries);
+            ASSERT_EQ((unsigned long long)T, s.negatives + s.false_positives);
+            ASSERT_LT(s.fp_rate, 0.03);
+            ASSERT_GT(s.memory, (size_t)T);
+            ASSERT_GT(s.bits_per_key, 8.0);
+            clear();
+        }
+    }
+
+    TEST_F(BloomTest, pop) {
+        urb_bloom_stats_t s;
+        for (int counting = 0; counting < 2; ++counting) {
+            build(counting);
+            for (int i = 0; i < T; i += 2) {
+                urb_t *n = urb_bloom_pop(&bloom, &urb, &keys[2*i], urb_cmp);
+                ASSERT_EQ(keys[2*i], *(int*)n->key);
+                urb_tree_release(n);
+            }
+            URB_TREE_CHECK_INVARIANTS(&urb);
+            /// No false negative after the pops (and the rebuilds).
+            for (int i = 0; i < 2*T; ++i) {
+                urb_t *n = urb_bloom_find(&bloom, &urb, &keys[i], urb_cmp);
+                ASSERT_EQ(urb_tree_find(&urb, &keys[i], urb_cmp), n);
+            }
+            urb_bloom_stats(&bloom, &s);
+            if (counting) {
+                /// The popped keys are filtered out right away.
+                ASSERT_LT(s.fp_rate, 0.03);
+                ASSERT_EQ(0ULL, s.rebuilds);
+            } else {
+                /// The keys popped before the rebuild are filtered out.
+                ASSERT_EQ(2ULL, s.rebuilds);
+                ASSERT_LT(s.fp_rate, 0.25);
+            }
+            ASSERT_EQ(&urb_sentinel, 
+                      urb_bloom_pop(&bloom, &urb, &keys[0], urb_cmp));
+            clear();
+        }
+    }
+
+}  // namespace
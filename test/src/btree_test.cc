@@ -0,0 +1,139 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file test/src/btree_test.cc
+/// @author Issam SAID
+/// @brief Unit testing file for the urb_tree B+tree engine.
+/// 
+#include <stdint.h>
+#include <map>
+#include <gtest/gtest.h>
+#include <urb_tree/urb_tree.h>
+
+namespace {
+
+    class BtreeTest : public ::testing::Test {
+    protected:
+        virtual void SetUp() { btree = urb_btree_create(); }
+        virtual void TearDown() { urb_btree_delete(btree, NULL); }
+        void check() {
+            std::map<int64_t, intptr_t>::iterator it = ref.begin();
+            urb_bpos_t pos;
+            ASSERT_TRUE(urb_btree_check(btree));
+            ASSERT_EQ(ref.size(), urb_btree_size(btree));
+            for (pos = urb_btree_min(btree); pos.leaf; 
+                 pos = urb_btree_succ(pos), ++it) {
+                ASSERT_EQ(it->first,  urb_btree_key(pos));
+                ASSERT_EQ(it->second, (intptr_t)urb_btree_value(pos));
+            }
+            ASSERT_TRUE(it == ref.end());
+        }
+        static const int64_t T = 20000;
+        urb_btree_t *btree;
+        std::map<int64_t, intptr_t> ref;
+    };
+
+    TEST_F(BtreeTest, put_find) {
+        int64_t i, key;
+        for (i = 0; i < T; ++i) {
+            key = 2*((i*7919)%T);
+            ASSERT_EQ(URB_SUCCESS, urb_btree_put(btree, key, (void*)(key+1)));
+            ref[key] = key+1;
+        }
+        check();
+        ASSERT_GT(btree->height, 2u);
+        for (key = -1; key <= 2*T; ++key) {
+            urb_bpos_t pos = urb_btree_find(btree, key);
+            if (key >= 0 && key % 2 == 0 && key < 2*T) {
+                ASSERT_TRUE(pos.leaf != NULL);
+                ASSERT_EQ(key, urb_btree_key(pos));
+                ASSERT_EQ(key+1, (intptr_t)urb_btree_value(pos));
+            } else {
+                ASSERT_TRUE(pos.leaf == NULL);
+            }
+        }
+        /// The extreme keys collide with the padding of the nodes.
+        ASSERT_EQ(URB_SUCCESS, urb_btree_put(btree, INT64_MAX, NULL));
+        ASSERT_EQ(URB_SUCCESS, urb_btree_put(btree, INT64_MIN, NULL));
+        ref[INT64_MAX] = ref[INT64_MIN] = 0;
+        check();
+        ASSERT_EQ(INT64_MAX, urb_btree_key(urb_btree_find(btree, INT64_MAX)));
+        ASSERT_EQ(INT64_MAX, urb_btree_key(urb_btree_max(btree)));
+        ASSERT_EQ(INT64_MIN, urb_btree_key(urb_btree_min(btree)));
+    }
+
+    TEST_F(BtreeTest, prev) {
+        int64_t i;
+        urb_bpos_t pos;
+        for (i = 0; i < T; ++i) urb_btree_put(btree, T-i, NULL);
+        for (i = T, pos = urb_btree_max(btree); pos.leaf; 
+             pos = urb_btree_prev(pos), --i) 
+            ASSERT_EQ(i, urb_btree_key(pos));
+        ASSERT_EQ(0, i);
+    }
+
+    TEST_F(BtreeTest, pop) {
+        int64_t i, key;
+        void *value;
+        for (i = 0; i < T; ++i) {
+            urb_btree_put(btree, i, (void*)(i+1));
+            ref[i] = i+1;
+        }
+        ASSERT_FALSE(urb_btree_pop(btree, T, &value));
+        for (i = 0; i < T; ++i) {
+            key = (i*7919)%T;
+            ASSERT_TRUE(urb_btree_pop(btree, key, &value));
+            ASSERT_EQ(key+1, (intptr_t)value);
+            ASSERT_FALSE(urb_btree_pop(btree, key, &value));
+            ref.erase(key);
+            if (i % 997 == 0) check();
+        }
+        check();
+        ASSERT_EQ(1u, btree->height);
+        ASSERT_TRUE(urb_btree_min(btree).leaf == NULL);
+        ASSERT_TRUE(urb_btree_max(btree).leaf == NULL);
+    }
+
+    TEST_F(BtreeTest, mixed) {
+        uint64_t x = 42;
+        int64_t  key;
+        for (int i = 0; i < 10*T; ++i) {
+            x   ^= x << 13; x ^= x >> 7; x ^= x << 17;
+            key  = (int64_t)(x % (T/4));
+            if (ref.count(key)) {
+                ASSERT_TRUE(urb_btree_pop(btree, key, NULL));
+                ref.erase(key);
+            } else {
+                urb_btree_put(btree, key, (void*)(intptr_t)i);
+                ref[key] = i;
+            }
+        }
+        check();
+    }
+
+}  // namespace
@@ -0,0 +1,121 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file test/src/cache_test.cc
+/// @author Issam SAID
+/// @brief Unit testing file for the urb_tree node caches.
+/// 
+#include <pthread.h>
+#include <vector>
+#include <gtest/gtest.h>
+#include <urb_tree/urb_tree.h>
+
+namespace {
+
+    int  urb_cmp(void *a, void *b) { return *(int*)a-*(int*)b; }
+
+    class CacheTest : public ::testing::Test {
+    protected:
+        virtual void SetUp() { 
+            urb_tree_cache_trim(); 
+            urb_tree_cache_stats(&s0);
+        }
+        virtual void TearDown() { urb_tree_cache_trim(); }
+        static const int T = 1000;
+        urb_cache_stats_t s0, s;
+    };
+
+    TEST_F(CacheTest, reuse) {
+        int keys[T];
+        urb_t *urb = &urb_sentinel, *n;
+        for (int i = 0; i < T; ++i) {
+            keys[i] = i;
+            urb_tree_put(&urb, urb_tree_create(&keys[i], NULL), urb_cmp);
+        }
+        for (int i = 0; i < T; ++i) {
+            n = urb_tree_pop(&urb, &keys[i], urb_cmp);
+            ASSERT_EQ(&keys[i], n->key);
+            urb_tree_release(n);
+            n = urb_tree_create(&keys[i], NULL);
+            ASSERT_EQ(URB_SUCCESS, urb_tree_put(&urb, n, urb_cmp));
+            URB_TREE_CHECK_INVARIANTS(&urb);
+        }
+        urb_tree_cache_stats(&s);
+        ASSERT_EQ((unsigned long long)T, s.misses - s0.misses);
+        ASSERT_EQ((unsigned long long)T, s.hits   - s0.hits);
+        ASSERT_EQ(0u, s.local);
+        ASSERT_EQ(urb_tree_size(&urb), (size_t)T);
+        /// The deleted nodes are cached, the extra ones go to the pool.
+        urb_tree_delete(&urb, NULL, NULL);
+        urb_tree_cache_stats(&s);
+        ASSERT_LE(s.local, (size_t)URB_TREE_CACHE_SIZE);
+        ASSERT_EQ((size_t)T, s.local + s.global);
+        ASSERT_GT(s.spills, s0.spills);
+        /// Create drains the thread cache, then refills it from the pool.
+        std::vector<urb_t *> nodes;
+        for (int i = 0; i < T; ++i) {
+            urb = &urb_sentinel;
+            urb_tree_put(&urb, urb_tree_create(&keys[i], NULL), urb_cmp);
+            nodes.push_back(urb);
+        }
+        urb_tree_cache_stats(&s);
+        ASSERT_EQ((unsigned long long)2*T, s.hits - s0.hits);
+        ASSERT_GT(s.refills, s0.refills);
+        ASSERT_EQ(0u, s.global);
+        for (int i = 0; i < T; ++i) urb_tree_release(nodes[i]);
+    }
+
+    pthread_barrier_t barrier;
+
+    void *release_nodes(void *arg) {
+        std::vector<urb_t*> nodes;
+        for (int i = 0; i < *(int*)arg; ++i) 
+            nodes.push_back(urb_tree_create(NULL, NULL));
+        /// No thread takes nodes from the pool before all have allocated.
+        pthread_barrier_wait(&barrier);
+        for (size_t i = 0; i < nodes.size(); ++i) urb_tree_release(nodes[i]);
+        return NULL;
+    }
+
+    TEST_F(CacheTest, threads) {
+        pthread_t threads[4];
+        int count = 100;
+        pthread_barrier_init(&barrier, NULL, 4);
+        for (int t = 0; t < 4; ++t) 
+            pthread_create(&threads[t], NULL, release_nodes, &count);
+        for (int t = 0; t < 4; ++t) pthread_join(threads[t], NULL);
+        pthread_barrier_destroy(&barrier);
+        /// The thread caches were moved to the pool when the threads exited.
+        urb_tree_cache_stats(&s);
+        ASSERT_EQ((size_t)4*count, s.global);
+        urb_tree_cache_trim();
+        urb_tree_cache_stats(&s);
+        ASSERT_EQ(0u, s.global);
+    }
+
+}  // namespace
@@ -0,0 +1,232 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file test/src/checkpoint_test.cc
+/// @author Issam SAID
+/// @brief Unit testing file for the urb_tree delta checkpoints.
+/// 
+#include <map>
+#include <string>
+#include <vector>
+#include <csignal>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <gtest/gtest.h>
+#include <urb_tree/urb_tree.h>
+
+namespace {
+
+    int    urb_cmp(void *a, void *b) { return *(int*)a-*(int*)b; }
+
+    bool urb_clean(urb_t *n) {
+        if (n == &urb_sentinel) return true;
+        return !(n->flags & URB_NODE_DIRTY_MASK) && 
+               urb_clean(n->left) && urb_clean(n->right);
+    }
+
+    class CheckpointTest : public ::testing::Test {
+    protected:
+        virtual void SetUp() {
+            root = &urb_sentinel;
+            for (int i = 0; i < T; ++i) { keys[i] = i; values[i] = 0; }
+            ASSERT_EQ(URB_SUCCESS, 
+                      urb_checkpoint_init(&checkpoint, &root, sizeof(int), 
+                                          sizeof(int), 0, urb_cmp));
+        }
+        virtual void TearDown() { 
+            urb_checkpoint_delete(&checkpoint);
+            urb_tree_delete(&root, NULL, NULL);
+            for (size_t i = 0; i < files.size(); ++i) 
+                remove(files[i].c_str());
+        }
+        std::string file() {
+            char path[] = "/tmp/urb_checkpoint_XXXXXX";
+            int fd = mkstemp(path);
+            close(fd);
+            files.push_back(path);
+            files.push_back(std::string(path) + ".merge");
+            return path;
+        }
+        /// Recover the current chain and compare it with the tree.
+        void check(const char **paths, size_t n) {
+            urb_t *copy = &urb_sentinel;
+            ASSERT_EQ(URB_SUCCESS, 
+                      urb_checkpoint_recover(&copy, paths, n, urb_cmp));
+            ASSERT_EQ(urb_tree_size(&root), urb_tree_size(&copy));
+            for (urb_t *a = urb_tree_min(&root), *b = urb_tree_min(&copy);
+                 a != NULL && a != &urb_sentinel; 
+                 a = urb_tree_succ(a), b = urb_tree_succ(b)) {
+                ASSERT_EQ(*(int*)a->key,   *(int*)b->key);
+                ASSERT_EQ(*(int*)a->value, *(int*)b->value);
+            }
+            URB_TREE_CHECK_INVARIANTS(&copy);
+            urb_tree_delete(&copy, free, NULL);
+        }
+        void check() { 
+            check((const char **)checkpoint.chain, checkpoint.length); 
+        }
+        static const int T = 3000;
+        int keys[T];
+        int values[T];
+        urb_t *root;
+        urb_checkpoint_t checkpoint;
+        std::vector<std::string> files;
+    };
+
+    TEST_F(CheckpointTest, delta) {
+        for (int i = 0; i < T; i += 2) 
+            urb_checkpoint_put(&checkpoint, 
+                               urb_tree_create(&keys[i], &values[i]));
+        ASSERT_EQ(URB_SUCCESS, 
+                  urb_checkpoint_base(&checkpoint, file().c_str()));
+        ASSERT_EQ((size_t)T/2, checkpoint.written);
+        ASSERT_TRUE(urb_clean(root));
+        /// 10 new keys, 10 updated values and 10 removed keys.
+        for (int i = 1; i < 20; i += 2) 
+            urb_checkpoint_put(&checkpoint, 
+                               urb_tree_create(&keys[i], &values[i]));
+        for (int i = 100; i < 120; i += 2) {
+            values[i] = i;
+            urb_checkpoint_touch(&checkpoint, 
+                                 urb_tree_find(&root, &keys[i], urb_cmp));
+        }
+        for (int i = 200; i < 220; i += 2) 
+            urb_tree_release(urb_checkpoint_pop(&checkpoint, &keys[i]));
+        ASSERT_EQ(10u, checkpoint.removed);
+        ASSERT_EQ(URB_SUCCESS, 
+                  urb_checkpoint_delta(&checkpoint, file().c_str()));
+        ASSERT_EQ(20u, checkpoint.written);
+        ASSERT_EQ(0u, checkpoint.removed);
+        ASSERT_TRUE(urb_clean(root));
+        ASSERT_EQ(2u, checkpoint.length);
+        check();
+        /// An empty delta.
+        ASSERT_EQ(URB_SUCCESS, 
+                  urb_checkpoint_delta(&checkpoint, file().c_str()));
+        ASSERT_EQ(0u, checkpoint.written);
+        check();
+    }
+
+    TEST_F(CheckpointTest, failure) {
+        struct rlimit limit, small;
+        for (int i = 0; i < T; i += 2) 
+            urb_checkpoint_put(&checkpoint, 
+                               urb_tree_create(&keys[i], &values[i]));
+        ASSERT_EQ(URB_SUCCESS, 
+                  urb_checkpoint_base(&checkpoint, file().c_str()));
+        for (int i = 1; i < T; i += 2) 
+            urb_checkpoint_put(&checkpoint, 
+                               urb_tree_create(&keys[i], &values[i]));
+        for (int i = 0; i < 100; i += 2) 
+            urb_tree_release(urb_checkpoint_pop(&checkpoint, &keys[i]));
+        std::string path = file();
+        files.push_back(path + ".tmp");
+        ASSERT_NE(URB_SUCCESS, 
+                  urb_checkpoint_delta(&checkpoint, "/nonexistent/delta"));
+        /// The writes fail past 1 KiB (EFBIG instead of SIGXFSZ).
+        signal(SIGXFSZ, SIG_IGN);
+        getrlimit(RLIMIT_FSIZE, &limit);
+        small = limit;
+        small.rlim_cur = 1024;
+        setrlimit(RLIMIT_FSIZE, &small);
+        int ret = urb_checkpoint_delta(&checkpoint, path.c_str());
+        setrlimit(RLIMIT_FSIZE, &limit);
+        signal(SIGXFSZ, SIG_DFL);
+        ASSERT_NE(URB_SUCCESS, ret);
+        ASSERT_FALSE(urb_clean(root));
+        ASSERT_EQ(50u, checkpoint.removed);
+        ASSERT_NE(0, access((path + ".tmp").c_str(), F_OK));
+        ASSERT_EQ(1u, checkpoint.length);
+        /// The retry holds all the changes.
+        ASSERT_EQ(URB_SUCCESS, urb_checkpoint_delta(&checkpoint, path.c_str()));
+        ASSERT_EQ((size_t)T/2, checkpoint.written);
+        ASSERT_TRUE(urb_clean(root));
+        check();
+        /// A failed merge leaves no partial output.
+        std::string merged = file();
+        small.rlim_cur = 64;
+        signal(SIGXFSZ, SIG_IGN);
+        setrlimit(RLIMIT_FSIZE, &small);
+        ret = urb_checkpoint_merge((const char **)checkpoint.chain, 
+                                   checkpoint.length, merged.c_str(), 
+                                   urb_cmp);
+        setrlimit(RLIMIT_FSIZE, &limit);
+        signal(SIGXFSZ, SIG_DFL);
+        ASSERT_NE(URB_SUCCESS, ret);
+        ASSERT_NE(0, access(merged.c_str(), F_OK));
+    }
+
+    TEST_F(CheckpointTest, random) {
+        unsigned int seed = 7;
+        std::map<int, bool> in;
+        checkpoint.max_deltas = 3;
+        urb_checkpoint_base(&checkpoint, file().c_str());
+        for (int round = 0; round < 12; ++round) {
+            for (int op = 0; op < 500; ++op) {
+                int k = rand_r(&seed) % T;
+                if (!in[k]) {
+                    values[k] = round;
+                    urb_checkpoint_put(&checkpoint, 
+                                       urb_tree_create(&keys[k], &values[k]));
+                    in[k] = true;
+                } else if (rand_r(&seed) % 2) {
+                    urb_tree_release(urb_checkpoint_pop(&checkpoint, &k));
+                    in[k] = false;
+                } else {
+                    values[k] = -round;
+                    urb_checkpoint_touch(&checkpoint, 
+                                         urb_tree_find(&root, &k, urb_cmp));
+                }
+            }
+            ASSERT_EQ(URB_SUCCESS, 
+                      urb_checkpoint_delta(&checkpoint, file().c_str()));
+            ASSERT_TRUE(urb_clean(root));
+            /// The deltas are merged beyond 3.
+            ASSERT_LE(checkpoint.deltas, 3u);
+            ASSERT_EQ(checkpoint.deltas + 1, checkpoint.length);
+            check();
+        }
+        /// Merge the whole chain into a new base.
+        std::string base = file();
+        ASSERT_EQ(URB_SUCCESS, 
+                  urb_checkpoint_merge((const char **)checkpoint.chain, 
+                                       checkpoint.length, base.c_str(), 
+                                       urb_cmp));
+        const char *paths[] = { base.c_str() };
+        check(paths, 1);
+        /// Merging only the deltas keeps their tombstones.
+        std::string delta = file();
+        ASSERT_EQ(URB_SUCCESS, 
+                  urb_checkpoint_merge((const char **)checkpoint.chain + 1, 
+                                       checkpoint.deltas, delta.c_str(),
+                                       urb_cmp));
+        const char *chain[] = { checkpoint.chain[0], delta.c_str() };
+        check(chain, 2);
+    }
+
+}  // namespace
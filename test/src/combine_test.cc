@@ -0,0 +1,131 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file test/src/combine_test.cc
+/// @author Issam SAID
+/// @brief Unit testing file for the urb_tree flat combining front end.
+/// 
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <urb_tree/urb_tree.h>
+
+namespace {
+
+    int    urb_cmp(void *a, void *b) { return *(int*)a-*(int*)b; }
+
+    class CombineTest : public ::testing::Test {
+    protected:
+        virtual void SetUp() {
+            for (int i = 0; i < T*P; ++i) keys[i] = i;
+        }
+        /// Run f(combine, t) on P threads, sorted or not.
+        template <typename F>
+        void run(urb_t **urb, bool sorted, F f) {
+            urb_combine_t combine;
+            ASSERT_EQ(URB_SUCCESS, 
+                      urb_combine_init(&combine, urb, P, sorted, urb_cmp));
+            std::vector<std::thread> threads;
+            for (int t = 0; t < P; ++t) 
+                threads.push_back(std::thread(f, &combine, t));
+            for (int t = 0; t < P; ++t) threads[t].join();
+            ASSERT_LE(combine.passes, combine.requests);
+            urb_combine_delete(&combine);
+        }
+        static const int T = 2000;
+        static const int P = 8;
+        int keys[T*P];
+    };
+
+    TEST_F(CombineTest, put_pop) {
+        for (int sorted = 0; sorted < 2; ++sorted) {
+            urb_t *urb = &urb_sentinel;
+            int *k = keys;
+            run(&urb, sorted, [k](urb_combine_t *c, int t) {
+                for (int i = t; i < T*P; i += P) 
+                    urb_combine_put(c, t, urb_tree_create(&k[i], NULL));
+            });
+            ASSERT_EQ((size_t)T*P, urb_tree_size(&urb));
+            URB_TREE_CHECK_INVARIANTS(&urb);
+            /// Each thread pops the odd keys of its own.
+            run(&urb, sorted, [k](urb_combine_t *c, int t) {
+                for (int i = t; i < T*P; i += P) {
+                    if (i % 2 == 0) continue;
+                    urb_t *n = urb_combine_pop(c, t, &k[i]);
+                    if (n == &urb_sentinel || *(int*)n->key != i) abort();
+                    urb_tree_release(n);
+                    if (urb_combine_pop(c, t, &k[i]) != &urb_sentinel) 
+                        abort();
+                }
+            });
+            ASSERT_EQ((size_t)T*P/2, urb_tree_size(&urb));
+            URB_TREE_CHECK_INVARIANTS(&urb);
+            for (int i = 0; i < T*P; ++i) 
+                ASSERT_EQ(i % 2 == 1, 
+                          urb_tree_find(&urb, &i, urb_cmp) == &urb_sentinel);
+            urb_tree_delete(&urb, NULL, NULL);
+        }
+    }
+
+    TEST_F(CombineTest, upsert) {
+        urb_t *urb = &urb_sentinel;
+        int *k = keys;
+        /// All the threads upsert the same keys, with their own id as value.
+        run(&urb, true, [k](urb_combine_t *c, int t) {
+            for (int i = 0; i < T; ++i) {
+                urb_t *n = urb_combine_upsert(c, t, &k[i], &k[t]);
+                if (n == &urb_sentinel || *(int*)n->key != i) abort();
+            }
+        });
+        ASSERT_EQ((size_t)T, urb_tree_size(&urb));
+        URB_TREE_CHECK_INVARIANTS(&urb);
+        for (int i = 0; i < T; ++i) {
+            urb_t *n = urb_tree_find(&urb, &i, urb_cmp);
+            ASSERT_LT(*(int*)n->value, (int)P);
+        }
+        urb_tree_delete(&urb, NULL, NULL);
+    }
+
+    TEST_F(CombineTest, slot) {
+        urb_t *urb = &urb_sentinel, *n = urb_tree_create(&keys[0], NULL);
+        urb_combine_t combine;
+        ASSERT_EQ(URB_SUCCESS, 
+                  urb_combine_init(&combine, &urb, P, false, urb_cmp));
+        /// An id past the slots is rejected, the tree is not touched.
+        ASSERT_NE(URB_SUCCESS, urb_combine_put(&combine, P, n));
+        ASSERT_EQ(&urb_sentinel, urb_combine_pop(&combine, P, &keys[0]));
+        ASSERT_EQ(&urb_sentinel, 
+                  urb_combine_upsert(&combine, P, &keys[0], NULL));
+        ASSERT_EQ(0u, urb_tree_size(&urb));
+        ASSERT_EQ(URB_SUCCESS, urb_combine_put(&combine, P - 1, n));
+        ASSERT_EQ(1u, urb_tree_size(&urb));
+        urb_combine_delete(&combine);
+        urb_tree_delete(&urb, NULL, NULL);
+    }
+
+}  // namespace
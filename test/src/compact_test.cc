@@ -0,0 +1,148 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file test/src/compact_test.cc
+/// @author Issam SAID
+/// @brief Unit testing file for the urb_tree compaction.
+/// 
+#include <gtest/gtest.h>
+#include <urb_tree/urb_tree.h>
+
+namespace {
+
+    int  urb_cmp(void *a, void *b) { return *(int*)a-*(int*)b; }
+
+    class CompactTest : public ::testing::Test {
+    protected:
+        virtual void SetUp() {
+            urb = &urb_sentinel;
+            for (int i = 0; i < T; ++i) {
+                keys[i] = (i*7919)%T;
+                urb_tree_put(&urb, urb_tree_create(&keys[i], NULL), urb_cmp);
+            }
+            /// Remove a third of the keys to scatter the nodes.
+            for (int i = 0; i < T; i += 3) 
+                urb_tree_release(urb_tree_pop(&urb, &keys[i], urb_cmp));
+        }
+        virtual void TearDown() { urb_tree_delete(&urb, NULL, NULL); }
+        void check() {
+            URB_TREE_CHECK_INVARIANTS(&urb);
+            ASSERT_EQ(T - (T+2)/3, (int)urb_tree_size(&urb));
+            for (urb_t *n = urb_tree_min(&urb); 
+                 n != NULL && n != &urb_sentinel; n = urb_tree_succ(n)) {
+                ASSERT_TRUE(n->flags & URB_NODE_SLAB);
+                ASSERT_EQ(urb_tree_find(&urb, n->key, urb_cmp), n);
+            }
+        }
+        static const int T = 3000;
+        static const urb_layout_t layouts[3];
+        int keys[T];
+        urb_t *urb;
+    };
+
+    const urb_layout_t CompactTest::layouts[3] = { 
+        URB_LAYOUT_INORDER, URB_LAYOUT_BFS, URB_LAYOUT_VEB 
+    };
+
+    TEST_F(CompactTest, compact) {
+        /// Each compaction frees the slab of the previous one.
+        for (int l = 0; l < 3; ++l) {
+            ASSERT_EQ(URB_SUCCESS, urb_tree_compact(&urb, layouts[l]));
+            check();
+        }
+    }
+
+    TEST_F(CompactTest, incremental) {
+        urb_compact_t compact;
+        for (int l = 0; l < 3; ++l) {
+            int steps = 0;
+            ASSERT_EQ(URB_SUCCESS, 
+                      urb_compact_begin(&compact, &urb, layouts[l]));
+            /// The nodes are collected by the slices, not by begin.
+            ASSERT_EQ(0u, compact.collected);
+            while (!urb_compact_step(&compact, 100)) {
+                /// The tree stays valid between two slices.
+                ASSERT_EQ(T - (T+2)/3, (int)urb_tree_size(&urb));
+                steps++;
+            }
+            ASSERT_GT(steps, 10);
+            check();
+        }
+    }
+
+    TEST_F(CompactTest, abort) {
+        urb_compact_t compact;
+        ASSERT_EQ(URB_SUCCESS, 
+                  urb_compact_begin(&compact, &urb, URB_LAYOUT_VEB));
+        /// The number of nodes is known once they are collected.
+        while (compact.n == 0 || compact.moved < compact.n/2) 
+            urb_compact_step(&compact, 100);
+        urb_compact_abort(&compact);
+        URB_TREE_CHECK_INVARIANTS(&urb);
+        ASSERT_EQ(T - (T+2)/3, (int)urb_tree_size(&urb));
+    }
+
+    TEST_F(CompactTest, pop) {
+        ASSERT_EQ(URB_SUCCESS, urb_tree_compact(&urb, URB_LAYOUT_BFS));
+        /// The slab nodes are given back one by one.
+        for (int i = 1; i < T; i += 3) 
+            urb_tree_release(urb_tree_pop(&urb, &keys[i], urb_cmp));
+        URB_TREE_CHECK_INVARIANTS(&urb);
+        ASSERT_EQ(T/3, (int)urb_tree_size(&urb));
+        /// A new node is not in a slab.
+        urb_tree_put(&urb, urb_tree_create(&keys[0], NULL), urb_cmp);
+        ASSERT_FALSE(urb_tree_find(&urb, &keys[0], urb_cmp)->flags & 
+                     URB_NODE_SLAB);
+    }
+
+    TEST(CompactLayoutTest, inorder) {
+        int keys[100];
+        urb_t *urb = &urb_sentinel, *n, *p = NULL;
+        for (int i = 0; i < 100; ++i) {
+            keys[i] = 99-i;
+            urb_tree_put(&urb, urb_tree_create(&keys[i], NULL), urb_cmp);
+        }
+        urb_tree_compact(&urb, URB_LAYOUT_INORDER);
+        /// The successors are contiguous.
+        for (n = urb_tree_min(&urb); n != NULL && n != &urb_sentinel; 
+             p = n, n = urb_tree_succ(n)) {
+            if (p != NULL) { ASSERT_EQ(p+1, n); }
+        }
+        /// The root is the first BFS node.
+        urb_tree_compact(&urb, URB_LAYOUT_BFS);
+        ASSERT_EQ(urb+1, urb->left == &urb_sentinel ? urb->right : urb->left);
+        urb_tree_delete(&urb, NULL, NULL);
+    }
+
+    TEST(CompactLayoutTest, empty) {
+        urb_t *urb = &urb_sentinel;
+        ASSERT_EQ(URB_SUCCESS, urb_tree_compact(&urb, URB_LAYOUT_VEB));
+        ASSERT_EQ(&urb_sentinel, urb);
+    }
+
+}  // namespace
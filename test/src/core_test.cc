@@ -220,6 +220,80 @@ namespace {
         ASSERT_EQ(urb_tree_size(&urb), 0);
         ASSERT_EQ(urb_tree_delete(&urb, urb_dst, urb_dst), URB_SUCCESS);
     }
+    TEST_F(CoreTest, find_batch) {
+        urb_t *urb = &urb_sentinel;
+        int i, T = 1000, *k, *v;
+        int keys[2*1000+1];
+        void *ptrs[2*1000+1];
+        urb_t *results[2*1000+1];
+        for (i=0; i<T; ++i) {
+            k = (int*)malloc(sizeof(int));
+            v = (int*)malloc(sizeof(int));
+            *k = 2*((i*7919)%T);
+            *v = *k;
+            ASSERT_EQ(urb_tree_put(&urb, urb_tree_create(k, v), urb_cmp), 
+                      URB_SUCCESS);
+        }
+        for (i=0; i<=2*T; ++i) {
+            keys[i] = (i*31)%(2*T+1);
+            ptrs[i] = &keys[i];
+        }
+        urb_tree_find_batch(&urb, ptrs, 2*T+1, results, urb_cmp);
+        for (i=0; i<=2*T; ++i) {
+            ASSERT_EQ(urb_tree_find(&urb, ptrs[i], urb_cmp), results[i]);
+            if (keys[i] % 2 == 0 && keys[i] < 2*T)
+                ASSERT_EQ(keys[i], *(int*)results[i]->key);
+            else
+                ASSERT_EQ(&urb_sentinel, results[i]);
+        }
+        urb_tree_find_batch(&urb, ptrs, 0, results, urb_cmp);
+        ASSERT_EQ(urb_tree_delete(&urb, urb_dst, urb_dst), URB_SUCCESS);
+        urb = &urb_sentinel;
+        urb_tree_find_batch(&urb, ptrs, 1, results, urb_cmp);
+        ASSERT_EQ(&urb_sentinel, results[0]);
+    }
+
+    TEST_F(CoreTest, erase_node) {
+        urb_t *urb = &urb_sentinel;
+        int i, j, T = 1000;
+        int keys[1000];
+        urb_t *nodes[1000];
+        for (i=0; i<T; ++i) {
+            keys[i]  = (i*7919)%T;
+            nodes[i] = urb_tree_create(&keys[i], &keys[i]);
+            ASSERT_EQ(urb_tree_put(&urb, nodes[i], urb_cmp), URB_SUCCESS);
+        }
+        for (i=0; i<T; ++i) {
+            /// Erase in another order, the handles keep their pairs.
+            j = (i*631)%T;
+            ASSERT_EQ(nodes[j], urb_tree_erase_node(&urb, nodes[j]));
+            ASSERT_EQ(&keys[j], nodes[j]->key);
+            ASSERT_EQ(&urb_sentinel, urb_tree_find(&urb, &keys[j], urb_cmp));
+            if (i % 50 == 0) {
+                URB_TREE_CHECK_INVARIANTS(&urb);
+                ASSERT_EQ(urb_tree_size(&urb), (size_t)(T-i-1));
+            }
+            urb_tree_release(nodes[j]);
+            nodes[j] = NULL;
+            if (i+1 < T) {
+                j = (i*631+1)%T;
+                if (nodes[j]) {
+                    ASSERT_EQ(nodes[j], urb_tree_find(&urb, &keys[j], urb_cmp));
+                }
+            }
+        }
+        ASSERT_EQ(&urb_sentinel, urb);
+        /// urb_tree_pop returns the node that held the key.
+        for (i=0; i<T; ++i) {
+            nodes[i] = urb_tree_create(&keys[i], NULL);
+            urb_tree_put(&urb, nodes[i], urb_cmp);
+        }
+        for (i=0; i<T; ++i) {
+            ASSERT_EQ(nodes[i], urb_tree_pop(&urb, &keys[i], urb_cmp));
+            urb_tree_release(nodes[i]);
+        }
+    }
+
     /*
     TEST_F(CoreTest, right_rotate_root) {
          urb urb;
@@ -0,0 +1,127 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file test/src/cursor_test.cc
+/// @author Issam SAID
+/// @brief Unit testing file for the urb_tree cursors.
+/// 
+#include <gtest/gtest.h>
+#include <urb_tree/urb_tree.h>
+
+namespace {
+
+    int  urb_cmp(void *a, void *b) { return *(int*)a-*(int*)b; }
+
+    class CursorTest : public ::testing::Test {
+    protected:
+        virtual void SetUp() {
+            urb = &urb_sentinel;
+            /// The even keys in [0, 2*T).
+            for (int i = 0; i < T; ++i) {
+                keys[i] = 2*((i*7919)%T);
+                urb_tree_put(&urb, urb_tree_create(&keys[i], NULL), urb_cmp);
+            }
+            urb_cursor_init(&cursor, &urb, urb_cmp);
+        }
+        virtual void TearDown() { urb_tree_delete(&urb, NULL, NULL); }
+        static const int T = 2000;
+        int keys[T];
+        urb_t *urb;
+        urb_cursor_t cursor;
+    };
+
+    TEST_F(CursorTest, seek) {
+        uint64_t x = 3;
+        int key, step;
+        ASSERT_TRUE(urb_cursor_node(&cursor) == NULL);
+        for (int i = 0; i < 20*T; ++i) {
+            x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+            /// Local steps most of the time, long jumps sometimes.
+            step = (i % 10 == 0) ? (int)(x % (2*T+3)) : (int)(x % 41) - 20;
+            key  = (i % 10 == 0) ? step - 1 : key + step;
+            urb_t *n = urb_cursor_seek(&cursor, &key);
+            ASSERT_EQ(urb_tree_find(&urb, &key, urb_cmp), n);
+            if (n != &urb_sentinel) {
+                ASSERT_EQ(n, urb_cursor_node(&cursor));
+            } else {
+                /// The cursor is next to the missing key.
+                urb_t *c = urb_cursor_node(&cursor), *s;
+                ASSERT_TRUE(c != NULL);
+                if (*(int*)c->key < key) {
+                    s = urb_tree_succ(c);
+                    ASSERT_TRUE(s == NULL || s == &urb_sentinel || 
+                                *(int*)s->key > key);
+                } else {
+                    s = urb_tree_prev(c);
+                    ASSERT_TRUE(s == NULL || s == &urb_sentinel || 
+                                *(int*)s->key < key);
+                }
+            }
+        }
+    }
+
+    TEST_F(CursorTest, next_prev) {
+        int key = 1000, i;
+        ASSERT_TRUE(urb_cursor_next(&cursor) == NULL);
+        urb_cursor_seek(&cursor, &key);
+        for (i = 1; urb_cursor_next(&cursor); ++i) 
+            ASSERT_EQ(1000+2*i, *(int*)urb_cursor_node(&cursor)->key);
+        ASSERT_EQ(2*T, 1000+2*i);
+        /// The cursor stays on the last node.
+        ASSERT_EQ(2*T-2, *(int*)urb_cursor_node(&cursor)->key);
+        for (i = 1; urb_cursor_prev(&cursor); ++i) 
+            ASSERT_EQ(2*T-2-2*i, *(int*)urb_cursor_node(&cursor)->key);
+        ASSERT_EQ(0, *(int*)urb_cursor_node(&cursor)->key);
+    }
+
+    TEST_F(CursorTest, erase) {
+        int key = 2*(T/2);
+        urb_t *n = urb_cursor_seek(&cursor, &key);
+        /// Erasing other nodes keeps the cursor valid.
+        for (int i = 0; i < T; ++i) {
+            if (keys[i] % 8 != 0 || keys[i] == key) continue;
+            urb_tree_release(urb_tree_erase_node(&urb, 
+                urb_tree_find(&urb, &keys[i], urb_cmp)));
+        }
+        URB_TREE_CHECK_INVARIANTS(&urb);
+        ASSERT_EQ(n, urb_cursor_node(&cursor));
+        for (int k = -1; k <= 2*T; ++k) 
+            ASSERT_EQ(urb_tree_find(&urb, &k, urb_cmp), 
+                      urb_cursor_seek(&cursor, &k));
+    }
+
+    TEST(CursorEmptyTest, empty) {
+        urb_t *urb = &urb_sentinel;
+        urb_cursor_t cursor;
+        int key = 0;
+        urb_cursor_init(&cursor, &urb, urb_cmp);
+        ASSERT_EQ(&urb_sentinel, urb_cursor_seek(&cursor, &key));
+        ASSERT_TRUE(urb_cursor_prev(&cursor) == NULL);
+    }
+
+}  // namespace
@@ -0,0 +1,105 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file test/src/destroy_test.cc
+/// @author Issam SAID
+/// @brief Unit testing file for the urb_tree deferred destruction.
+/// 
+#include <atomic>
+#include <gtest/gtest.h>
+#include <urb_tree/urb_tree.h>
+
+namespace {
+
+    int  int_cmp(void *a, void *b) { return *(int*)a-*(int*)b; }
+
+    std::atomic<int> keys_released(0), values_released(0);
+
+    void key_dst(void *a) { keys_released++; free(a); }
+
+    void value_dst(void *a) { values_released++; free(a); }
+
+    class DestroyTest : public ::testing::Test {
+    protected:
+        virtual void SetUp() {
+            int *k, *v;
+            urb = &urb_sentinel;
+            keys_released = values_released = 0;
+            for (int i = 0; i < T; ++i) {
+                k  = (int*)malloc(sizeof(int));
+                v  = (int*)malloc(sizeof(int));
+                *k = (i*7919)%T;
+                *v = i;
+                urb_tree_put(&urb, urb_tree_create(k, v), int_cmp);
+            }
+        }
+        virtual void TearDown() { urb_tree_delete(&urb, key_dst, value_dst); }
+        static const int T = 5000;
+        urb_t *urb;
+    };
+
+    TEST_F(DestroyTest, step) {
+        urb_destroy_t destroy;
+        int steps = 0;
+        urb_tree_detach(&destroy, &urb, key_dst, value_dst);
+        ASSERT_EQ(&urb_sentinel, urb);
+        while (!urb_destroy_step(&destroy, 64)) {
+            steps++;
+            ASSERT_EQ(64*steps, keys_released);
+            ASSERT_EQ(64*steps, values_released);
+        }
+        ASSERT_EQ((T+63)/64 - 1, steps);
+        ASSERT_EQ((int)T, keys_released);
+        ASSERT_EQ((int)T, values_released);
+        ASSERT_TRUE(urb_destroy_step(&destroy, 64));
+    }
+
+    TEST_F(DestroyTest, async) {
+        urb_t *other = &urb_sentinel;
+        int *k = (int*)malloc(sizeof(int));
+        ASSERT_EQ(URB_SUCCESS, urb_tree_delete_async(&urb, key_dst, value_dst));
+        /// The tree is usable as soon as it is detached.
+        ASSERT_EQ(&urb_sentinel, urb);
+        *k = 1;
+        urb_tree_put(&urb, urb_tree_create(k, NULL), int_cmp);
+        ASSERT_EQ(1U, urb_tree_size(&urb));
+        ASSERT_EQ(URB_SUCCESS, urb_tree_delete_async(&other, NULL, NULL));
+        urb_tree_delete_wait();
+        ASSERT_EQ((int)T, keys_released);
+        ASSERT_EQ((int)T, values_released);
+    }
+
+    TEST_F(DestroyTest, compacted) {
+        urb_destroy_t destroy;
+        urb_tree_compact(&urb, URB_LAYOUT_BFS);
+        urb_tree_detach(&destroy, &urb, key_dst, value_dst);
+        while (!urb_destroy_step(&destroy, 1000));
+        ASSERT_EQ((int)T, keys_released);
+    }
+
+}  // namespace
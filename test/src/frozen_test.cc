@@ -0,0 +1,194 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file test/src/frozen_test.cc
+/// @author Issam SAID
+/// @brief Unit testing file for the urb_tree frozen (read-only) trees.
+/// 
+#include <stdint.h>
+#include <unistd.h>
+#include <vector>
+#include <gtest/gtest.h>
+#include <urb_tree/urb_tree.h>
+
+namespace {
+
+    int  i64_cmp(void *a, void *b) { 
+        int64_t x = *(int64_t*)a, y = *(int64_t*)b;
+        return (x > y) - (x < y);
+    }
+
+    void i64_dst(void *a) { free(a); }
+
+    class FrozenTest : public ::testing::Test {
+    protected:
+        virtual void SetUp() {
+            urb = &urb_sentinel;
+            /// The even keys in [0, 2*T).
+            for (int64_t i=0; i<T; ++i) {
+                int64_t *k = (int64_t*)malloc(sizeof(int64_t));
+                int64_t *v = (int64_t*)malloc(sizeof(int64_t));
+                *k = 2*((i*7919)%T);
+                *v = -*k;
+                ASSERT_EQ(urb_tree_put(&urb, urb_tree_create(k, v), i64_cmp), 
+                          URB_SUCCESS);
+            }
+        }
+        virtual void TearDown() { urb_tree_delete(&urb, i64_dst, i64_dst); }
+        static const int64_t T = 1000;
+        urb_t *urb;
+    };
+
+    void check_find(urb_t **urb, urb_frozen_t *f) {
+        int64_t key;
+        for (key = -1; key <= 2*1000+1; ++key) {
+            urb_t *n = urb_tree_find(urb, &key, i64_cmp);
+            size_t i = urb_frozen_find(f, &key, i64_cmp);
+            ASSERT_EQ(i, urb_frozen_find_int64(f, key));
+            if (n == &urb_sentinel) { ASSERT_EQ(0u, i); continue; }
+            ASSERT_NE(0u, i);
+            ASSERT_EQ(*(int64_t*)n->key,   *(int64_t*)urb_frozen_key(f, i));
+            ASSERT_EQ(*(int64_t*)n->value, *(int64_t*)urb_frozen_value(f, i));
+        }
+    }
+
+    TEST_F(FrozenTest, find) {
+        urb_frozen_t *f = urb_tree_freeze(&urb, sizeof(int64_t), 
+                                          sizeof(int64_t));
+        ASSERT_EQ((size_t)T, f->n);
+        check_find(&urb, f);
+        urb_frozen_delete(f);
+        /// Keep the pointers instead of copying.
+        f = urb_tree_freeze(&urb, 0, 0);
+        for (int64_t key = 0; key < 2*T; key += 2) {
+            size_t i = urb_frozen_find(f, &key, i64_cmp);
+            ASSERT_EQ(urb_tree_find(&urb, &key, i64_cmp)->key, 
+                      urb_frozen_key(f, i));
+        }
+        urb_frozen_delete(f);
+    }
+
+    TEST_F(FrozenTest, batch) {
+        std::vector<int64_t> keys;
+        std::vector<size_t>  results(2*T+3);
+        urb_frozen_t *f = urb_tree_freeze(&urb, sizeof(int64_t), 
+                                          sizeof(int64_t));
+        for (int64_t key = -1; key <= 2*T+1; ++key) keys.push_back(key);
+        urb_frozen_find_int64_batch(f, &keys[0], keys.size(), &results[0]);
+        for (size_t j = 0; j < keys.size(); ++j) 
+            ASSERT_EQ(urb_frozen_find_int64(f, keys[j]), results[j]);
+        urb_frozen_delete(f);
+    }
+
+    TEST_F(FrozenTest, scan) {
+        urb_frozen_t *f = urb_tree_freeze(&urb, sizeof(int64_t), 
+                                          sizeof(int64_t));
+        urb_t  *n = urb_tree_min(&urb);
+        size_t  i = urb_frozen_min(f);
+        int64_t key = 501;
+        while (n != NULL && n != &urb_sentinel) {
+            ASSERT_NE(0u, i);
+            ASSERT_EQ(*(int64_t*)n->key, *(int64_t*)urb_frozen_key(f, i));
+            n = urb_tree_succ(n);
+            i = urb_frozen_succ(f, i);
+        }
+        ASSERT_EQ(0u, i);
+        n = urb_tree_max(&urb);
+        i = urb_frozen_max(f);
+        while (n != NULL && n != &urb_sentinel) {
+            ASSERT_EQ(*(int64_t*)n->key, *(int64_t*)urb_frozen_key(f, i));
+            n = urb_tree_prev(n);
+            i = urb_frozen_prev(f, i);
+        }
+        ASSERT_EQ(0u, i);
+        i = urb_frozen_lower_bound(f, &key, i64_cmp);
+        ASSERT_EQ(502, *(int64_t*)urb_frozen_key(f, i));
+        key = 2*T;
+        ASSERT_EQ(0u, urb_frozen_lower_bound(f, &key, i64_cmp));
+        urb_frozen_delete(f);
+    }
+
+    TEST_F(FrozenTest, save_load) {
+        char path[] = "/tmp/urb_frozen_XXXXXX";
+        int fd = mkstemp(path);
+        ASSERT_GE(fd, 0);
+        close(fd);
+        urb_frozen_t *f = urb_tree_freeze(&urb, sizeof(int64_t), 
+                                          sizeof(int64_t));
+        ASSERT_EQ(URB_SUCCESS, urb_frozen_save(f, path));
+        urb_frozen_delete(f);
+        ASSERT_TRUE((f = urb_frozen_load(path)) != NULL);
+        ASSERT_TRUE(f->map != NULL);
+        check_find(&urb, f);
+        urb_frozen_delete(f);
+        unlink(path);
+        ASSERT_TRUE(urb_frozen_load(path) == NULL);
+    }
+
+    TEST_F(FrozenTest, corrupt) {
+        char path[] = "/tmp/urb_frozen_XXXXXX";
+        uint64_t header[6], field;
+        int fd = mkstemp(path);
+        ASSERT_GE(fd, 0);
+        urb_frozen_t *f = urb_tree_freeze(&urb, sizeof(int64_t), 
+                                          sizeof(int64_t));
+        ASSERT_EQ(URB_SUCCESS, urb_frozen_save(f, path));
+        urb_frozen_delete(f);
+        ASSERT_EQ((ssize_t)sizeof(header), 
+                  pread(fd, header, sizeof(header), 0));
+        /// The keys past the values, misaligned, in the header, then too 
+        /// many keys and an overflowing key size.
+        const uint64_t fields[][2] = { 
+            { 4, header[5] + 64 }, { 4, header[4] + 8 }, { 4, 0 },
+            { 1, 100*header[1] }, { 2, UINT64_MAX/2 + 1 } 
+        };
+        for (size_t i = 0; i < sizeof(fields)/sizeof(fields[0]); ++i) {
+            field = fields[i][1];
+            ASSERT_EQ(8, pwrite(fd, &field, 8, 8*fields[i][0]));
+            ASSERT_TRUE(urb_frozen_load(path) == NULL);
+            ASSERT_EQ(8, pwrite(fd, &header[fields[i][0]], 8, 
+                                8*fields[i][0]));
+        }
+        ASSERT_TRUE((f = urb_frozen_load(path)) != NULL);
+        urb_frozen_delete(f);
+        close(fd);
+        unlink(path);
+    }
+
+    TEST(FrozenEmptyTest, empty) {
+        urb_t *urb = &urb_sentinel;
+        int64_t key = 0;
+        urb_frozen_t *f = urb_tree_freeze(&urb, sizeof(int64_t), 0);
+        ASSERT_EQ(0u, f->n);
+        ASSERT_EQ(0u, urb_frozen_find(f, &key, i64_cmp));
+        ASSERT_EQ(0u, urb_frozen_find_int64(f, key));
+        ASSERT_EQ(0u, urb_frozen_min(f));
+        urb_frozen_delete(f);
+    }
+
+}  // namespace
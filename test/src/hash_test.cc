@@ -0,0 +1,100 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file test/src/hash_test.cc
+/// @author Issam SAID
+/// @brief Unit testing file for the urb_tree hybrid hash index.
+/// 
+#include <gtest/gtest.h>
+#include <urb_tree/urb_tree.h>
+
+namespace {
+
+    int      urb_cmp(void *a, void *b) { return *(int*)a-*(int*)b; }
+
+    /// A weak hash, many keys share the same hash.
+    uint64_t urb_hash(void *a) { return (uint64_t)(*(int*)a / 4); }
+
+    class HashTest : public ::testing::Test {
+    protected:
+        virtual void SetUp() {
+            ASSERT_EQ(URB_SUCCESS, urb_hash_init(&hash, 0, urb_hash));
+            for (int i = 0; i < T; ++i) {
+                keys[i] = (i*7919)%T;
+                ASSERT_EQ(URB_SUCCESS, 
+                          urb_hash_put(&hash, urb_tree_create(&keys[i], NULL),
+                                       urb_cmp));
+            }
+        }
+        virtual void TearDown() { urb_hash_delete(&hash, NULL, NULL); }
+        static const int T = 5000;
+        int keys[T];
+        urb_hash_t hash;
+    };
+
+    TEST_F(HashTest, find) {
+        ASSERT_EQ((size_t)T, hash.n);
+        ASSERT_GE(hash.capacity, 2*hash.n);
+        for (int i = -10; i < T+10; ++i) 
+            ASSERT_EQ(urb_tree_find(&hash.root, &i, urb_cmp), 
+                      urb_hash_find(&hash, &i, urb_cmp));
+    }
+
+    TEST_F(HashTest, pop) {
+        for (int k = 0; k < T; k += 2) {
+            urb_t *n = urb_hash_pop(&hash, &k, urb_cmp);
+            ASSERT_EQ(k, *(int*)n->key);
+            urb_tree_release(n);
+        }
+        ASSERT_EQ(&urb_sentinel, urb_hash_pop(&hash, &keys[0], urb_cmp));
+        URB_TREE_CHECK_INVARIANTS(&hash.root);
+        ASSERT_EQ((size_t)T/2, urb_tree_size(&hash.root));
+        for (int i = 0; i < T; ++i) 
+            ASSERT_EQ(urb_tree_find(&hash.root, &i, urb_cmp), 
+                      urb_hash_find(&hash, &i, urb_cmp));
+        /// The removed keys can be put back.
+        for (int i = 0; i < T; ++i) 
+            if (keys[i] % 2 == 0) 
+                urb_hash_put(&hash, urb_tree_create(&keys[i], NULL), urb_cmp);
+        ASSERT_EQ((size_t)T, urb_tree_size(&hash.root));
+        for (int i = 0; i < T; ++i) 
+            ASSERT_EQ(i, *(int*)urb_hash_find(&hash, &i, urb_cmp)->key);
+    }
+
+    TEST_F(HashTest, upsert) {
+        int v = 1, k = T;
+        urb_t *n = urb_hash_find(&hash, &keys[7], urb_cmp);
+        ASSERT_EQ(n, urb_hash_upsert(&hash, &keys[7], &v, urb_cmp));
+        ASSERT_EQ(&v, n->value);
+        n = urb_hash_upsert(&hash, &k, &v, urb_cmp);
+        ASSERT_EQ(n, urb_tree_max(&hash.root));
+        ASSERT_EQ(n, urb_hash_find(&hash, &k, urb_cmp));
+        URB_TREE_CHECK_INVARIANTS(&hash.root);
+    }
+
+}  // namespace
@@ -0,0 +1,100 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file test/src/load_test.cc
+/// @author Issam SAID
+/// @brief Unit testing file for the urb_tree bulk loading.
+/// 
+#include <gtest/gtest.h>
+#include <urb_tree/urb_tree.h>
+
+namespace {
+
+    int  urb_cmp(void *a, void *b) { return *(int*)a-*(int*)b; }
+
+    typedef struct { int key; int value; } record_t;
+
+    TEST(LoadTest, build) {
+        int keys[1000];
+        void *k[1000];
+        for (int i = 0; i < 1000; ++i) { keys[i] = i; k[i] = &keys[i]; }
+        /// All the sizes around the complete trees.
+        for (size_t n = 0; n <= 1000; n += (n < 70 ? 1 : 97)) {
+            urb_t *urb = &urb_sentinel;
+            ASSERT_EQ(URB_SUCCESS, urb_tree_build(&urb, k, k, n));
+            URB_TREE_CHECK_INVARIANTS(&urb);
+            ASSERT_EQ(n, urb_tree_size(&urb));
+            for (size_t i = 0; i < n; ++i) 
+                ASSERT_EQ(&keys[i], 
+                          urb_tree_find(&urb, &keys[i], urb_cmp)->key);
+            /// The built tree can be updated.
+            if (n > 2) {
+                urb_tree_release(urb_tree_pop(&urb, &keys[n/2], urb_cmp));
+                URB_TREE_CHECK_INVARIANTS(&urb);
+            }
+            /// A tree is only built from an empty tree.
+            if (n > 0) {
+                ASSERT_NE(URB_SUCCESS, urb_tree_build(&urb, k, k, n));
+            }
+            urb_tree_delete(&urb, NULL, NULL);
+        }
+    }
+
+    TEST(LoadTest, load) {
+        const int T = 100000;
+        FILE *f = tmpfile();
+        record_t r;
+        urb_t *urb = &urb_sentinel;
+        urb_load_t load;
+        urb_load_config_t config = { sizeof(record_t), 64*1024, 4, 
+                                     NULL, urb_cmp };
+        /// Unsorted keys in [0, T/2), each written twice.
+        for (int i = 0; i < T; ++i) {
+            r.key   = (int)(((long)i*7919) % (T/2));
+            r.value = i;
+            ASSERT_EQ(1U, fwrite(&r, sizeof(r), 1, f));
+        }
+        rewind(f);
+        ASSERT_EQ(URB_SUCCESS, urb_tree_load(&urb, f, &config, &load));
+        fclose(f);
+        URB_TREE_CHECK_INVARIANTS(&urb);
+        ASSERT_EQ((size_t)T/2, load.n);
+        ASSERT_EQ((size_t)T/2, load.duplicates);
+        ASSERT_EQ((size_t)T/2, urb_tree_size(&urb));
+        ASSERT_GE(load.runs, (size_t)T*sizeof(r)/config.memory);
+        int i = 0;
+        for (urb_t *n = urb_tree_min(&urb); n != NULL && n != &urb_sentinel; 
+             n = urb_tree_succ(n), ++i) {
+            ASSERT_EQ(i, ((record_t*)n->key)->key);
+            ASSERT_EQ(n->key, n->value);
+        }
+        urb_tree_delete(&urb, NULL, NULL);
+        free(load.records);
+    }
+
+}  // namespace
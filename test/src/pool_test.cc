@@ -0,0 +1,171 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file test/src/pool_test.cc
+/// @author Issam SAID
+/// @brief Unit testing file for the urb_tree node pools.
+/// 
+#include <stdint.h>
+#include <map>
+#include <gtest/gtest.h>
+#include <urb_tree/urb_tree.h>
+
+namespace {
+
+    class PoolTest : public ::testing::Test {
+    protected:
+        virtual void SetUp() { 
+            ASSERT_EQ(URB_SUCCESS, urb_pool_init(&pool, 0)); 
+        }
+        virtual void TearDown() { urb_pool_delete(&pool); }
+        void check(urb_pool_t *p) {
+            std::map<int64_t, uint64_t>::iterator it = ref.begin();
+            ASSERT_TRUE(urb_pool_check(p));
+            ASSERT_EQ(ref.size(), (size_t)p->n);
+            for (uint32_t i = urb_pool_min(p); i; 
+                 i = urb_pool_succ(p, i), ++it) {
+                ASSERT_EQ(it->first,  urb_pool_key(p, i));
+                ASSERT_EQ(it->second, urb_pool_value(p, i));
+            }
+            ASSERT_TRUE(it == ref.end());
+        }
+        static const int64_t T = 20000;
+        urb_pool_t pool;
+        std::map<int64_t, uint64_t> ref;
+    };
+
+    TEST_F(PoolTest, layout) {
+#ifdef __URB_TREE_POOL_SPLIT
+        ASSERT_EQ(16U, sizeof(urb_pnode_t));
+        ASSERT_EQ(16U, sizeof(urb_pcold_t));
+#else
+        ASSERT_EQ(32U, sizeof(urb_pnode_t));
+#endif
+        ASSERT_EQ(0U, (uintptr_t)pool.nodes % 64);
+        ASSERT_EQ(0U, urb_pool_min(&pool));
+        ASSERT_EQ(0U, urb_pool_find(&pool, 1));
+    }
+
+    TEST_F(PoolTest, put_pop) {
+        uint64_t x = 11, v;
+        for (int64_t i = 0; i < T; ++i) {
+            int64_t k = (i*7919) % T - T/2;
+            uint32_t n = urb_pool_put(&pool, k, (uint64_t)i);
+            ASSERT_EQ(n, urb_pool_find(&pool, k));
+            ref[k] = (uint64_t)i;
+        }
+        check(&pool);
+        /// Random removals and insertions reuse the free nodes.
+        for (int i = 0; i < 4*T; ++i) {
+            x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+            int64_t k = (int64_t)(x % (2*T)) - T;
+            if (ref.count(k)) {
+                ASSERT_TRUE(urb_pool_pop(&pool, k, &v));
+                ASSERT_EQ(ref[k], v);
+                ref.erase(k);
+            } else {
+                ASSERT_FALSE(urb_pool_pop(&pool, k, NULL));
+                urb_pool_put(&pool, k, x);
+                ref[k] = x;
+            }
+        }
+        check(&pool);
+        ASSERT_LE(pool.size, (uint32_t)(ref.size() + T + 1));
+        /// The predecessors in reverse order.
+        std::map<int64_t, uint64_t>::reverse_iterator it = ref.rbegin();
+        for (uint32_t i = urb_pool_max(&pool); i; 
+             i = urb_pool_prev(&pool, i), ++it) 
+            ASSERT_EQ(it->first, urb_pool_key(&pool, i));
+        while (!ref.empty()) {
+            ASSERT_TRUE(urb_pool_pop(&pool, ref.begin()->first, NULL));
+            ref.erase(ref.begin());
+        }
+        check(&pool);
+        ASSERT_EQ(0U, pool.root);
+    }
+
+    TEST_F(PoolTest, relocate) {
+        urb_pool_t copy, loaded;
+        char path[] = "/tmp/urb_pool_XXXXXX";
+        int fd = mkstemp(path);
+        ASSERT_GE(fd, 0);
+        close(fd);
+        for (int64_t i = 0; i < T; ++i) {
+            urb_pool_put(&pool, 3*i, (uint64_t)i);
+            ref[3*i] = (uint64_t)i;
+        }
+        /// A plain copy of the nodes is a valid pool.
+        copy = pool;
+        copy.nodes = (urb_pnode_t *)malloc(pool.capacity*sizeof(urb_pnode_t));
+        memcpy(copy.nodes, pool.nodes, pool.capacity*sizeof(urb_pnode_t));
+#ifdef __URB_TREE_POOL_SPLIT
+        copy.cold = (urb_pcold_t *)malloc(pool.capacity*sizeof(urb_pcold_t));
+        memcpy(copy.cold, pool.cold, pool.capacity*sizeof(urb_pcold_t));
+#endif
+        check(&copy);
+        urb_pool_delete(&copy);
+        ASSERT_EQ(URB_SUCCESS, urb_pool_save(&pool, path));
+        ASSERT_EQ(URB_SUCCESS, urb_pool_load(&loaded, path));
+        unlink(path);
+        check(&loaded);
+        urb_pool_put(&loaded, 1, 1);
+        ref[1] = 1;
+        check(&loaded);
+        urb_pool_delete(&loaded);
+    }
+
+    TEST_F(PoolTest, corrupt) {
+        urb_pool_t loaded;
+        char path[] = "/tmp/urb_pool_XXXXXX";
+        uint32_t header[6], link = 1000;
+        int fd = mkstemp(path);
+        ASSERT_GE(fd, 0);
+        for (int64_t i = 0; i < 100; ++i) urb_pool_put(&pool, i, i);
+        ASSERT_EQ(URB_SUCCESS, urb_pool_save(&pool, path));
+        ASSERT_EQ((ssize_t)sizeof(header), 
+                  pread(fd, header, sizeof(header), 0));
+        /// An oversized pool, then too many keys.
+        uint32_t size = UINT32_MAX, n = header[2] + 1;
+        ASSERT_EQ(4, pwrite(fd, &size, 4, 8));
+        ASSERT_NE(URB_SUCCESS, urb_pool_load(&loaded, path));
+        ASSERT_EQ(4, pwrite(fd, &header[2], 4, 8));
+        ASSERT_EQ(4, pwrite(fd, &n, 4, 12));
+        ASSERT_NE(URB_SUCCESS, urb_pool_load(&loaded, path));
+        ASSERT_EQ(4, pwrite(fd, &header[3], 4, 12));
+        ASSERT_EQ(URB_SUCCESS, urb_pool_load(&loaded, path));
+        urb_pool_delete(&loaded);
+        /// A link out of the pool (the left child of the node 1).
+        ASSERT_EQ(4, pwrite(fd, &link, 4, 
+                            sizeof(header) + sizeof(urb_pnode_t) + 
+                            offsetof(urb_pnode_t, left)));
+        ASSERT_NE(URB_SUCCESS, urb_pool_load(&loaded, path));
+        close(fd);
+        unlink(path);
+    }
+
+}  // namespace
@@ -0,0 +1,121 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file test/src/pq_test.cc
+/// @author Issam SAID
+/// @brief Unit testing file for the urb_tree priority queue mode.
+/// 
+#include <set>
+#include <gtest/gtest.h>
+#include <urb_tree/urb_tree.h>
+
+namespace {
+
+    int  urb_cmp(void *a, void *b) { 
+        long x = *(long*)a, y = *(long*)b;
+        return (x > y) - (x < y);
+    }
+
+    class PqTest : public ::testing::Test {
+    protected:
+        virtual void SetUp() { urb_pq_init(&pq); }
+        virtual void TearDown() { urb_pq_delete(&pq, NULL, NULL); }
+        void check() {
+            if (ref.empty()) {
+                ASSERT_TRUE(urb_pq_min(&pq) == NULL);
+                ASSERT_TRUE(urb_pq_max(&pq) == NULL);
+                return;
+            }
+            ASSERT_EQ(urb_tree_min(&pq.root), urb_pq_min(&pq));
+            ASSERT_EQ(urb_tree_max(&pq.root), urb_pq_max(&pq));
+            ASSERT_EQ(*ref.begin(),  *(long*)urb_pq_min(&pq)->key);
+            ASSERT_EQ(*ref.rbegin(), *(long*)urb_pq_max(&pq)->key);
+        }
+        void put(long i) {
+            urb_pq_put(&pq, urb_tree_create(&keys[i], NULL), urb_cmp);
+            ref.insert(keys[i]);
+        }
+        static const long T = 2000;
+        long keys[T];
+        urb_pq_t pq;
+        std::set<long> ref;
+    };
+
+    TEST_F(PqTest, pop_min) {
+        for (long i = 0; i < T; ++i) keys[i] = (i*7919) % T;
+        for (long i = 0; i < T; ++i) { put(i); check(); }
+        URB_TREE_CHECK_INVARIANTS(&pq.root);
+        for (long i = 0; i < T; ++i) {
+            urb_t *n = urb_tree_pop_min(&pq);
+            ASSERT_EQ(i, *(long*)n->key);
+            ref.erase(i);
+            urb_tree_release(n);
+            check();
+        }
+        ASSERT_TRUE(urb_tree_pop_min(&pq) == NULL);
+        ASSERT_EQ(&urb_sentinel, pq.root);
+    }
+
+    TEST_F(PqTest, pop_max) {
+        for (long i = 0; i < T; ++i) keys[i] = i;
+        for (long i = 0; i < T; ++i) { put(i); check(); }
+        for (long i = T-1; i >= 0; --i) {
+            urb_t *n = urb_tree_pop_max(&pq);
+            ASSERT_EQ(i, *(long*)n->key);
+            ref.erase(i);
+            urb_tree_release(n);
+            check();
+        }
+        ASSERT_TRUE(urb_tree_pop_max(&pq) == NULL);
+    }
+
+    TEST_F(PqTest, mixed) {
+        uint64_t x = 7;
+        long next = 0;
+        for (long i = 0; i < T; ++i) keys[i] = T-1-i;
+        for (int r = 0; r < 20*T; ++r) {
+            x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+            urb_t *n = NULL;
+            switch (x % 4) {
+                case 0: 
+                case 1: if (next < T) put(next++); break;
+                case 2: n = (x & 16) ? urb_tree_pop_min(&pq) 
+                                     : urb_tree_pop_max(&pq); break;
+                case 3: 
+                    if (ref.empty()) break;
+                    n = urb_pq_pop(&pq, &keys[(x >> 8) % next], urb_cmp);
+                    if (n == &urb_sentinel) n = NULL;
+                    break;
+            }
+            if (n) { ref.erase(*(long*)n->key); urb_tree_release(n); }
+            check();
+        }
+        URB_TREE_CHECK_INVARIANTS(&pq.root);
+    }
+
+}  // namespace
@@ -0,0 +1,118 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file test/src/prefix_test.cc
+/// @author Issam SAID
+/// @brief Unit testing file for the urb_tree key prefixes.
+/// 
+#include <string.h>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <urb_tree/urb_tree.h>
+
+namespace {
+
+    int  str_cmp(void *a, void *b) { return strcmp((char*)a, (char*)b); }
+
+    class PrefixTest : public ::testing::Test {
+    protected:
+        virtual void SetUp() {
+            urb = &urb_sentinel;
+            /// Short keys, and long keys that tie on their first 8 bytes.
+            for (int i = 0; i < T; ++i) {
+                char buf[64];
+                if (i % 2) snprintf(buf, sizeof(buf), "%d", i*7919 % T);
+                else snprintf(buf, sizeof(buf), "common/prefix/%06d", i);
+                keys.push_back(buf);
+            }
+            for (int i = 0; i < T; ++i) {
+                void *k = (void*)keys[i].c_str();
+                ASSERT_EQ(URB_SUCCESS, 
+                          urb_tree_put_prefixed(&urb, urb_tree_create(k, k),
+                                                urb_tree_prefix_string, 
+                                                str_cmp));
+            }
+        }
+        virtual void TearDown() { urb_tree_delete(&urb, NULL, NULL); }
+        static const int T = 2000;
+        std::vector<std::string> keys;
+        urb_t *urb;
+    };
+
+    TEST_F(PrefixTest, normalize) {
+        const char *s[] = { "", "a", "ab", "abcdefgh", "abcdefghij", "abd", 
+                            "b", "\xff", "\xff\xff" };
+        for (size_t i = 0; i < sizeof(s)/sizeof(s[0]); ++i) {
+            for (size_t j = 0; j < sizeof(s)/sizeof(s[0]); ++j) {
+                int c = strcmp(s[i], s[j]);
+                uint64_t pi = urb_tree_prefix_string((void*)s[i]);
+                uint64_t pj = urb_tree_prefix_string((void*)s[j]);
+                if (c < 0)  { ASSERT_LE(pi, pj); }
+                if (c > 0)  { ASSERT_GE(pi, pj); }
+                if (c == 0) { ASSERT_EQ(pi, pj); }
+            }
+        }
+    }
+
+    TEST_F(PrefixTest, find) {
+        URB_TREE_CHECK_INVARIANTS(&urb);
+        for (int i = 0; i < T; ++i) {
+            std::string missing = keys[i] + "x";
+            void *k = (void*)keys[i].c_str();
+            urb_t *n = urb_tree_find_prefixed(&urb, k, urb_tree_prefix_string,
+                                              str_cmp);
+            ASSERT_EQ(urb_tree_find(&urb, k, str_cmp), n);
+            ASSERT_EQ(0, strcmp((char*)n->key, keys[i].c_str()));
+            ASSERT_EQ(&urb_sentinel, 
+                      urb_tree_find_prefixed(&urb, (void*)missing.c_str(), 
+                                             urb_tree_prefix_string, str_cmp));
+        }
+    }
+
+    TEST_F(PrefixTest, pop) {
+        for (int i = 0; i < T; ++i) {
+            void *k = (void*)keys[i].c_str();
+            urb_t *n = urb_tree_pop_prefixed(&urb, k, urb_tree_prefix_string,
+                                             str_cmp);
+            ASSERT_EQ(0, strcmp((char*)n->key, keys[i].c_str()));
+            urb_tree_release(n);
+            if (i % 100 == 0) {
+                URB_TREE_CHECK_INVARIANTS(&urb);
+                /// The prefixes moved with the keys: the others are found.
+                for (int j = i+1; j < T; ++j) 
+                    ASSERT_NE(&urb_sentinel, 
+                              urb_tree_find_prefixed(&urb, 
+                                  (void*)keys[j].c_str(), 
+                                  urb_tree_prefix_string, str_cmp));
+            }
+        }
+        ASSERT_EQ(&urb_sentinel, urb);
+    }
+
+}  // namespace
@@ -0,0 +1,114 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file test/src/profile_test.cc
+/// @author Issam SAID
+/// @brief Unit testing file for the urb_tree shape profiler.
+/// 
+#include <gtest/gtest.h>
+#include <urb_tree/urb_tree.h>
+
+namespace {
+
+    int  int_cmp(void *a, void *b) { return *(int*)a-*(int*)b; }
+
+    void int_dst(void *a) { free(a); }
+
+    size_t int_size(void *) { return sizeof(int); }
+
+    void fill(urb_t **urb, int T) {
+        int i, *k, *v;
+        for (i=1; i<=T; ++i) {
+            k = (int*)malloc(sizeof(int));
+            v = (int*)malloc(sizeof(int));
+            *k = i;
+            *v = i;
+            ASSERT_EQ(urb_tree_put(urb, urb_tree_create(k, v), int_cmp), 
+                      URB_SUCCESS);
+        }
+    }
+
+    class ProfileTest : public ::testing::Test {
+    protected:
+        virtual void SetUp() { }
+        virtual void TearDown() { }
+    };
+
+    TEST_F(ProfileTest, empty) {
+        urb_t *urb = &urb_sentinel;
+        urb_profile_t p;
+        ASSERT_EQ(urb_tree_profile(&urb, NULL, NULL, &p), URB_SUCCESS);
+        ASSERT_EQ(0u, p.nodes);
+        ASSERT_EQ(0u, p.height);
+        ASSERT_EQ(0u, p.black_height);
+    }
+
+    TEST_F(ProfileTest, full) {
+        urb_t *urb = &urb_sentinel;
+        urb_profile_t p;
+        /// 2 is the root, 1 and 4 at depth 2, 3 and 5 at depth 3 and 6 at 
+        /// depth 4, 4 and 6 are red.
+        fill(&urb, 6);
+        ASSERT_EQ(urb_tree_profile(&urb, int_size, int_size, &p), 
+                  URB_SUCCESS);
+        ASSERT_FALSE(p.sampled);
+        ASSERT_EQ(6u, p.nodes);
+        ASSERT_EQ(2u, p.red);
+        ASSERT_EQ(4u, p.black);
+        ASSERT_EQ(4u, p.height);
+        ASSERT_EQ(2u, p.black_height);
+        ASSERT_DOUBLE_EQ(2.5, p.avg_depth);
+        ASSERT_EQ(1u, p.depths[1]);
+        ASSERT_EQ(2u, p.depths[2]);
+        ASSERT_EQ(2u, p.depths[3]);
+        ASSERT_EQ(1u, p.depths[4]);
+        ASSERT_EQ(6*sizeof(urb_t), p.node_bytes);
+        ASSERT_EQ(6*sizeof(int), p.key_bytes);
+        ASSERT_EQ(6*sizeof(int), p.value_bytes);
+        urb_tree_delete(&urb, int_dst, int_dst);
+    }
+
+    TEST_F(ProfileTest, large) {
+        urb_t *urb = &urb_sentinel;
+        urb_profile_t full, sampled;
+        fill(&urb, 20000);
+        ASSERT_EQ(urb_tree_profile(&urb, NULL, NULL, &full), URB_SUCCESS);
+        ASSERT_EQ(20000u, full.nodes);
+        ASSERT_EQ(urb_tree_size(&urb), full.nodes);
+        ASSERT_EQ(full.nodes, full.red + full.black);
+        ASSERT_EQ(urb_tree_profile_sampled(&urb, 20000, 7, NULL, NULL, 
+                                           &sampled), URB_SUCCESS);
+        ASSERT_TRUE(sampled.sampled);
+        ASSERT_NEAR(full.nodes, sampled.nodes, 0.1*full.nodes);
+        ASSERT_NEAR(full.avg_depth, sampled.avg_depth, 0.1*full.avg_depth);
+        ASSERT_LE(sampled.height, full.height);
+        ASSERT_EQ(full.black_height, sampled.black_height);
+        urb_tree_delete(&urb, int_dst, int_dst);
+    }
+
+}  // namespace
@@ -0,0 +1,145 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file test/src/relaxed_test.cc
+/// @author Issam SAID
+/// @brief Unit testing file for the urb_tree relaxed balancing.
+/// 
+#include <cmath>
+#include <gtest/gtest.h>
+#include <urb_tree/urb_tree.h>
+
+namespace {
+
+    int    urb_cmp(void *a, void *b) { return *(int*)a-*(int*)b; }
+
+    size_t urb_height(urb_t *n) {
+        if (n == &urb_sentinel) return 0;
+        return 1 + std::max(urb_height(n->left), urb_height(n->right));
+    }
+
+    /// The number of black nodes on every path, -1 if the paths differ or 
+    /// if a red node has a red child.
+    int urb_black_height(urb_t *n) {
+        if (n == &urb_sentinel) return 0;
+        int l = urb_black_height(n->left), r = urb_black_height(n->right);
+        if (l < 0 || l != r) return -1;
+        if (n->color == red && 
+            (n->left->color == red || n->right->color == red)) return -1;
+        return l + (n->color == black);
+    }
+
+    class RelaxedTest : public ::testing::Test {
+    protected:
+        virtual void SetUp() {
+            for (int i = 0; i < T; ++i) {
+                keys[i]   = (i*7919)%T;
+                sorted[i] = i;
+            }
+        }
+        void check(urb_t **urb, size_t n) {
+            ASSERT_EQ(n, urb_tree_size(urb));
+            ASSERT_EQ(black, (*urb)->color);
+            ASSERT_LT(0, urb_black_height(*urb));
+            ASSERT_LE((double)urb_height(*urb), 2*std::log2(n+1.));
+            URB_TREE_CHECK_INVARIANTS(urb);
+        }
+        static const int T = 5000;
+        int keys[T];
+        int sorted[T];
+    };
+
+    TEST_F(RelaxedTest, put) {
+        for (size_t budget = 0; budget < 4; ++budget) {
+            for (int s = 0; s < 2; ++s) {
+                int *k = s ? sorted : keys;
+                urb_t *urb = &urb_sentinel;
+                urb_relaxed_t relaxed;
+                ASSERT_EQ(URB_SUCCESS, 
+                          urb_relaxed_begin(&relaxed, &urb, budget));
+                for (int i = 0; i < T; ++i) 
+                    ASSERT_EQ(URB_SUCCESS, 
+                              urb_relaxed_put(&relaxed, 
+                                              urb_tree_create(&k[i], NULL),
+                                              urb_cmp));
+                /// The tree can be read before it is rebalanced.
+                for (int i = 0; i < T; ++i) 
+                    ASSERT_EQ(i, *(int*)urb_tree_find(&urb, &i, urb_cmp)->key);
+                if (budget == 0) { ASSERT_EQ(0u, relaxed.steps); }
+                ASSERT_EQ(URB_SUCCESS, urb_relaxed_end(&relaxed));
+                check(&urb, T);
+                int i = 0;
+                for (urb_t *n = urb_tree_min(&urb); 
+                     n != NULL && n != &urb_sentinel; n = urb_tree_succ(n))
+                    ASSERT_EQ(i++, *(int*)n->key);
+                urb_tree_delete(&urb, NULL, NULL);
+            }
+        }
+    }
+
+    TEST_F(RelaxedTest, step) {
+        urb_t *urb = &urb_sentinel;
+        urb_relaxed_t relaxed;
+        urb_relaxed_begin(&relaxed, &urb, 0);
+        for (int i = 0; i < T; ++i) 
+            urb_relaxed_put(&relaxed, urb_tree_create(&sorted[i], NULL), 
+                            urb_cmp);
+        ASSERT_EQ((size_t)T, urb_height(urb));
+        size_t slices = 0;
+        while (!urb_relaxed_step(&relaxed, 16)) slices++;
+        ASSERT_GT(slices, 0u);
+        ASSERT_EQ(0u, relaxed.n);
+        check(&urb, T);
+        urb_relaxed_end(&relaxed);
+        urb_tree_delete(&urb, NULL, NULL);
+    }
+
+    TEST_F(RelaxedTest, pop) {
+        urb_t *urb = &urb_sentinel;
+        urb_relaxed_t relaxed;
+        urb_relaxed_begin(&relaxed, &urb, 1);
+        for (int i = 0; i < T; ++i) 
+            urb_relaxed_put(&relaxed, urb_tree_create(&keys[i], NULL), 
+                            urb_cmp);
+        for (int i = 0; i < T; i += 2) {
+            urb_t *n = urb_relaxed_pop(&relaxed, &i, urb_cmp);
+            ASSERT_EQ(i, *(int*)n->key);
+            ASSERT_EQ(0u, relaxed.n);
+            urb_tree_release(n);
+            /// Put it back, it is pending again.
+            urb_relaxed_put(&relaxed, urb_tree_create(&sorted[i], NULL), 
+                            urb_cmp);
+        }
+        int k = T;
+        ASSERT_EQ(&urb_sentinel, urb_relaxed_pop(&relaxed, &k, urb_cmp));
+        urb_relaxed_end(&relaxed);
+        check(&urb, T);
+        urb_tree_delete(&urb, NULL, NULL);
+    }
+
+}  // namespace
@@ -0,0 +1,167 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file test/src/shm_test.cc
+/// @author Issam SAID
+/// @brief Unit testing file for the urb_tree shared trees.
+/// 
+#include <string>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <gtest/gtest.h>
+#include <urb_tree/urb_tree.h>
+
+namespace {
+
+    struct record_t { int64_t a, b; };
+
+    /// Run f in a child process, return its exit status.
+    template <typename F> int child(F f) {
+        pid_t pid = fork();
+        int status;
+        if (pid == 0) _exit(f());
+        waitpid(pid, &status, 0);
+        return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    }
+
+    class ShmTest : public ::testing::Test {
+    protected:
+        virtual void SetUp() {
+            char path[] = "/tmp/urb_shm_XXXXXX";
+            int fd = mkstemp(path);
+            close(fd);
+            unlink(path);
+            file = path;
+        }
+        virtual void TearDown() { urb_shm_unlink(file.c_str()); }
+        static const int T = 2000;
+        std::string file;
+    };
+
+    TEST_F(ShmTest, attach) {
+        urb_shm_t shm, other;
+        record_t r = { 0, 0 };
+        uint64_t v;
+        ASSERT_EQ(URB_SUCCESS, 
+                  urb_shm_create(&shm, file.c_str(), T, sizeof(record_t)));
+        /// An existing segment is not replaced.
+        ASSERT_NE(URB_SUCCESS, urb_shm_create(&other, file.c_str(), T, 0));
+        for (int64_t k = 0; k < T; k += 2) {
+            r.a = k; r.b = -k;
+            ASSERT_EQ(URB_SUCCESS, urb_shm_put(&shm, k, 2*k, &r));
+        }
+        ASSERT_NE(URB_SUCCESS, urb_shm_put(&shm, 0, 0, NULL));
+        /// Another mapping of the same segment sees the keys.
+        ASSERT_EQ(URB_SUCCESS, urb_shm_attach(&other, file.c_str()));
+        ASSERT_NE((void*)shm.header, (void*)other.header);
+        ASSERT_TRUE(urb_shm_find(&other, 10, &v, &r));
+        ASSERT_EQ(20u, v);
+        ASSERT_EQ(10,  r.a);
+        ASSERT_EQ(-10, r.b);
+        ASSERT_FALSE(urb_shm_find(&other, 11, &v, &r));
+        ASSERT_TRUE(urb_shm_pop(&other, 10, &v, &r));
+        ASSERT_EQ(-10, r.b);
+        ASSERT_FALSE(urb_shm_find(&shm, 10, NULL, NULL));
+        /// Fill the tree.
+        for (int64_t k = 1; k < T; k += 2) 
+            ASSERT_EQ(URB_SUCCESS, urb_shm_put(&shm, k, k, NULL));
+        ASSERT_EQ(URB_SUCCESS, urb_shm_put(&shm, T, T, NULL));
+        ASSERT_NE(URB_SUCCESS, urb_shm_put(&shm, T + 1, T, NULL));
+        urb_shm_lock(&other, false);
+        ASSERT_EQ((uint32_t)T, other.pool.n);
+        ASSERT_TRUE(urb_pool_check(&other.pool));
+        urb_shm_unlock(&other);
+        ASSERT_EQ(URB_SUCCESS, urb_shm_detach(&other));
+        ASSERT_EQ(URB_SUCCESS, urb_shm_detach(&shm));
+        ASSERT_NE(URB_SUCCESS, urb_shm_attach(&shm, "/tmp"));
+    }
+
+    TEST_F(ShmTest, processes) {
+        urb_shm_t shm;
+        int64_t k;
+        ASSERT_EQ(URB_SUCCESS, urb_shm_create(&shm, file.c_str(), 2*T, 0));
+        for (k = 0; k < T; ++k) urb_shm_put(&shm, k, k, NULL);
+        /// Each child attaches the segment, pops the keys of its parity and
+        /// puts new ones, under the shared lock.
+        for (int p = 0; p < 2; ++p) {
+            pid_t pid = fork();
+            if (pid == 0) {
+                urb_shm_t s;
+                if (urb_shm_attach(&s, file.c_str()) != URB_SUCCESS) _exit(1);
+                for (int64_t i = p; i < T; i += 2) {
+                    if (!urb_shm_pop(&s, i, NULL, NULL)) _exit(2);
+                    if (urb_shm_put(&s, T + i, i, NULL) != URB_SUCCESS) 
+                        _exit(3);
+                }
+                urb_shm_detach(&s);
+                _exit(0);
+            }
+        }
+        for (int p = 0; p < 2; ++p) {
+            int status;
+            wait(&status);
+            ASSERT_TRUE(WIFEXITED(status));
+            ASSERT_EQ(0, WEXITSTATUS(status));
+        }
+        urb_shm_lock(&shm, false);
+        ASSERT_EQ((uint32_t)T, shm.pool.n);
+        ASSERT_TRUE(urb_pool_check(&shm.pool));
+        k = T;
+        for (uint32_t i = urb_pool_min(&shm.pool); i; 
+             i = urb_pool_succ(&shm.pool, i), ++k) {
+            ASSERT_EQ(k, urb_pool_key(&shm.pool, i));
+            ASSERT_EQ((uint64_t)(k - T), urb_pool_value(&shm.pool, i));
+        }
+        urb_shm_unlock(&shm);
+        ASSERT_EQ(2*T, k);
+        urb_shm_detach(&shm);
+    }
+
+    TEST_F(ShmTest, object) {
+        urb_shm_t shm;
+        uint64_t v = 0;
+        std::string name = "/urb_shm_test_" + std::to_string(getpid());
+        ASSERT_EQ(URB_SUCCESS, urb_shm_create(&shm, name.c_str(), T, 0));
+        ASSERT_EQ(URB_SUCCESS, urb_shm_put(&shm, 42, 7, NULL));
+        ASSERT_EQ(7, child([&]() {
+            urb_shm_t s;
+            uint64_t x = 0;
+            if (urb_shm_attach(&s, name.c_str()) != URB_SUCCESS) return 1;
+            urb_shm_find(&s, 42, &x, NULL);
+            urb_shm_put(&s, 43, 8, NULL);
+            urb_shm_detach(&s);
+            return (int)x;
+        }));
+        ASSERT_TRUE(urb_shm_find(&shm, 43, &v, NULL));
+        ASSERT_EQ(8u, v);
+        urb_shm_detach(&shm);
+        ASSERT_EQ(URB_SUCCESS, urb_shm_unlink(name.c_str()));
+        ASSERT_NE(URB_SUCCESS, urb_shm_attach(&shm, name.c_str()));
+    }
+
+}  // namespace
@@ -0,0 +1,112 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file test/src/stats_test.cc
+/// @author Issam SAID
+/// @brief Unit testing file for the urb_tree structural counters.
+/// 
+#include <thread>
+#include <gtest/gtest.h>
+#include <urb_tree/urb_tree.h>
+
+namespace {
+
+    int  int_cmp(void *a, void *b) { return *(int*)a-*(int*)b; }
+
+    void int_dst(void *a) { free(a); }
+
+    void fill(urb_t **urb, int T) {
+        int i, *k, *v;
+        for (i=1; i<=T; ++i) {
+            k = (int*)malloc(sizeof(int));
+            v = (int*)malloc(sizeof(int));
+            *k = i;
+            *v = i;
+            ASSERT_EQ(urb_tree_put(urb, urb_tree_create(k, v), int_cmp), 
+                      URB_SUCCESS);
+        }
+    }
+
+    class StatsTest : public ::testing::Test {
+    protected:
+        virtual void SetUp() { urb_tree_stats_reset(); }
+        virtual void TearDown() { }
+    };
+
+    TEST_F(StatsTest, counters) {
+        urb_t *urb = &urb_sentinel;
+        urb_stats_t s;
+        int tmp;
+        fill(&urb, 6);
+        urb_tree_stats(&s);
+        if (!urb_tree_stats_enabled()) {
+            ASSERT_EQ(0ULL, s.puts);
+            ASSERT_EQ(0ULL, s.left_rotations);
+            urb_tree_delete(&urb, int_dst, int_dst);
+            return;
+        }
+        ASSERT_EQ(6ULL, s.puts);
+        ASSERT_EQ(0ULL, s.finds);
+        /// Ascending keys only lean to the right.
+        ASSERT_GT(s.left_rotations, 0ULL);
+        ASSERT_EQ(0ULL, s.right_rotations);
+        ASSERT_GT(s.put_recolors, 0ULL);
+        /// One comparison per visited node, the last one picks the side.
+        ASSERT_EQ(s.put_compares, s.put_depth);
+
+        urb_tree_stats_reset();
+        tmp = *(int*)urb->key;
+        ASSERT_EQ(urb, urb_tree_find(&urb, &tmp, int_cmp));
+        urb_tree_stats(&s);
+        ASSERT_EQ(1ULL, s.finds);
+        ASSERT_EQ(1ULL, s.find_compares);
+        ASSERT_EQ(1ULL, s.find_depth);
+
+        tmp = 6;
+        free(urb_tree_pop(&urb, &tmp, int_cmp));
+        urb_tree_stats(&s);
+        ASSERT_EQ(1ULL, s.pops);
+        ASSERT_EQ(1ULL, s.finds);
+        ASSERT_EQ(s.pop_compares, s.pop_depth);
+        ASSERT_GE(s.max_depth, s.pop_depth);
+        urb_tree_delete(&urb, int_dst, int_dst);
+    }
+
+    TEST_F(StatsTest, threads) {
+        std::thread worker([]() {
+            urb_t *urb = &urb_sentinel;
+            fill(&urb, 100);
+            urb_tree_delete(&urb, int_dst, int_dst);
+        });
+        worker.join();
+        urb_stats_t s;
+        urb_tree_stats(&s);
+        ASSERT_EQ(urb_tree_stats_enabled() ? 100ULL : 0ULL, s.puts);
+    }
+
+}  // namespace
@@ -0,0 +1,143 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file test/src/vlog_test.cc
+/// @author Issam SAID
+/// @brief Unit testing file for the urb_tree value logs.
+/// 
+#include <string>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include <urb_tree/urb_tree.h>
+
+namespace {
+
+    int    urb_cmp(void *a, void *b) { return *(int*)a-*(int*)b; }
+
+    /// The value of a key, from 1 byte to a few chunks.
+    std::string urb_value(int k) {
+        size_t length = (k % 7 == 0) ? 3*URB_VLOG_CHUNK/2 + k : 1 + k % 300;
+        return std::string(length, (char)('a' + k % 26));
+    }
+
+    class VlogTest : public ::testing::Test {
+    protected:
+        virtual void SetUp() {
+            int fd = mkstemp(path);
+            ASSERT_GE(fd, 0);
+            close(fd);
+            root = &urb_sentinel;
+            ASSERT_EQ(URB_SUCCESS, 
+                      urb_vlog_open(&vlog, path, 1UL << 32, 
+                                    4*URB_VLOG_CHUNK));
+            for (int i = 0; i < T; ++i) {
+                keys[i] = i;
+                std::string v = urb_value(i);
+                ASSERT_EQ(URB_SUCCESS, 
+                          urb_vlog_put(&vlog, &root, &keys[i], 
+                                       v.data(), v.size(), urb_cmp));
+            }
+        }
+        virtual void TearDown() { 
+            urb_tree_delete(&root, NULL, NULL);
+            urb_vlog_close(&vlog);
+            unlink(path);
+        }
+        void check(int k) {
+            size_t length;
+            urb_t *n = urb_tree_find(&root, &k, urb_cmp);
+            ASSERT_NE(&urb_sentinel, n);
+            const char *v = (const char *)urb_vlog_value(&vlog, n, &length);
+            ASSERT_EQ(urb_value(k), std::string(v, length));
+        }
+        static const int T = 2000;
+        int keys[T];
+        char path[32] = "/tmp/urb_vlog_XXXXXX";
+        urb_t *root;
+        urb_vlog_t vlog;
+    };
+
+    TEST_F(VlogTest, handle) {
+        uint64_t h = URB_VLOG_HANDLE(123456789ULL, 4242);
+        ASSERT_EQ(123456789ULL, URB_VLOG_OFFSET(h));
+        ASSERT_EQ(4242ULL, URB_VLOG_LENGTH(h));
+    }
+
+    TEST_F(VlogTest, read) {
+        for (int i = 0; i < T; ++i) check(i);
+        for (int i = T-1; i >= 0; i -= 3) check(i);
+        /// Only the budget is resident, the other chunks were dropped.
+        ASSERT_LE(vlog.resident, vlog.budget);
+        ASSERT_GT(vlog.evictions, 0u);
+        ASSERT_GT(vlog.size, vlog.budget*URB_VLOG_CHUNK);
+    }
+
+    TEST(VlogBudgetTest, large) {
+        char path[] = "/tmp/urb_vlog_XXXXXX";
+        urb_vlog_t vlog;
+        std::string big(5*URB_VLOG_CHUNK/2, 'x'), small(10, 'y');
+        int fd = mkstemp(path);
+        ASSERT_GE(fd, 0);
+        close(fd);
+        ASSERT_EQ(URB_SUCCESS, 
+                  urb_vlog_open(&vlog, path, 1UL << 24, URB_VLOG_CHUNK));
+        uint64_t s = urb_vlog_append(&vlog, small.data(), small.size());
+        /// The 3 chunks of a value larger than the budget are kept and 
+        /// counted, down to the budget on the next access.
+        uint64_t b = urb_vlog_append(&vlog, big.data(), big.size());
+        ASSERT_EQ(3u, vlog.resident);
+        ASSERT_EQ(0, memcmp(urb_vlog_read(&vlog, b), big.data(), big.size()));
+        ASSERT_EQ(3u, vlog.resident);
+        ASSERT_EQ(0, memcmp(urb_vlog_read(&vlog, s), small.data(), 
+                            small.size()));
+        ASSERT_EQ(1u, vlog.resident);
+        urb_vlog_close(&vlog);
+        unlink(path);
+    }
+
+    TEST_F(VlogTest, compact) {
+        size_t size = vlog.size;
+        for (int i = 0; i < T; i += 2) {
+            urb_t *n = urb_vlog_pop(&vlog, &root, &keys[i], urb_cmp);
+            ASSERT_EQ(i, *(int*)n->key);
+            urb_tree_release(n);
+        }
+        ASSERT_GT(vlog.garbage, 0u);
+        ASSERT_EQ(URB_SUCCESS, urb_vlog_compact(&vlog, &root));
+        ASSERT_EQ(0u, vlog.garbage);
+        ASSERT_LT(vlog.size, size);
+        for (int i = 1; i < T; i += 2) check(i);
+        /// The log can grow again.
+        int k = T;
+        std::string v = urb_value(k);
+        urb_vlog_put(&vlog, &root, &k, v.data(), v.size(), urb_cmp);
+        check(k);
+        for (int i = 1; i < T; i += 2) check(i);
+    }
+
+}  // namespace
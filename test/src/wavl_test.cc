@@ -0,0 +1,144 @@
+///
+/// @copyright Copyright (c)2016-, Issam SAID <said.issam@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions
+/// are met:
+///
+/// 1. Redistributions of source code must retain the above copyright
+///    notice, this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright
+///    notice, this list of conditions and the following disclaimer in the
+///    documentation and/or other materials provided with the distribution.
+/// 3. Neither the name of the copyright holder nor the names of its contributors
+///    may be used to endorse or promote products derived from this software
+///    without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+/// INCLUDING, BUT NOT LIMITED TO, WARRANTIES OF MERCHANTABILITY AND FITNESS
+/// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+/// HOLDER OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+/// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+/// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+/// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+/// LIABILITY, WETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+/// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+/// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/// @file test/src/wavl_test.cc
+/// @author Issam SAID
+/// @brief Unit testing file for the urb_tree WAVL balancing routines.
+/// 
+#include <cmath>
+#include <set>
+#include <gtest/gtest.h>
+#include <urb_tree/urb_tree.h>
+
+namespace {
+
+    int    urb_cmp(void *a, void *b) { return *(int*)a-*(int*)b; }
+
+    size_t urb_height(urb_t *n) {
+        if (n == &urb_sentinel) return 0;
+        return 1 + std::max(urb_height(n->left), urb_height(n->right));
+    }
+
+    class WavlTest : public ::testing::Test {
+    protected:
+        virtual void SetUp() {
+            root = &urb_sentinel;
+            for (int i = 0; i < T; ++i) {
+                keys[i] = (i*7919)%T;
+                ASSERT_EQ(URB_SUCCESS, 
+                          urb_wavl_put(&root, urb_tree_create(&keys[i], NULL),
+                                       urb_cmp));
+            }
+        }
+        virtual void TearDown() { urb_tree_delete(&root, NULL, NULL); }
+        static const int T = 5000;
+        int keys[T];
+        urb_t *root;
+    };
+
+    TEST_F(WavlTest, put) {
+        ASSERT_TRUE(urb_wavl_check(&root));
+        ASSERT_EQ((size_t)T, urb_tree_size(&root));
+        /// Without deletions the tree is an AVL tree.
+        ASSERT_LE((double)urb_height(root), 1.4405*std::log2(T+2.));
+        for (int i = 0; i < T; ++i) 
+            ASSERT_EQ(i, *(int*)urb_tree_find(&root, &i, urb_cmp)->key);
+        int i = 0;
+        for (urb_t *n = urb_tree_min(&root); 
+             n != NULL && n != &urb_sentinel; n = urb_tree_succ(n)) 
+            ASSERT_EQ(i++, *(int*)n->key);
+        ASSERT_EQ((int)T, i);
+        for (urb_t *n = urb_tree_max(&root); 
+             n != NULL && n != &urb_sentinel; n = urb_tree_prev(n)) 
+            ASSERT_EQ(--i, *(int*)n->key);
+    }
+
+    TEST_F(WavlTest, put_sorted) {
+        int sorted_keys[T];
+        urb_t *sorted = &urb_sentinel;
+        for (int i = 0; i < T; ++i) {
+            sorted_keys[i] = i;
+            urb_wavl_put(&sorted, 
+                         urb_tree_create(&sorted_keys[i], NULL), urb_cmp);
+        }
+        ASSERT_TRUE(urb_wavl_check(&sorted));
+        ASSERT_LE((double)urb_height(sorted), 1.4405*std::log2(T+2.));
+        urb_tree_delete(&sorted, NULL, NULL);
+    }
+
+    TEST_F(WavlTest, pop) {
+        std::set<int> ref(keys, keys+T);
+        unsigned int seed = 42;
+        int ids[T];
+        for (int i = 0; i < T; ++i) ids[i] = i;
+        for (int round = 0; round < 4*T; ++round) {
+            int k = rand_r(&seed) % T;
+            if (ref.count(k)) {
+                urb_t *n = urb_wavl_pop(&root, &k, urb_cmp);
+                ASSERT_EQ(k, *(int*)n->key);
+                urb_tree_release(n);
+                ref.erase(k);
+            } else {
+                ASSERT_EQ(&urb_sentinel, urb_wavl_pop(&root, &k, urb_cmp));
+                ASSERT_EQ(URB_SUCCESS, 
+                          urb_wavl_put(&root, urb_tree_create(&ids[k], NULL),
+                                       urb_cmp));
+                ref.insert(k);
+            }
+            if (round % 97 == 0) { ASSERT_TRUE(urb_wavl_check(&root)); }
+        }
+        ASSERT_TRUE(urb_wavl_check(&root));
+        ASSERT_EQ(ref.size(), urb_tree_size(&root));
+        /// The height stays below 2 log n with deletions.
+        ASSERT_LE((double)urb_height(root), 2*std::log2(ref.size()+1.));
+        for (int i = 0; i < T; ++i) 
+            ASSERT_EQ(ref.count(i) == 0, 
+                      urb_tree_find(&root, &i, urb_cmp) == &urb_sentinel);
+        /// Empty the tree.
+        for (std::set<int>::iterator it = ref.begin(); it != ref.end(); ++it) {
+            int k = *it;
+            urb_tree_release(urb_wavl_pop(&root, &k, urb_cmp));
+            ASSERT_TRUE(urb_wavl_check(&root));
+        }
+        ASSERT_EQ(&urb_sentinel, root);
+    }
+
+    TEST_F(WavlTest, erase_node) {
+        for (int i = 0; i < T; i += 3) {
+            urb_t *n = urb_tree_find(&root, &i, urb_cmp);
+            ASSERT_EQ(n, urb_wavl_erase_node(&root, n));
+            urb_tree_release(n);
+        }
+        ASSERT_TRUE(urb_wavl_check(&root));
+        ASSERT_EQ((size_t)(T - (T+2)/3), urb_tree_size(&root));
+        for (int i = 0; i < T; ++i) 
+            ASSERT_EQ(i % 3 == 0, 
+                      urb_tree_find(&root, &i, urb_cmp) == &urb_sentinel);
+    }
+
+}  // namespace